@@ -0,0 +1,156 @@
+/*
+ * animation_clock.c
+ *
+ * Locks the LED animations to an incoming MIDI clock. The clock's pulses set
+ * the animation phase, which is interpolated between pulses from the measured
+ * clock period, so strobes and pulses stay on the beat at any tempo.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <animation_clock.h>
+
+// The phase is kept as 8.24 fixed point steps, the top 16 bits are handed out
+#define PHASE_STEP			0x01000000UL
+#define PHASE_PER_PULSE		(PHASE_STEP / ANIMATION_CLOCK_PULSES_PER_STEP)
+#define STEPS_PER_BEAT		(ANIMATION_CLOCK_PULSES_PER_BEAT / ANIMATION_CLOCK_PULSES_PER_STEP)
+
+// The period average has 4 fractional bits and takes 1/8 of each new interval
+#define PERIOD_FRACTION_BITS	4
+#define PERIOD_AVERAGE_SHIFT	3
+
+// Each pulse corrects 1/4 of the phase error, the rest of the clock's jitter
+// is filtered out. Errors over half a step are taken as a jump in the song
+// position and corrected at once.
+#define PHASE_GAIN				4
+#define PHASE_RESYNC_ERROR		(PHASE_STEP / 2)
+
+// An interval this many times the average means the clock stopped for a while
+#define PERIOD_GAP_FACTOR		4
+
+static uint32_t clock_phase;		// Phase at clock_time
+static uint32_t pulse_phase;		// Phase the last pulse was due at
+static uint32_t clock_rate;			// Phase per timer count
+static uint32_t output_phase;		// Last phase handed out
+static uint32_t clock_period;		// Average pulse interval in timer counts << PERIOD_FRACTION_BITS
+static uint16_t clock_time;			// Time stamp of the last pulse
+static uint8_t clock_pulses;		// Pulses seen since the reset, up to 2
+static uint8_t clock_beat_pulse;	// Position in the beat of the last pulse
+static uint8_t clock_beat_step;		// Step the current beat started on
+
+/**
+ * Starts again from step 0, used when a MIDI clock first appears and when the
+ * song is started.
+ */
+void animation_clock_reset(void)
+{
+	clock_phase = 0;
+	pulse_phase = 0;
+	clock_rate = 0;
+	output_phase = 0;
+	clock_period = 0;
+	clock_pulses = 0;
+	clock_beat_pulse = 0;
+	clock_beat_step = 0;
+}
+
+// Limits the time since the last pulse to two average periods, past that the
+// clock has most likely stopped
+static uint16_t clock_elapsed(uint16_t now)
+{
+	uint16_t elapsed = now - clock_time;
+	uint32_t limit = clock_period >> (PERIOD_FRACTION_BITS - 1);
+	return (elapsed < limit) ? elapsed : (uint16_t)limit;
+}
+
+/**
+ * Locks the phase to a MIDI clock pulse. Call for every clock message.
+ *
+ * \param now [in]			Time stamp of the pulse, counts of ANIMATION_CLOCK_TIMER_HZ
+ *
+ * \param beat_pulse [in]	Position of the pulse in the beat, 0 - 23
+ */
+void animation_clock_pulse(uint16_t now, uint8_t beat_pulse)
+{
+	// A pulse at or before the previous one's position starts a new beat (or
+	// the song was restarted), 8 steps on from the last
+	if (clock_pulses && beat_pulse <= clock_beat_pulse) {
+		clock_beat_step += STEPS_PER_BEAT;
+	}
+	clock_beat_pulse = beat_pulse;
+
+	uint8_t step = clock_beat_step + beat_pulse / ANIMATION_CLOCK_PULSES_PER_STEP;
+	pulse_phase = ((uint32_t)step << 24) + (beat_pulse % ANIMATION_CLOCK_PULSES_PER_STEP) * PHASE_PER_PULSE;
+
+	uint16_t interval = now - clock_time;
+	bool resync = true;
+
+	if (clock_pulses == 0) {
+		clock_pulses = 1;
+	} else if (clock_pulses == 1) {
+		clock_period = (uint32_t)interval << PERIOD_FRACTION_BITS;
+		clock_pulses = 2;
+	} else if (interval < (clock_period >> PERIOD_FRACTION_BITS) * PERIOD_GAP_FACTOR) {
+		int32_t difference = ((int32_t)interval << PERIOD_FRACTION_BITS) - (int32_t)clock_period;
+		clock_period += difference / (1 << PERIOD_AVERAGE_SHIFT);
+
+		uint32_t estimate = clock_phase + clock_rate * clock_elapsed(now);
+		int32_t error = (int32_t)(pulse_phase - estimate);
+		if (error > -(int32_t)PHASE_RESYNC_ERROR && error < (int32_t)PHASE_RESYNC_ERROR) {
+			clock_phase = estimate + error / PHASE_GAIN;
+			resync = false;
+		}
+	}
+
+	if (resync) {
+		// Jump straight to the pulse, backwards too
+		clock_phase = pulse_phase;
+		output_phase = pulse_phase;
+	}
+
+	if (clock_period) {
+		clock_rate = (PHASE_PER_PULSE << PERIOD_FRACTION_BITS) / clock_period;
+	}
+	clock_time = now;
+}
+
+/**
+ * Returns the animation phase at a point in time, interpolated from the last
+ * pulse with the average clock period. It never runs more than two pulses ahead
+ * of the clock and never goes backwards between pulses.
+ *
+ * \param now [in]	Current time, counts of ANIMATION_CLOCK_TIMER_HZ
+ *
+ * \return Phase in 8.8 fixed point animation steps
+ */
+uint16_t animation_clock_phase(uint16_t now)
+{
+	uint32_t phase = clock_phase;
+
+	if (clock_pulses >= 2) {
+		phase += clock_rate * clock_elapsed(now);
+
+		uint32_t limit = pulse_phase + 2 * PHASE_PER_PULSE;
+		if ((int32_t)(phase - limit) > 0) {
+			phase = limit;
+		}
+	}
+
+	if ((int32_t)(phase - output_phase) > 0) {
+		output_phase = phase;
+	}
+	return (uint16_t)(output_phase >> 16);
+}
@@ -0,0 +1,46 @@
+/*
+ * animation_clock.h
+ *
+ * Locks the LED animations to an incoming MIDI clock. The clock's pulses set
+ * the animation phase, which is interpolated between pulses from the measured
+ * clock period, so strobes and pulses stay on the beat at any tempo.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef ANIMATION_CLOCK_H_
+#define ANIMATION_CLOCK_H_
+
+/*	Includes: */
+	#include <stdint.h>
+	#include <stdbool.h>
+
+/*	Macros: */
+	// Timer counts per second of the time stamps, TCC1 runs at F_CPU / 1024
+	#define ANIMATION_CLOCK_TIMER_HZ	31250
+	
+	// An animation step is 3 MIDI clock pulses (a 32nd note), so 8 steps per
+	// beat. The phase is 8.8 fixed point steps.
+	#define ANIMATION_CLOCK_PULSES_PER_STEP	3
+	#define ANIMATION_CLOCK_PULSES_PER_BEAT	24
+
+/* Function Prototypes: */
+	void animation_clock_reset(void);
+	void animation_clock_pulse(uint16_t now, uint8_t beat_pulse);
+	uint16_t animation_clock_phase(uint16_t now);
+
+#endif /* ANIMATION_CLOCK_H_ */
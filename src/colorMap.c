@@ -23,6 +23,7 @@
 #include "colorMap.h"
 #include "constants.h"
 #include "eeprom.h"
+#include "config.h"
 
 
 // Color maps are stored in Blue Green Red format
@@ -428,7 +429,12 @@ const uint8_t colorMap64[128][3] PROGMEM = { // 2026 colormap to match MF64 pale
 const uint8_t (*activeColorMap)[3] = colorMap7;
 
 void colorMap_init(void) {
-	if (eeprom_read(EE_COLOR_MAP) == 1) {
+	colorMap_select(eeprom_read(EE_COLOR_MAP));
+}
+
+// Selects the color map from the EE_COLOR_MAP setting, 1 is the 2026 map
+void colorMap_select(uint8_t color_map) {
+	if (color_map == 1) {
 		activeColorMap = colorMap64;
 		} else {
 		activeColorMap = colorMap7;
@@ -27,10 +27,11 @@
 #ifndef COLORMAP_H_
 #define COLORMAP_H_
 
-	#include <ASF.H>
+	#include <asf.h>
 	
 	extern const uint8_t (*activeColorMap)[3];
 	void colorMap_init(void);
+	void colorMap_select(uint8_t color_map);
 
 	//const uint8_t colorMap8[256][3];
 	const uint8_t colorMap7[128][3];
@@ -0,0 +1,185 @@
+/*
+ * color_tables.c
+ *
+ * Generated by tools/color_tables/gen_color_tables.c, do not edit.
+ *
+ * Gamma curves, 8-bit channel to bit-plane level conversions (with and
+ * without white balance) and brightness step to bit-plane level.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <avr/pgmspace.h>
+#include <color_tables.h>
+
+const uint8_t gamma_tables[GAMMA_TABLES][256] PROGMEM = {
+	{ // Gamma 2.2
+		  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+		  1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+		  3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+		  6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+		 12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+		 20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+		 30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+		 42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+		 56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+		 73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+		 91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+		113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+		137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+		163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+		192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+		223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+	},
+	{ // Gamma 2.8
+		  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+		  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,
+		  1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+		  2,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   5,   5,   5,
+		  5,   6,   6,   6,   6,   7,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,
+		 10,  10,  11,  11,  11,  12,  12,  13,  13,  13,  14,  14,  15,  15,  16,  16,
+		 17,  17,  18,  18,  19,  19,  20,  20,  21,  21,  22,  22,  23,  24,  24,  25,
+		 25,  26,  27,  27,  28,  29,  29,  30,  31,  32,  32,  33,  34,  35,  35,  36,
+		 37,  38,  39,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,  50,
+		 51,  52,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,  64,  66,  67,  68,
+		 69,  70,  72,  73,  74,  75,  77,  78,  79,  81,  82,  83,  85,  86,  87,  89,
+		 90,  92,  93,  95,  96,  98,  99, 101, 102, 104, 105, 107, 109, 110, 112, 114,
+		115, 117, 119, 120, 122, 124, 126, 127, 129, 131, 133, 135, 137, 138, 140, 142,
+		144, 146, 148, 150, 152, 154, 156, 158, 160, 162, 164, 167, 169, 171, 173, 175,
+		177, 180, 182, 184, 186, 189, 191, 193, 196, 198, 200, 203, 205, 208, 210, 213,
+		215, 218, 220, 223, 225, 228, 231, 233, 236, 239, 241, 244, 247, 249, 252, 255,
+	},
+	{ // Legacy red, x^5.0
+		  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+		  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+		  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+		  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+		  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+		  0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+		  1,   2,   2,   2,   2,   2,   2,   2,   2,   3,   3,   3,   3,   3,   3,   3,
+		  4,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,   6,   7,   7,   7,
+		  8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,  12,  13,  13,  14,
+		 14,  15,  15,  16,  16,  17,  17,  18,  19,  19,  20,  21,  21,  22,  23,  24,
+		 24,  25,  26,  27,  28,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,
+		 39,  41,  42,  43,  44,  45,  47,  48,  49,  51,  52,  54,  55,  57,  58,  60,
+		 61,  63,  64,  66,  68,  70,  71,  73,  75,  77,  79,  81,  83,  85,  87,  89,
+		 92,  94,  96,  98, 101, 103, 106, 108, 111, 113, 116, 119, 121, 124, 127, 130,
+		133, 136, 139, 142, 145, 148, 152, 155, 158, 162, 165, 169, 173, 176, 180, 184,
+		188, 192, 196, 200, 204, 208, 213, 217, 221, 226, 230, 235, 240, 245, 250, 255,
+	},
+	{ // Legacy green, x^2.5
+		  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+		  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,
+		  1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,   3,   3,   3,   3,
+		  3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,   6,   7,   7,   7,
+		  8,   8,   8,   9,   9,   9,  10,  10,  10,  11,  11,  11,  12,  12,  13,  13,
+		 14,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,  20,  21,  21,
+		 22,  22,  23,  23,  24,  25,  25,  26,  27,  27,  28,  29,  29,  30,  31,  31,
+		 32,  33,  34,  34,  35,  36,  37,  37,  38,  39,  40,  41,  42,  42,  43,  44,
+		 45,  46,  47,  48,  49,  50,  51,  52,  52,  53,  54,  55,  56,  57,  59,  60,
+		 61,  62,  63,  64,  65,  66,  67,  68,  69,  71,  72,  73,  74,  75,  77,  78,
+		 79,  80,  82,  83,  84,  85,  87,  88,  89,  91,  92,  93,  95,  96,  98,  99,
+		100, 102, 103, 105, 106, 108, 109, 111, 112, 114, 115, 117, 119, 120, 122, 123,
+		125, 127, 128, 130, 132, 133, 135, 137, 138, 140, 142, 144, 145, 147, 149, 151,
+		153, 155, 156, 158, 160, 162, 164, 166, 168, 170, 172, 174, 176, 178, 180, 182,
+		184, 186, 188, 190, 192, 194, 197, 199, 201, 203, 205, 207, 210, 212, 214, 216,
+		219, 221, 223, 226, 228, 230, 233, 235, 237, 240, 242, 245, 247, 250, 252, 255,
+	},
+};
+
+const uint8_t color_level_tables[COLOR_LEVEL_TABLES][256] PROGMEM = {
+	{ // Plain
+		  0,   2,   2,   3,   3,   5,   5,   6,   6,   8,   8,  10,  10,  11,  11,  13,
+		 13,  14,  14,  16,  16,  17,  17,  19,  19,  21,  21,  22,  22,  24,  24,  25,
+		 25,  27,  27,  29,  29,  30,  30,  32,  32,  33,  33,  35,  35,  37,  37,  38,
+		 38,  40,  40,  41,  41,  43,  43,  44,  44,  46,  46,  48,  48,  49,  49,  51,
+		 51,  52,  52,  54,  54,  56,  56,  57,  57,  59,  59,  60,  60,  62,  62,  64,
+		 64,  65,  65,  67,  67,  68,  68,  70,  70,  71,  71,  73,  73,  75,  75,  76,
+		 76,  78,  78,  79,  79,  81,  81,  83,  83,  84,  84,  86,  86,  87,  87,  89,
+		 89,  90,  90,  92,  92,  94,  94,  95,  95,  97,  97,  98,  98, 100, 100, 102,
+		102, 103, 103, 105, 105, 106, 106, 108, 108, 110, 110, 111, 111, 113, 113, 114,
+		114, 116, 116, 117, 117, 119, 119, 121, 121, 122, 122, 124, 124, 125, 125, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	},
+	{ // Red, white balanced
+		  0,   0,   2,   2,   2,   2,   3,   3,   3,   3,   5,   5,   5,   6,   6,   6,
+		  6,   8,   8,   8,   8,  10,  10,  10,  11,  11,  11,  11,  13,  13,  13,  14,
+		 14,  14,  14,  16,  16,  16,  16,  17,  17,  17,  19,  19,  19,  19,  21,  21,
+		 21,  21,  22,  22,  22,  24,  24,  24,  24,  25,  25,  25,  25,  27,  27,  27,
+		 29,  29,  29,  29,  30,  30,  30,  30,  32,  32,  32,  33,  33,  33,  33,  35,
+		 35,  35,  37,  37,  37,  37,  38,  38,  38,  38,  40,  40,  40,  41,  41,  41,
+		 41,  43,  43,  43,  43,  44,  44,  44,  46,  46,  46,  46,  48,  48,  48,  48,
+		 49,  49,  49,  51,  51,  51,  51,  52,  52,  52,  52,  54,  54,  54,  56,  56,
+		 56,  56,  57,  57,  57,  59,  59,  59,  59,  60,  60,  60,  60,  62,  62,  62,
+		 64,  64,  64,  64,  65,  65,  65,  65,  67,  67,  67,  68,  68,  68,  68,  70,
+		 70,  70,  70,  71,  71,  71,  73,  73,  73,  73,  75,  75,  75,  75,  76,  76,
+		 76,  78,  78,  78,  78,  79,  79,  79,  81,  81,  81,  81,  83,  83,  83,  83,
+		 84,  84,  84,  86,  86,  86,  86,  87,  87,  87,  87,  89,  89,  89,  90,  90,
+		 90,  90,  92,  92,  92,  92,  94,  94,  94,  95,  95,  95,  95,  97,  97,  97,
+		 97,  98,  98,  98, 100, 100, 100, 100, 102, 102, 102, 103, 103, 103, 103, 105,
+		105, 105, 105, 106, 106, 106, 108, 108, 108, 108, 110, 110, 110, 110, 111, 111,
+	},
+	{ // Green, white balanced
+		  0,   0,   2,   2,   3,   3,   5,   5,   6,   6,   8,   8,  10,  10,  11,  11,
+		 13,  13,  14,  14,  16,  16,  17,  17,  19,  19,  19,  21,  21,  22,  22,  24,
+		 24,  25,  25,  27,  27,  29,  29,  30,  30,  32,  32,  33,  33,  35,  35,  37,
+		 37,  38,  38,  40,  40,  40,  41,  41,  43,  43,  44,  44,  46,  46,  48,  48,
+		 49,  49,  51,  51,  52,  52,  54,  54,  56,  56,  57,  57,  59,  59,  59,  60,
+		 60,  62,  62,  64,  64,  65,  65,  67,  67,  68,  68,  70,  70,  71,  71,  73,
+		 73,  75,  75,  76,  76,  78,  78,  78,  79,  79,  81,  81,  83,  83,  84,  84,
+		 86,  86,  87,  87,  89,  89,  90,  90,  92,  92,  94,  94,  95,  95,  97,  97,
+		 97,  98,  98, 100, 100, 102, 102, 103, 103, 105, 105, 106, 106, 108, 108, 110,
+		110, 111, 111, 113, 113, 114, 114, 116, 116, 117, 117, 117, 119, 119, 121, 121,
+		122, 122, 124, 124, 125, 125, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	},
+	{ // Blue, white balanced
+		  0,   0,   2,   2,   3,   3,   5,   5,   6,   6,   8,   8,  10,  10,  10,  11,
+		 11,  13,  13,  14,  14,  16,  16,  17,  17,  19,  19,  19,  21,  21,  22,  22,
+		 24,  24,  25,  25,  27,  27,  29,  29,  29,  30,  30,  32,  32,  33,  33,  35,
+		 35,  37,  37,  38,  38,  38,  40,  40,  41,  41,  43,  43,  44,  44,  46,  46,
+		 46,  48,  48,  49,  49,  51,  51,  52,  52,  54,  54,  56,  56,  56,  57,  57,
+		 59,  59,  60,  60,  62,  62,  64,  64,  65,  65,  65,  67,  67,  68,  68,  70,
+		 70,  71,  71,  73,  73,  75,  75,  75,  76,  76,  78,  78,  79,  79,  81,  81,
+		 83,  83,  84,  84,  84,  86,  86,  87,  87,  89,  89,  90,  90,  92,  92,  94,
+		 94,  94,  95,  95,  97,  97,  98,  98, 100, 100, 102, 102, 103, 103, 103, 105,
+		105, 106, 106, 108, 108, 110, 110, 111, 111, 113, 113, 113, 114, 114, 116, 116,
+		117, 117, 119, 119, 121, 121, 121, 122, 122, 124, 124, 125, 125, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+	},
+};
+
+const uint8_t step_level_table[COLOR_TABLE_PWM_STEPS + 1] PROGMEM = {
+	  0,   2,   3,   5,   6,   8,  10,  11,  13,  14,  16,  17,  19,  21,  22,  24,
+	 25,  27,  29,  30,  32,  33,  35,  37,  38,  40,  41,  43,  44,  46,  48,  49,
+	 51,  52,  54,  56,  57,  59,  60,  62,  64,  65,  67,  68,  70,  71,  73,  75,
+	 76,  78,  79,  81,  83,  84,  86,  87,  89,  90,  92,  94,  95,  97,  98, 100,
+	102, 103, 105, 106, 108, 110, 111, 113, 114, 116, 117, 119, 121, 122, 124, 125,
+	127,
+};
@@ -0,0 +1,61 @@
+/*
+ * color_tables.h
+ *
+ * Gamma and PWM level look up tables for the RGB and indicator LEDs. The
+ * tables are generated by tools/color_tables/gen_color_tables.c
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+
+#ifndef COLOR_TABLES_H_
+#define COLOR_TABLES_H_
+
+/*	Includes: */
+	#include <stdint.h>
+
+/*	Macros: */
+	// Gamma curve setting, linear leaves the palette colors as they are
+	#define GAMMA_CURVE_LINEAR		0
+	#define GAMMA_CURVE_2_2			1
+	#define GAMMA_CURVE_2_8			2
+	#define GAMMA_CURVES			3
+	
+	// Gamma tables, the selectable curves (less linear) come first followed by
+	// the fixed per channel curves the animations were tuned with
+	#define GAMMA_TABLE_LEGACY_RED		(GAMMA_CURVES - 1)	// x^5.0
+	#define GAMMA_TABLE_LEGACY_GREEN	(GAMMA_CURVES)		// x^2.5
+	#define GAMMA_TABLES				(GAMMA_CURVES + 1)
+	
+	// Color level tables convert an 8-bit channel into a bit-plane level, with
+	// or without the white balance gain for each channel
+	#define COLOR_LEVEL_PLAIN		0
+	#define COLOR_LEVEL_RED			1
+	#define COLOR_LEVEL_GREEN		2
+	#define COLOR_LEVEL_BLUE		3
+	#define COLOR_LEVEL_TABLES		4
+	
+	// Display constants the tables were generated for, these must match 
+	// DISPLAY_PWM_STEPS and DISPLAY_BCM_LEVEL_MAX
+	#define COLOR_TABLE_PWM_STEPS	80
+	#define COLOR_TABLE_LEVEL_MAX	127
+
+/* Variables */
+	extern const uint8_t gamma_tables[GAMMA_TABLES][256];
+	extern const uint8_t color_level_tables[COLOR_LEVEL_TABLES][256];
+	extern const uint8_t step_level_table[COLOR_TABLE_PWM_STEPS + 1];
+
+#endif /* COLOR_TABLES_H_ */
@@ -22,10 +22,16 @@
 #include "config.h"
 #include "native_mode.h"
 #include "display_driver.h"
+#include "journal.h"
+#include "preset.h"
 
 uint8_t global_super_knob_start;
 uint8_t global_super_knob_end;
 uint8_t global_bank_animations_enabled;
+uint16_t boot_config_check_time;
+
+// The global settings page in use, as last loaded from the EEPROM or a preset
+static uint8_t active_config[EEPROM_PAGE_SIZE];
 
 
 
@@ -54,6 +60,16 @@ void global_tv_table_decode(global_tvtable_t* table, uint8_t* buffer, uint8_t si
     }
 }
 
+// Changes a global setting in a copy of the settings page in use, and saves it
+// unless a recalled preset is in use
+static void write_setting(uint8_t *settings, uint8_t address, uint8_t data)
+{
+	settings[address] = data;
+	if (!preset_in_use()) {
+		eeprom_write(address, data);
+	}
+}
+
 static void sysExCmdPushConfig (uint8_t length, uint8_t* buffer)
 {
 	
@@ -63,34 +79,45 @@ static void sysExCmdPushConfig (uint8_t length, uint8_t* buffer)
     global_tvtable_t config = {{0}};
     global_tv_table_decode(&config, buffer, length);
 
+	uint8_t settings[EEPROM_PAGE_SIZE];
+	get_active_config(settings);
+
     // Write global settings, encoder settings are handled by bulk Xfer
-	eeprom_write(EE_MIDI_CHANNEL, config.midiChannel - 1);
+	write_setting(settings, EE_MIDI_CHANNEL, config.midiChannel - 1);
 	
-	eeprom_write(EE_BANK_SIDE_SW, config.sideIsBanked);
-	eeprom_write(EE_SIDE_SW_1_FUNC, config.sideFunc1);
-	eeprom_write(EE_SIDE_SW_2_FUNC, config.sideFunc2);
-	eeprom_write(EE_SIDE_SW_3_FUNC, config.sideFunc3);
-	eeprom_write(EE_SIDE_SW_4_FUNC, config.sideFunc4);
-	eeprom_write(EE_SIDE_SW_5_FUNC, config.sideFunc5);
-	eeprom_write(EE_SIDE_SW_6_FUNC, config.sideFunc6);
-	eeprom_write(EE_SUPER_KNOB_START, config.superStart);
-	eeprom_write(EE_SUPER_KNOB_END, config.superEnd);	
-	eeprom_write(EE_RGB_BRIGHTNESS, config.rgb_brightness);
-	eeprom_write(EE_IND_BRIGHTNESS, config.ind_brightness);
-	eeprom_write(EE_COLOR_MAP, config.colorMap);
+	write_setting(settings, EE_BANK_SIDE_SW, config.sideIsBanked);
+	write_setting(settings, EE_SIDE_SW_1_FUNC, config.sideFunc1);
+	write_setting(settings, EE_SIDE_SW_2_FUNC, config.sideFunc2);
+	write_setting(settings, EE_SIDE_SW_3_FUNC, config.sideFunc3);
+	write_setting(settings, EE_SIDE_SW_4_FUNC, config.sideFunc4);
+	write_setting(settings, EE_SIDE_SW_5_FUNC, config.sideFunc5);
+	write_setting(settings, EE_SIDE_SW_6_FUNC, config.sideFunc6);
+	write_setting(settings, EE_SUPER_KNOB_START, config.superStart);
+	write_setting(settings, EE_SUPER_KNOB_END, config.superEnd);	
+	write_setting(settings, EE_RGB_BRIGHTNESS, config.rgb_brightness);
+	write_setting(settings, EE_IND_BRIGHTNESS, config.ind_brightness);
+	write_setting(settings, EE_COLOR_MAP, config.colorMap);
 	uint8_t enc_ch = config.enc_animChannels > 0 ? config.enc_animChannels - 1 : DEF_ENCODER_ANIMATION_CH;
 	uint8_t sw_ch  = config.sw_animChannels  > 0 ? config.sw_animChannels  - 1 : DEF_SWITCH_ANIMATION_CH;
-	eeprom_write(EE_ANIMATION_CHANNELS, PACK_ANIM_CHANNELS(enc_ch, sw_ch));
-	eeprom_write(EE_SLEEP_SETTINGS, PACK_SLEEP_SETTINGS(config.sleepTimeout, config.sleepAnimation));
-	eeprom_write(EE_BANK_ANIMATIONS_ENABLED, config.bankAnimationsEnabled);
+	write_setting(settings, EE_ANIMATION_CHANNELS, PACK_ANIM_CHANNELS(enc_ch, sw_ch));
+	write_setting(settings, EE_SLEEP_SETTINGS, PACK_SLEEP_SETTINGS(config.sleepTimeout, config.sleepAnimation));
+	write_setting(settings, EE_BANK_ANIMATIONS_ENABLED, config.bankAnimationsEnabled);
+	write_setting(settings, EE_GAMMA_CURVE, config.gammaCurve);
+	write_setting(settings, EE_BRIGHTNESS_CAP, config.brightnessCap);
 	real_time_start;
 	reset_idle_timer();
 	setting_confirmation_animation(0x00FF00);
 		
-	// Load the new settings from EEPROM
-    load_config();
-	// Re-init encoder settings (that aren't saved in EEPROM, must stay after load_config)
-	encoders_init();
+	if (preset_in_use()) {
+		// Only the global settings change, reloading the encoder settings
+		// would replace the preset with the EEPROM settings
+		apply_config(settings);
+	} else {
+		// Load the new settings from EEPROM
+		load_config();
+		// Re-init encoder settings (that aren't saved in EEPROM, must stay after load_config)
+		encoders_init();
+	}
 	// Return the config to the utility
     send_config_data();
 	// Rebuild the display 
@@ -105,7 +132,7 @@ void send_config_data (void)
 	cpu_irq_disable();
 	
 	side_sw_settings_t* side_cfg = get_side_switch_config();
-	uint8_t sleep_settings = eeprom_read(EE_SLEEP_SETTINGS);
+	uint8_t sleep_settings = active_config[EE_SLEEP_SETTINGS];
 	
 	cpu_irq_enable();
 	
@@ -124,12 +151,14 @@ void send_config_data (void)
 								9 , global_super_knob_end,
 								31, global_rgb_brightness,
 								32, global_ind_brightness,
-								33, eeprom_read(EE_COLOR_MAP),
+								33, active_config[EE_COLOR_MAP],
 								34, GET_ENC_ANIM_CHANNEL(global_animation_channels) + 1,
 								35, GET_SW_ANIM_CHANNEL(global_animation_channels) + 1,
 								36, GET_SLEEP_TIMEOUT(sleep_settings),
 								37, GET_SLEEP_ANIMATION(sleep_settings),
 								38, global_bank_animations_enabled,
+								39, active_config[EE_GAMMA_CURVE],
+								40, active_config[EE_BRIGHTNESS_CAP],
 
                                 0xf7};
 								
@@ -174,7 +203,11 @@ void sysExCmdSystem (uint8_t length, uint8_t* buffer)
 			// so we need to turn them back on to see display updates.
 			PMIC.CTRL = PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
 			setting_confirmation_animation(0x00FFFF);
-			
+			// We won't be back in the main loop, so show it all now and
+			// write back the settings
+			display_overlay_finish();
+			config_store_flush();
+						
 			USB_Disable();	
 			// Wait for USB disconnect to register on the host
 			_delay_ms(2000);
@@ -186,6 +219,13 @@ void sysExCmdSystem (uint8_t length, uint8_t* buffer)
 			while(true){};
         }
         break;
+    case 3:
+        {
+            // Write back all queued EEPROM pages now, for a host that is
+            // about to unplug the unit
+            encoder_config_flush();
+        }
+        break;
     default:
         break;
     }
@@ -249,11 +289,11 @@ static void sysExCmdBulkXfer(uint8_t length, uint8_t* buffer) // Process/ParseSy
 		uint8_t bank    = (sysex_tag-1)/16;  // (starting at object 1) 16 Objects per Bank
 		uint8_t encoder = (sysex_tag-1)%16;  // Encoder+Push Switch ID
 
-		encoder_config_t config = {{0}};     // encoder_config_t is output map+ all settings
+		encoder_transfer_t config = {{{{0}}}};     // encoder_transfer_t is output map+ all settings
 
 		// First we set all bytes to invalid values, this avoids
 		// saving any settings which where not included in this xfer
-		for(uint8_t i=0;i<ENC_CFG_SIZE;++i){
+		for(uint8_t i=0;i<ENC_XFER_SIZE;++i){
 			config.bytes[i] = 0x80; // 8th bit is never set for valid data
 		}
 
@@ -262,7 +302,7 @@ static void sysExCmdBulkXfer(uint8_t length, uint8_t* buffer) // Process/ParseSy
 		uint8_t tag;
 		while (idx < size - 1) {  // While not hitting the last byte (0xF7)
 			tag = buffer[idx++] - 10; //Match Utility Tag's  // (Sysex Tag 10) -> (Firmware Tag 0)
-			if (tag < ENC_CFG_SIZE) {
+			if (tag < ENC_XFER_SIZE) {
 				config.bytes[tag] = buffer[idx];
 			}
 			++idx;
@@ -288,9 +328,9 @@ static void sysExCmdBulkXfer(uint8_t length, uint8_t* buffer) // Process/ParseSy
 				encoder = (sysex_tag-1) % 16;
 			}
 			
-			// Read in the requested config data and add the tag values
-			encoder_config_t enc_cfg;
-			get_encoder_config(bank, encoder, &enc_cfg);
+			// Copy the requested config data from RAM and add the tag values
+			encoder_config_t enc_cfg = encoder_settings[(bank * PHYSICAL_ENCODERS) + encoder];
+			encoder_extra_config_t enc_extra = encoder_extra_settings[(bank * PHYSICAL_ENCODERS) + encoder];
 			
 			// Ensure order matches encoder_settings_t structure order
 			// The tags do not need to be consecutive, but it makes it 
@@ -311,6 +351,11 @@ static void sysExCmdBulkXfer(uint8_t length, uint8_t* buffer) // Process/ParseSy
 									 22, enc_cfg.indicator_display_type,
 									 23, enc_cfg.is_super_knob,
 									 24, enc_cfg.encoder_shift_midi_channel+1, // !Summer2016Update
+									 25, enc_extra.gesture_long_press_time,
+									 26, enc_extra.gesture_double_tap_time,
+									 27, enc_extra.detent_capture,
+									 28, enc_extra.detent_width,
+									 29, enc_extra.end_stop_size,
 									};
 				
 			// Total number of bytes to transfer
@@ -361,6 +406,11 @@ static void sysExCmdNativeMode(uint8_t length, uint8_t* buffer)
 	native_mode_handle_sysex_command(--length, buffer);
 }
 
+static void sysExCmdPreset(uint8_t length, uint8_t* buffer)
+{
+	preset_handle_sysex_command(length, buffer);
+}
+
 static void sysExCmdGetDeviceId(uint8_t length, uint8_t* buffer)
 {
 	if (length > 0 && buffer[0] == 0x0) {
@@ -380,6 +430,68 @@ static void sysExCmdGetDeviceId(uint8_t length, uint8_t* buffer)
 	}
 }
 
+// Splits a counter into 5 SysEx bytes of 7 bits, most significant first
+static void sysex_pack_counter(uint8_t* dest, uint32_t value)
+{
+	for (int8_t i = 4; i >= 0; --i) {
+		dest[i] = value & 0x7F;
+		value >>= 7;
+	}
+}
+
+/**
+ * Reports the display, EEPROM, journal, boot and preset counters, for
+ * measuring the effect of changes on a unit. Content 0x0 requests the
+ * counters, 0x2 requests them and then clears them.
+ */
+static void sysExCmdDiagnostics(uint8_t length, uint8_t* buffer)
+{
+	if (length > 0 && (buffer[0] == 0x0 || buffer[0] == 0x2)) {
+		uint8_t payload[] = {
+			0xF0, 0x00, MANUFACTURER_ID >> 8, MANUFACTURER_ID & 0x7F,
+			SYSEX_COMMAND_DIAGNOSTICS,
+			0x1,                                     // 0x0 = request, 0x1 = response
+			0x00, 0x00, 0x00, 0x00, 0x00,            // RGB color cache hits
+			0x00, 0x00, 0x00, 0x00, 0x00,            // RGB color cache misses
+			0x00, 0x00, 0x00, 0x00, 0x00,            // Longest EEPROM interrupts off time, uS
+			0x00, 0x00, 0x00, 0x00, 0x00,            // EEPROM pages written
+			0x00, 0x00, 0x00, 0x00, 0x00,            // Journal records written
+			0x00, 0x00, 0x00, 0x00, 0x00,            // Journal boot recovery time, uS
+			0x00, 0x00, 0x00, 0x00, 0x00,            // Boot settings load time, uS
+			0x00, 0x00, 0x00, 0x00, 0x00,            // Boot to USB ready time, uS
+			0x00, 0x00, 0x00, 0x00, 0x00,            // Boot settings check time, uS
+			0x00, 0x00, 0x00, 0x00, 0x00,            // Boot settings check result
+			0x00, 0x00, 0x00, 0x00, 0x00,            // Last preset recall time, uS
+			0x00, 0x00, 0x00, 0x00, 0x00,            // Last bank change redraw time, uS
+			0xF7
+		};
+		#if DISPLAY_RGB_CACHE > 0
+		sysex_pack_counter(&payload[6], display_rgb_cache_hits);
+		sysex_pack_counter(&payload[11], display_rgb_cache_misses);
+		if (buffer[0] == 0x2) {
+			display_rgb_cache_hits = 0;
+			display_rgb_cache_misses = 0;
+		}
+		#endif
+		sysex_pack_counter(&payload[16], (uint32_t)eeprom_irq_off_max * 8);	// TCC0 counts are 8 uS
+		sysex_pack_counter(&payload[21], eeprom_page_writes);
+		sysex_pack_counter(&payload[26], journal_records_written);
+		sysex_pack_counter(&payload[31], (uint32_t)journal_boot_time * 8);	// Not cleared, it is measured once
+		sysex_pack_counter(&payload[36], (uint32_t)boot_config_load_time * 32);	// BOOT_TIMER counts are 32 uS
+		sysex_pack_counter(&payload[41], (uint32_t)boot_usb_ready_time * 32);
+		sysex_pack_counter(&payload[46], (uint32_t)boot_config_check_time * 32);
+		sysex_pack_counter(&payload[51], config_store_result);
+		sysex_pack_counter(&payload[56], (uint32_t)preset_recall_time * 8);	// TCC0 counts are 8 uS
+		sysex_pack_counter(&payload[61], (uint32_t)bank_change_time * 8);
+		if (buffer[0] == 0x2) {
+			eeprom_irq_off_max = 0;
+			eeprom_page_writes = 0;
+			journal_records_written = 0;
+		}
+		midi_stream_sysex(sizeof(payload), payload);
+	}
+}
+
 void config_init(void)
 {
   // Install SysEx command handlers
@@ -389,51 +501,93 @@ void config_init(void)
   sysex_install(SYSEX_COMMAND_BULK_XFER, sysExCmdBulkXfer);
   sysex_install(SYSEX_COMMAND_GET_DEVICE_ID, sysExCmdGetDeviceId);
   sysex_install(SYSEX_COMMAND_NATIVE_MODE, sysExCmdNativeMode);
+  sysex_install(SYSEX_COMMAND_DIAGNOSTICS, sysExCmdDiagnostics);
+  sysex_install(SYSEX_COMMAND_PRESET, sysExCmdPreset);
 	  
 
 	
-	// If our EEPROM layout has changed, reset everything.
-	if (eeprom_read(EE_EEPROM_VERSION) != EEPROM_LAYOUT) {
+	// Check the settings CRC and migrate settings saved by older firmware,
+	// only settings which can't be trusted or migrated are reset
+	uint16_t start = tc_read_count(&BOOT_TIMER);
+	config_store_result_t result = config_store_check();
+	boot_config_check_time = tc_read_count(&BOOT_TIMER) - start;
+	
+	if (result == CONFIG_STORE_INVALID) {
 		config_factory_reset();
 	}
 }
 
+// The global settings are read as one block from the first EEPROM page
+#if DEV_SETTINGS_START_PAGE != 0 || EE_BRIGHTNESS_CAP >= EEPROM_PAGE_SIZE
+#error The global settings must all be in the first EEPROM page
+#endif
+
 void load_config(void)
 {
+	// Read the whole page at once, rather than a byte (and an interrupts off
+	// EEPROM access) per setting
+	uint8_t settings[EEPROM_PAGE_SIZE];
+	eeprom_queue_read_buffer(DEV_SETTINGS_START_PAGE * EEPROM_PAGE_SIZE, settings, EEPROM_PAGE_SIZE);
+	apply_config(settings);
+}
+
+/**
+ * Puts a page of global settings, laid out as in the first EEPROM page, in to
+ * use without saving them.
+ *
+ * \param settings [in]	EEPROM_PAGE_SIZE bytes
+ */
+void apply_config(const uint8_t *settings)
+{
+	memcpy(active_config, settings, EEPROM_PAGE_SIZE);
+
 	cpu_irq_disable();
 	
 	// Load system settings
-	midi_system_channel = eeprom_read(EE_MIDI_CHANNEL);
+	midi_system_channel = settings[EE_MIDI_CHANNEL];
 	
 	// Load side button settings
 	side_sw_settings_t side_sw_cfg;
 	
-	side_sw_cfg.side_is_banked = eeprom_read(EE_BANK_SIDE_SW);
-	side_sw_cfg.sw_action[0]   = eeprom_read(EE_SIDE_SW_1_FUNC);
-	side_sw_cfg.sw_action[1]   = eeprom_read(EE_SIDE_SW_2_FUNC);
-	side_sw_cfg.sw_action[2]   = eeprom_read(EE_SIDE_SW_3_FUNC);
-	side_sw_cfg.sw_action[3]   = eeprom_read(EE_SIDE_SW_4_FUNC);
-	side_sw_cfg.sw_action[4]   = eeprom_read(EE_SIDE_SW_5_FUNC);
-	side_sw_cfg.sw_action[5]   = eeprom_read(EE_SIDE_SW_6_FUNC);
+	side_sw_cfg.side_is_banked = settings[EE_BANK_SIDE_SW];
+	side_sw_cfg.sw_action[0]   = settings[EE_SIDE_SW_1_FUNC];
+	side_sw_cfg.sw_action[1]   = settings[EE_SIDE_SW_2_FUNC];
+	side_sw_cfg.sw_action[2]   = settings[EE_SIDE_SW_3_FUNC];
+	side_sw_cfg.sw_action[3]   = settings[EE_SIDE_SW_4_FUNC];
+	side_sw_cfg.sw_action[4]   = settings[EE_SIDE_SW_5_FUNC];
+	side_sw_cfg.sw_action[5]   = settings[EE_SIDE_SW_6_FUNC];
 	
-	global_super_knob_start	   = eeprom_read(EE_SUPER_KNOB_START);
-	global_super_knob_end      = eeprom_read(EE_SUPER_KNOB_END);
-	global_rgb_brightness      = eeprom_read(EE_RGB_BRIGHTNESS);
-	global_ind_brightness      = eeprom_read(EE_IND_BRIGHTNESS);
-	colorMap_init();
-	global_animation_channels = eeprom_read(EE_ANIMATION_CHANNELS);
-	uint8_t sleep_settings = eeprom_read(EE_SLEEP_SETTINGS);
+	global_super_knob_start	   = settings[EE_SUPER_KNOB_START];
+	global_super_knob_end      = settings[EE_SUPER_KNOB_END];
+	global_rgb_brightness      = settings[EE_RGB_BRIGHTNESS];
+	global_ind_brightness      = settings[EE_IND_BRIGHTNESS];
+	colorMap_select(settings[EE_COLOR_MAP]);
+	global_animation_channels = settings[EE_ANIMATION_CHANNELS];
+	uint8_t sleep_settings = settings[EE_SLEEP_SETTINGS];
 	uint8_t timeout_index = GET_SLEEP_TIMEOUT(sleep_settings);
 	if (timeout_index > 7) timeout_index = 0;
 	sleep_timeout_minutes = sleep_timeout_map[timeout_index];
 	sleep_animation_type  = GET_SLEEP_ANIMATION(sleep_settings);
-	global_bank_animations_enabled = eeprom_read(EE_BANK_ANIMATIONS_ENABLED);
-	
+	global_bank_animations_enabled = settings[EE_BANK_ANIMATIONS_ENABLED];
+	display_set_gamma_curve(settings[EE_GAMMA_CURVE]);
+	display_set_brightness_cap(settings[EE_BRIGHTNESS_CAP]);
+
 	side_switch_config(&side_sw_cfg);
 	
 	cpu_irq_enable();
 }
 
+/**
+ * Copies the global settings page in use, which may be a recalled preset
+ * rather than the settings saved in the EEPROM.
+ *
+ * \param settings [out]	EEPROM_PAGE_SIZE bytes
+ */
+void get_active_config(uint8_t *settings)
+{
+	memcpy(settings, active_config, EEPROM_PAGE_SIZE);
+}
+
 // This could be re-written to use config structures
 // with defaults saved in PROGEM
 void config_factory_reset(void)
@@ -463,10 +617,15 @@ void config_factory_reset(void)
 	eeprom_write(EE_ANIMATION_CHANNELS, PACK_ANIM_CHANNELS(DEF_ENCODER_ANIMATION_CH, DEF_SWITCH_ANIMATION_CH));
 	eeprom_write(EE_SLEEP_SETTINGS, DEF_SLEEP_SETTINGS);
 	eeprom_write(EE_BANK_ANIMATIONS_ENABLED, DEF_BANK_ANIMATIONS_ENABLED);
-	
+	eeprom_write(EE_GAMMA_CURVE, DEF_GAMMA_CURVE);
+	eeprom_write(EE_BRIGHTNESS_CAP, DEF_BRIGHTNESS_CAP);
+
 	cpu_irq_enable();
 	
 	// Encoder Settings
 	factory_reset_encoder_config();
+	
+	// Runtime state
+	journal_reset();
 }
 
@@ -29,6 +29,7 @@
 	
 		#include "sysex.h"
 		#include "eeprom.h"
+		#include "config_store.h"
 		#include "jump_to_bootloader.h"
 		
 		// Include all objects which require config
@@ -45,10 +46,12 @@
 		#define SYSEX_COMMAND_BULK_XFER     0x4
 		#define SYSEX_COMMAND_GET_DEVICE_ID 0x5
     #define SYSEX_COMMAND_NATIVE_MODE   0x6
+		#define SYSEX_COMMAND_DIAGNOSTICS   0x7
+		#define SYSEX_COMMAND_PRESET        0x8
 		
 	/* Typedefs: */
 		
-		#define GLOBAL_TABLE_SIZE 18
+		#define GLOBAL_TABLE_SIZE 20
 		// The global table holds the Twister global settings
 		typedef union {
 			struct {
@@ -71,6 +74,8 @@
 				uint8_t sleepTimeout;
 				uint8_t sleepAnimation;
 				uint8_t bankAnimationsEnabled;
+				uint8_t gammaCurve;
+				uint8_t brightnessCap;
 				
 			};
 			uint8_t bytes[GLOBAL_TABLE_SIZE];
@@ -85,6 +90,17 @@
 		uint8_t global_animation_channels;
 		uint8_t global_bank_animations_enabled;
 
+		// Free runs at 32 uS per count from system_init() until USB is
+		// configured. TCD0 and TCD1 belong to the display, TCC0 and TCC1 to
+		// the display and input timers.
+		#define BOOT_TIMER	TCE0
+
+		// Boot phase times from main(), in BOOT_TIMER counts (32 uS), 0xFFFF is
+		// 2.1 S or longer
+		extern uint16_t boot_config_load_time;	// Through loading the settings
+		extern uint16_t boot_usb_ready_time;	// Through the host configuring USB
+		extern uint16_t boot_config_check_time;	// Taken by config_store_check()
+
 
 		#define GET_ENC_ANIM_CHANNEL(packed)  (((packed) >> 4) & 0x0F)
 		#define GET_SW_ANIM_CHANNEL(packed)   ((packed) & 0x0F)
@@ -93,6 +109,8 @@
 	
 		void config_init (void);
 		void load_config(void);
+		void apply_config(const uint8_t *settings);
+		void get_active_config(uint8_t *settings);
 		void send_config_data (void);
 		void config_factory_reset(void);
 		
@@ -100,9 +118,9 @@
 	/*	Inline Functions: */
 	
 		/**
-		 * Writes an 8 bit value to EEPROM
-		 * If your code uses program space access in interrupts you must disable those
-		 * interrupts before calling this function
+		 * Writes an 8 bit value to EEPROM, through the write-behind queue so the
+		 * page is written back later from the main loop. Changed settings mark
+		 * the settings as being saved.
 		 *
 		 * \param [in] address	The location to write to
 		 *
@@ -111,20 +129,19 @@
 		 */
 		 static inline void eeprom_write(uint16_t address, uint8_t data)
 		 {
-			nvm_eeprom_write_byte(address, data);
+			config_store_write_byte(address, data);
 		 }
 		 
 		 /**
-		  * Reads an 8-bit value from EEPROM memory.
-		  * If your code uses program space access in interrupts you must disable those
-		  * interrupts before calling this function
+		  * Reads an 8-bit value from EEPROM memory, including writes still waiting
+		  * in the write-behind queue
 		  * 
           * \param [in]	The address to read from
           *
           */
          static inline uint8_t eeprom_read(uint16_t address)
           {	
-			return nvm_eeprom_read_byte(address);	
+			return eeprom_queue_read_byte(address);	
 		  }
 		  
 		 /**
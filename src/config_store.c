@@ -0,0 +1,279 @@
+/*
+ * config_store.c
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <util/crc16.h>
+
+#include "config_store.h"
+#include "eeprom.h"
+#include "gesture.h"
+
+#if DEV_SETTINGS_START_PAGE != 0
+#error The self test flag address assumes the global settings are in page 0
+#endif
+#if !defined(EXTENDED_BANKS) && CONFIG_STORE_START_PAGE + CONFIG_STORE_PAGES > SEQ_EEPROM_START_PAGE
+#error The settings overlap the sequencer patterns
+#endif
+
+// The settings CRC is kept in the EEPROM queue's guard log, as the value of a
+// seal. Every settings page write is logged before it starts, so the newest
+// record is a seal only while the settings are as sealed. Once all the pages
+// of a save are written config_store_task() works out the new CRC, a page per
+// main loop pass, and seals the settings with it. Power lost part way through
+// a save leaves a page write as the newest record. Every settings page is
+// then either old or new, unless that page was torn, which the record shows.
+// Boot keeps the settings and works out a new CRC only when no page is torn,
+// otherwise they are reset. A save costs no writes beyond its pages and one
+// record per page and per seal.
+
+// Migrations, each takes the settings from one layout to the next. Layouts
+// without an entry (and blank EEPROM) are factory reset.
+typedef struct {
+	uint8_t layout;
+	void (*migrate)(void);
+} config_migration_t;
+
+static void migrate_layout_8(void);
+
+static const config_migration_t config_migrations[] = {
+	{8, migrate_layout_8},
+};
+
+uint8_t config_store_result;
+
+static bool config_store_updating;		// The settings have changed since the last seal
+static uint8_t config_store_page;		// Next page config_store_task() adds to the CRC
+static uint16_t config_store_sum;		// CRC of the pages before config_store_page
+
+// The self test flag shares the first page with the settings, but isn't
+// covered by the CRC
+static bool config_store_is_setting(uint16_t address)
+{
+	return (address < (CONFIG_STORE_START_PAGE + CONFIG_STORE_PAGES) * EEPROM_PAGE_SIZE) &&
+		   (address != EE_SELF_TEST_FLAG);
+}
+
+// Adds one page to a CRC of the settings, as it reads through the queue
+static uint16_t config_store_page_crc(uint8_t page, uint16_t crc)
+{
+	uint8_t data[EEPROM_PAGE_SIZE];
+	eeprom_queue_read_buffer(page * EEPROM_PAGE_SIZE, data, EEPROM_PAGE_SIZE);
+
+	for (uint8_t i = 0; i < EEPROM_PAGE_SIZE; ++i) {
+		if (page != DEV_SETTINGS_START_PAGE || config_store_is_setting(i)) {
+			crc = _crc_ccitt_update(crc, data[i]);
+		}
+	}
+	return crc;
+}
+
+static uint16_t config_store_crc(void)
+{
+	uint16_t crc = 0xFFFF;
+	for (uint8_t page = 0; page < CONFIG_STORE_PAGES; ++page) {
+		crc = config_store_page_crc(CONFIG_STORE_START_PAGE + page, crc);
+	}
+	return crc;
+}
+
+// Seals the settings with a CRC of crc, none may be waiting to be written
+static void config_store_seal(uint16_t crc)
+{
+	eeprom_queue_seal(crc);
+	config_store_updating = false;
+}
+
+// Call before changing any settings in the EEPROM
+static void config_store_changed(void)
+{
+	config_store_page = 0;
+	config_store_updating = true;
+}
+
+/**
+ * Checks the settings at boot and brings those saved by older firmware up to
+ * the current layout. The check reads each settings page once and each
+ * migration runs at most once, so it takes a bounded time.
+ *
+ * \return CONFIG_STORE_INVALID where the settings need a factory reset
+ */
+config_store_result_t config_store_check(void)
+{
+	uint8_t layout = eeprom_queue_read_byte(EE_EEPROM_VERSION);
+	uint16_t saved_crc = 0;
+	config_store_result_t result;
+
+	eeprom_queue_guard(CONFIG_STORE_START_PAGE, CONFIG_STORE_PAGES);
+	eeprom_guard_state_t state = eeprom_queue_guard_state(&saved_crc);
+
+	if (state == EEPROM_GUARD_TORN) {
+		// A settings page was torn part way through a migration or a save, it
+		// can't be migrated or sealed under a new CRC
+		result = CONFIG_STORE_INVALID;
+	} else if (layout != EEPROM_LAYOUT) {
+		while (layout != EEPROM_LAYOUT) {
+			const config_migration_t *migration = NULL;
+			for (uint8_t i = 0; i < sizeof(config_migrations) / sizeof(config_migrations[0]); ++i) {
+				if (config_migrations[i].layout == layout) {
+					migration = &config_migrations[i];
+				}
+			}
+			if (!migration) {
+				break;
+			}
+			migration->migrate();
+			layout++;
+		}
+
+		if (layout == EEPROM_LAYOUT) {
+			// The migrated settings are written before the new layout version,
+			// so a migration cut short runs again at the next boot
+			eeprom_queue_flush();
+			eeprom_queue_write_byte(EE_EEPROM_VERSION, EEPROM_LAYOUT);
+			eeprom_queue_flush();
+			config_store_seal(config_store_crc());
+			eeprom_queue_flush();
+			result = CONFIG_STORE_MIGRATED;
+		} else {
+			result = CONFIG_STORE_INVALID;
+		}
+	} else {
+		uint16_t crc = config_store_crc();
+
+		if (state == EEPROM_GUARD_WRITTEN) {
+			// Power was lost during a save, but between page writes, so keep
+			// the settings that were written
+			config_store_seal(crc);
+			result = CONFIG_STORE_FINISHED;
+		} else if (state == EEPROM_GUARD_SEALED && crc == saved_crc) {
+			result = CONFIG_STORE_VALID;
+		} else {
+			result = CONFIG_STORE_INVALID;
+		}
+	}
+
+	if (result == CONFIG_STORE_INVALID) {
+		// The factory reset which follows may not change any settings, mark
+		// them as being saved so it still ends with a new seal
+		config_store_changed();
+	}
+
+	config_store_result = result;
+	return result;
+}
+
+/**
+ * Writes a byte of EEPROM through the queue, marking the settings as being
+ * saved when the byte is a setting which changes.
+ *
+ * \param address [in]	The location to write to
+ *
+ * \param data [in]		The byte
+ */
+void config_store_write_byte(uint16_t address, uint8_t data)
+{
+	if (config_store_is_setting(address) && eeprom_queue_read_byte(address) != data) {
+		config_store_changed();
+	}
+	eeprom_queue_write_byte(address, data);
+}
+
+/**
+ * Queues a whole page of encoder or gesture settings, marking the settings as
+ * being saved when the page changes. Not for the global settings page, which
+ * holds the self test flag.
+ *
+ * \param page [in]		EEPROM page
+ *
+ * \param data [in]		EEPROM_PAGE_SIZE bytes to write
+ */
+void config_store_write_page(uint8_t page, const uint8_t *data)
+{
+	if ((uint8_t)(page - CONFIG_STORE_START_PAGE) < CONFIG_STORE_PAGES) {
+		uint8_t current[EEPROM_PAGE_SIZE];
+		eeprom_queue_read_buffer(page * EEPROM_PAGE_SIZE, current, EEPROM_PAGE_SIZE);
+		if (memcmp(current, data, EEPROM_PAGE_SIZE)) {
+			config_store_changed();
+		}
+	}
+	eeprom_queue_write_page(page, data);
+}
+
+/**
+ * Seals the settings with their new CRC once a save has reached the EEPROM,
+ * adding one settings page to the CRC per call. Call once per main loop pass.
+ */
+void config_store_task(void)
+{
+	if (!config_store_updating) {
+		return;
+	}
+
+	// The CRC is of the settings as written, start again if any are waiting
+	if (eeprom_queue_pending(CONFIG_STORE_START_PAGE, CONFIG_STORE_PAGES)) {
+		config_store_page = 0;
+		return;
+	}
+
+	if (config_store_page == 0) {
+		config_store_sum = 0xFFFF;
+	}
+	config_store_sum = config_store_page_crc(CONFIG_STORE_START_PAGE + config_store_page, config_store_sum);
+	if (++config_store_page >= CONFIG_STORE_PAGES) {
+		config_store_seal(config_store_sum);
+	}
+}
+
+/**
+ * Writes the settings, their seal and the rest of the EEPROM queue back now,
+ * waiting for the writes to finish.
+ */
+void config_store_flush(void)
+{
+	eeprom_queue_flush();
+	if (config_store_updating) {
+		config_store_seal(config_store_crc());
+		eeprom_queue_flush();
+	}
+}
+
+// Layout 8 was also saved by firmware from before the gamma curve, brightness
+// cap and gesture times, where they are still erased they get their defaults
+static void migrate_layout_8(void)
+{
+	if (eeprom_queue_read_byte(EE_GAMMA_CURVE) == 0xFF) {
+		config_store_write_byte(EE_GAMMA_CURVE, DEF_GAMMA_CURVE);
+	}
+	if (eeprom_queue_read_byte(EE_BRIGHTNESS_CAP) == 0xFF) {
+		config_store_write_byte(EE_BRIGHTNESS_CAP, DEF_BRIGHTNESS_CAP);
+	}
+
+	uint8_t page_buffer[EEPROM_PAGE_SIZE];
+	for (uint8_t bank = 0; bank < NUM_BANKS; ++bank) {
+		eeprom_queue_read_buffer((GESTURE_SETTINGS_START_PAGE + bank) * EEPROM_PAGE_SIZE, page_buffer, EEPROM_PAGE_SIZE);
+		for (uint8_t i = 0; i < EEPROM_PAGE_SIZE; i += GESTURE_EE_SIZE) {
+			if (page_buffer[i] == 0xFF) {
+				page_buffer[i] = DEF_GESTURE_LONG_PRESS_TIME;
+			}
+			if (page_buffer[i + 1] == 0xFF) {
+				page_buffer[i + 1] = DEF_GESTURE_DOUBLE_TAP_TIME;
+			}
+		}
+		config_store_write_page(GESTURE_SETTINGS_START_PAGE + bank, page_buffer);
+	}
+}
@@ -0,0 +1,60 @@
+/*
+ * config_store.h
+ *
+ * Guards the settings held in EEPROM (the global settings, encoder settings
+ * and gesture times) with a CRC-16 over all the settings, kept as the seal in
+ * the EEPROM queue's guard log. The log also shows whether a save was still
+ * being written, and finds a settings page torn by power loss. Settings saved
+ * by older firmware are migrated to the current layout in place, rather than
+ * reset.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef CONFIG_STORE_H_
+#define CONFIG_STORE_H_
+
+/*	Includes: */
+	#include <asf.h>
+
+	#include "constants.h"
+
+/*	Macros: */
+	// The settings run from the global settings page to the last gesture page
+	#define CONFIG_STORE_START_PAGE		DEV_SETTINGS_START_PAGE
+	#define CONFIG_STORE_PAGES			(GESTURE_SETTINGS_START_PAGE + NUM_BANKS - DEV_SETTINGS_START_PAGE)
+
+/* Types: */
+	// Result of config_store_check()
+	typedef enum {
+		CONFIG_STORE_VALID,			// The CRC matched
+		CONFIG_STORE_MIGRATED,		// An older layout was brought up to date
+		CONFIG_STORE_FINISHED,		// A save was cut short between pages, the CRC is rebuilt
+		CONFIG_STORE_INVALID,		// Unknown layout, no seal, a bad CRC or a torn page, needs a factory reset
+	} config_store_result_t;
+
+/* Variables */
+	extern uint8_t config_store_result;		// config_store_result_t of the boot check
+
+/* Function Prototypes: */
+	config_store_result_t config_store_check(void);
+	void config_store_write_byte(uint16_t address, uint8_t data);
+	void config_store_write_page(uint8_t page, const uint8_t *data);
+	void config_store_task(void);
+	void config_store_flush(void);
+
+#endif /* CONFIG_STORE_H_ */
@@ -93,7 +93,7 @@
 
 
 // EEPROM Constants -------------------------------------------------------
-#define EEPROM_LAYOUT			         8	//The EEPROM layout version
+#define EEPROM_LAYOUT			         9	//The EEPROM layout version, older layouts are migrated by config_store.c
 
 // EEPROM Memory Locations for configurable settings
 
@@ -116,6 +116,8 @@
 #define EE_ANIMATION_CHANNELS		0x000F	//Encoder and switch animation channels
 #define EE_SLEEP_SETTINGS			0x0010  // Timeout (6 bits) + Animation (2 bits)
 #define EE_BANK_ANIMATIONS_ENABLED	0x0011	// Bank change animations on/off
+#define EE_GAMMA_CURVE				0x0012	// RGB gamma curve
+#define EE_BRIGHTNESS_CAP			0x0013	// Global LED brightness cap
 
 #define PACK_SLEEP_SETTINGS(timeout, anim)   (((timeout) & 0x3F) | (((anim) & 0x03) << 6))
 #define GET_SLEEP_TIMEOUT(val)               ((val) & 0x3F)
@@ -137,10 +139,12 @@
 #define EE_INACTIVE_COLOR_OFFSET	0x0003  //Inactive Color offset
 
 #define ENC_EE_SIZE 8
+#define GESTURE_EE_SIZE 2	// Long-press time, Double-tap time (x10ms)
 
 #define DEV_SETTINGS_START_PAGE      0
 #define ENC_SETTINGS_START_PAGE		 1
 #define SEQ_EEPROM_START_PAGE		31
+#define GESTURE_SETTINGS_START_PAGE	(ENC_SETTINGS_START_PAGE + (4 * NUM_BANKS)) // Follows the encoder settings, 16 encoders per page
 
 // Defaults -------------------------------------------------------------------
 // System 
@@ -167,6 +171,8 @@
 #define DEF_SLEEP_ANIMATION			1		// Default 0 = lights off, 1 = rainbow wave
 #define DEF_SLEEP_SETTINGS			PACK_SLEEP_SETTINGS(DEF_SLEEP_TIMEOUT, DEF_SLEEP_ANIMATION)
 #define DEF_BANK_ANIMATIONS_ENABLED	true
+#define DEF_GAMMA_CURVE				0		// GAMMA_CURVE_LINEAR
+#define DEF_BRIGHTNESS_CAP			0		// No cap
 
 
 
@@ -34,9 +34,25 @@ extern uint8_t indicator_value_buffer[NUM_BANKS][16];
 extern encoder_config_t encoder_settings[];
 
 /* Variables: */
-static uint8_t display_frame_buffer[DMA_BUFFER_SIZE]; 
+typedef uint8_t display_planes_t[DISPLAY_BIT_PLANES][DMA_FRAME_SIZE];
+static display_planes_t display_frame_buffer[DISPLAY_FRAME_BUFFERS];
+#if DISPLAY_DOUBLE_BUFFER > 0
+static volatile uint8_t display_front;		// Buffer the DMA is streaming from
+static volatile bool display_back_ready;	// Back buffer holds only complete writes
+static volatile bool display_back_stale;	// Buffers were swapped, back is behind front
+#else
+#define display_front 0
+#endif
+#if DISPLAY_OE_PWM > 0
+// The /OE duty is the brightness cap level scaled by the fade level
+static uint8_t display_oe_cap = DISPLAY_OE_LEVEL_MAX;
+static volatile uint8_t display_fade_level = DISPLAY_OE_LEVEL_MAX;
+static volatile uint8_t display_fade_target = DISPLAY_OE_LEVEL_MAX;
+static volatile uint8_t display_fade_step;
+#endif
 volatile uint8_t animation_counter;
-static uint8_t pulse_anim_origin = 0;
+uint16_t animation_phase;		// animation_counter with 8 bits of fraction
+static uint16_t pulse_anim_origin = 0;
 
 static uint8_t  s_bank_anim_bank   = 0xFF;  // 0xFF = inactive
 static bool     s_bank_anim_fading = false; // true only during fade
@@ -44,16 +60,58 @@ static uint16_t s_bank_anim_level  = 0;
 static const uint8_t bank_anim_columns[4][4]   = {{0,4,8,12},{1,5,9,13},{2,6,10,14},{3,7,11,15}};
 static const uint8_t bank_anim_quadrants[4][4] = {{0,1,4,5},{2,3,6,7},{8,9,12,13},{10,11,14,15}};
 
-volatile uint8_t display_frame_index;
-volatile uint8_t tick;
+volatile uint8_t display_frame_index;	// BCM slot of the plane in the shift registers
+static volatile bool display_plane_loaded;	// That plane has finished shifting in
+static volatile uint8_t display_plane_units;	// Its on-time in frame periods
+volatile uint16_t tick;
+
+// Bit-plane shown in each BCM slot, and its on-time in frame periods. Planes 5
+// and 6 are split in two, the weights add up to DISPLAY_BCM_LEVEL_MAX.
+static const uint8_t bcm_slot_plane[DISPLAY_BCM_SLOTS] = { 6, 0, 5,  1, 4,  6, 2, 5,  3};
+static const uint8_t bcm_slot_units[DISPLAY_BCM_SLOTS] = {32, 1, 16, 2, 16, 32, 4, 16, 8};
 
 // Array which holds the 7 current bit color value for the RGB segments
 static uint8_t rgb_color_setting[16];
 
+// Color pipeline settings, see display_set_gamma_curve()
+static uint8_t display_gamma_curve = GAMMA_CURVE_LINEAR;
+static uint8_t display_brightness_cap = DISPLAY_BRIGHTNESS_CAP_OFF;
+
+#if DISPLAY_PWM_STEPS != COLOR_TABLE_PWM_STEPS || DISPLAY_BCM_LEVEL_MAX != COLOR_TABLE_LEVEL_MAX
+#error The color tables do not match the display, regenerate src/color_tables.c
+#endif
+
+#if DISPLAY_RGB_CACHE > 0
+// Bit-plane levels of a recently drawn color and brightness, direct mapped
+typedef struct {
+	uint16_t key;		// RGB_CACHE_VALID | color << 8 | brightness, 0 if empty
+	uint8_t red_level;
+	uint8_t green_level;
+	uint8_t blue_level;
+} rgb_cache_entry_t;
+
+#define RGB_CACHE_VALID	0x8000
+
+static rgb_cache_entry_t rgb_cache[DISPLAY_RGB_CACHE_SIZE];
+static const uint8_t (*rgb_cache_color_map)[3];	// The color map the cache was filled from
+uint32_t display_rgb_cache_hits;
+uint32_t display_rgb_cache_misses;
+
+// Empties the cache, for when the color settings change
+static void rgb_cache_clear(void)
+{
+	memset(rgb_cache, 0, sizeof(rgb_cache));
+}
+#endif
+
 
 /*Function Prototypes: */
 static void display_frame_timer(void);
+static void display_dma_done(enum dma_channel_status status);
 static void display_animation_timer(void);
+#if DISPLAY_OE_PWM > 0
+static void display_oe_update(void);
+#endif
 
 /** Initialization Function for the display driver, this sets up the 
  *  DMA controller, configures USARTD0 in SPI Master Mode, and configures 
@@ -95,8 +153,8 @@ void display_init(void)
 	
 	// Configure the display frame buffer array as the start address for the 
 	// transfer
-	dma_channel_set_source_address(&dmach_conf, 
-								  (uint16_t)(uintptr_t)display_frame_buffer);
+	dma_channel_set_source_address(&dmach_conf,
+								  (uint16_t)(uintptr_t)display_frame_buffer[display_front][bcm_slot_plane[0]]);
 								  
 	// Configure the UART Data register as the destination address for the 
 	// transfer
@@ -107,6 +165,13 @@ void display_init(void)
 	// transfers
 	dma_channel_set_trigger_source(&dmach_conf, 
 								   DMA_CH_TRIGSRC_USARTD0_DRE_gc);
+
+	// The transaction complete interrupt loads the next plane's address, so
+	// the frame interrupt only has to latch and start the DMA. It is at the
+	// frame interrupt's level, the main loop turns the lower levels off while
+	// it reads USB MIDI and the frame interrupt can't latch until it has run.
+	dma_set_callback(DMA_CHANNEL, display_dma_done);
+	dma_channel_set_interrupt_level(&dmach_conf, DMA_INT_LVL_HI);
 	
 	// Initialize the DMA module
 	dma_enable();
@@ -138,9 +203,10 @@ void display_init(void)
 	
 	// Timer Initialization ---------------------------------------------------
 	
-	/** The Display Driver uses a timer driven interrupt to initialize sending 
-	 *  each frame via a DMA transaction. This interrupt occurs every 40 uS to
-	 *	give a display refresh rate of 40 uS X 127 = 196.85 Hz
+	/** The Display Driver uses a timer driven interrupt to initialize sending
+	 *  each bit-plane via a DMA transaction. The shortest plane is displayed
+	 *	for one frame period of 72 uS, long enough to transfer the next plane,
+	 *	which gives a display refresh rate of 1 / (72 uS X 127) = 109 Hz.
 	 *  We achieve a 72 uS period by dividing the 32 MHz CLK by 256 and setting
 	 *  the overflow count to 9.
 	 */
@@ -190,21 +256,82 @@ void display_init(void)
 	
 	// Leave Display_Latch Low
 	ioport_set_pin_level(DISPLAY_LATCH, 0);
+
+	#if DISPLAY_OE_PWM > 0
+	// /OE PWM Initialization ---------------------------------------------------
+
+	/** Timer D0 runs single slope PWM at 32 MHz / 255 = 125 kHz, so even the
+	 *  shortest bit-plane sees 9 periods. The compare output only drives the
+	 *  pin once display_enable() is called, until then the port holds it high.
+	 */
+	tc_enable(&DISPLAY_OE_TIMER);
+	tc_set_wgm(&DISPLAY_OE_TIMER, TC_WG_SS);
+	tc_write_period(&DISPLAY_OE_TIMER, DISPLAY_OE_LEVEL_MAX - 1);
+	display_oe_update();
+	tc_write_clock_source(&DISPLAY_OE_TIMER, TC_CLKSEL_DIV1_gc);
+	#endif
+
+	#if DISPLAY_ISR_PROFILE > 0
+	tc_enable(&DISPLAY_PROFILE_TIMER);
+	tc_write_clock_source(&DISPLAY_PROFILE_TIMER, TC_CLKSEL_DIV1_gc);
+	#endif
 	
 	// Initialize the animation tick and animation counter
 	//uint8_t animation_counter = 0;
 	//static uint8_t tick = 0;
 	
-	// Finally initialize the frame counter
-	display_frame_index = 0;
+	// Finally initialize the slot counter, the first interrupt latches the
+	// empty registers and sends slot 0, which is already loaded into the DMA
+	display_frame_index = DISPLAY_BCM_SLOTS - 1;
+	display_plane_units = bcm_slot_units[display_frame_index];
+	display_plane_loaded = true;
 }
 
+#if DISPLAY_OE_PWM > 0
+/**
+ * Writes the /OE duty for the current cap and fade levels, it takes effect at
+ * the end of the PWM period. Must not be interrupted by display_animation_timer.
+ */
+static void display_oe_update(void)
+{
+	uint8_t level = (uint8_t)(((uint16_t)display_oe_cap * display_fade_level + DISPLAY_OE_LEVEL_MAX) >> 8);
+	// The output is high (LEDs off) from BOTTOM until the compare match, a
+	// compare value above the period keeps it high for the whole period
+	tc_write_cc_buffer(&DISPLAY_OE_TIMER, TC_CCA, DISPLAY_OE_LEVEL_MAX - level);
+}
+
+/**
+ * Moves the fade level one step towards its target, called every mS.
+ */
+static inline void display_fade_tick(void)
+{
+	uint8_t level = display_fade_level;
+	uint8_t target = display_fade_target;
+
+	if (level == target) {
+		return;
+	}
+	if (level < target) {
+		level = (target - level > display_fade_step) ? level + display_fade_step : target;
+	} else {
+		level = (level - target > display_fade_step) ? level - display_fade_step : target;
+	}
+	display_fade_level = level;
+	display_oe_update();
+}
+#endif
+
 /**
  *  Enables Display by setting the /OE pin of the drives low and enabling Timer 0 
  */
 void display_enable(void)
 {
+	#if DISPLAY_OE_PWM > 0
+	// Hand the pin over to the PWM
+	tc_enable_cc_channels(&DISPLAY_OE_TIMER, TC_CCAEN);
+	#else
 	ioport_set_pin_level(DISPLAY_EN, 0);	
+	#endif
 }
 
 /**
@@ -212,7 +339,83 @@ void display_enable(void)
  */
 void display_disable(void)
 {
+	#if DISPLAY_OE_PWM > 0
+	// The pin goes back to the port, which is always left high
+	tc_disable_cc_channels(&DISPLAY_OE_TIMER, TC_CCAEN);
+	#else
 	ioport_set_pin_level(DISPLAY_EN, 1);	
+	#endif
+}
+
+#if DISPLAY_OE_PWM > 0
+/**
+ * Sets the brightness of the whole display straight away, stopping any fade.
+ *
+ * \param level [in]	0 (off) - DISPLAY_OE_LEVEL_MAX
+ */
+void display_set_fade(uint8_t level)
+{
+	irqflags_t flags = cpu_irq_save();
+	display_fade_level = level;
+	display_fade_target = level;
+	display_oe_update();
+	cpu_irq_restore(flags);
+}
+
+/**
+ * Fades the brightness of the whole display to a new level.
+ *
+ * \param level [in]	0 (off) - DISPLAY_OE_LEVEL_MAX
+ * \param step [in]		Levels to move per mS
+ */
+void display_fade_to(uint8_t level, uint8_t step)
+{
+	irqflags_t flags = cpu_irq_save();
+	display_fade_step = step ? step : 1;
+	display_fade_target = level;
+	cpu_irq_restore(flags);
+}
+
+/**
+ * \return True until the last fade has reached its level
+ */
+bool display_fading(void)
+{
+	return display_fade_level != display_fade_target;
+}
+#endif
+
+/**
+ * Returns the frame buffer the drawing functions should write to. With double
+ * buffering this is the back buffer, which is first brought up to date if the
+ * display has swapped since the last write. No swap happens until the write is
+ * finished with display_write_end().
+ */
+static display_planes_t *display_write_begin(void)
+{
+	#if DISPLAY_DOUBLE_BUFFER > 0
+	// Clearing ready first means the front can't change under us
+	display_back_ready = false;
+	uint8_t front = display_front;
+	if (display_back_stale) {
+		memcpy(display_frame_buffer[front ^ 1], display_frame_buffer[front], sizeof(display_planes_t));
+		display_back_stale = false;
+	}
+	return &display_frame_buffer[front ^ 1];
+	#else
+	return &display_frame_buffer[0];
+	#endif
+}
+
+/**
+ * Marks the back buffer as complete, it will be shown from the start of the
+ * next BCM cycle.
+ */
+static void display_write_end(void)
+{
+	#if DISPLAY_DOUBLE_BUFFER > 0
+	display_back_ready = true;
+	#endif
 }
 
 /**
@@ -220,7 +423,11 @@ void display_disable(void)
  */
 
 void clear_display_buffer(void){
-	memset(&display_frame_buffer, 0xFF, sizeof(display_frame_buffer));
+	// Through the back buffer, so the frame in use is only swapped for the
+	// cleared one at the end of a BCM cycle
+	display_planes_t *buffer = display_write_begin();
+	memset(buffer, 0xFF, sizeof(display_planes_t));
+	display_write_end();
 }
 
 
@@ -230,14 +437,21 @@ void clear_display_buffer(void){
  */
 
 volatile uint16_t animation_frames_remaining = 0;
+static volatile uint8_t overlay_ms_elapsed = 0;	// Milliseconds since the overlay animation last ran
 
 void display_animation_timer(void)
 {
 	tc_write_cc(&TCC0, TC_CCB, DISPLAY_ANIMATION_TIMER_PERIOD + tc_read_count(&TCC0));
-	
+
 	if (animation_frames_remaining > 0){
 		animation_frames_remaining--;
 	}
+	if (overlay_ms_elapsed < 0xFF) {
+		overlay_ms_elapsed++;
+	}
+	#if DISPLAY_OE_PWM > 0
+	display_fade_tick();
+	#endif
 	
 	// Idle timer (~1ms tick)
 	if (!sleep_mode_active) {
@@ -246,43 +460,202 @@ void display_animation_timer(void)
 }
 
 
-/** Interrupt callback function. This is triggered every 80 uS by overflow  
- *  of Timer0. This function latches the last frame into the output stage of
- *  of the 74HC595 registers then starts DMA transfer of the next frame and
- *	resets the DMA source address at the end of each display cycle.
+#if DISPLAY_ISR_PROFILE > 0
+volatile uint16_t display_isr_cycles_max[2];
+
+static uint16_t display_profile_count(void)
+{
+	// The count is read through the timer's shared TEMP register
+	irqflags_t flags = cpu_irq_save();
+	uint16_t count = tc_read_count(&DISPLAY_PROFILE_TIMER);
+	cpu_irq_restore(flags);
+	return count;
+}
+
+static void display_profile_end(uint8_t isr, uint16_t start)
+{
+	uint16_t cycles = display_profile_count() - start;
+	if (cycles > display_isr_cycles_max[isr]) {
+		display_isr_cycles_max[isr] = cycles;
+	}
+}
+
+#define DISPLAY_PROFILE_START()		uint16_t profile_start = display_profile_count()
+#define DISPLAY_PROFILE_END(isr)	display_profile_end(isr, profile_start)
+#else
+#define DISPLAY_PROFILE_START()
+#define DISPLAY_PROFILE_END(isr)
+#endif
+
+/** Interrupt callback function. This is triggered by compare A of Timer0
+ *  once per BCM slot. This function latches the last bit-plane into the output
+ *  stage of the 74HC595 registers, holds it for its bit weight, then starts
+ *  DMA transfer of the plane for the next slot.
 **/
 
 static void display_frame_timer(void)
 {
-	// Increment the timer compare value
-	tc_write_cc(&TCC0, TC_CCA, DISPLAY_FRAME_TIMER_PERIOD + tc_read_count(&TCC0));
+	DISPLAY_PROFILE_START();
+
+	// The next plane has not finished shifting out, keep the current plane on
+	// for one more timer count and try again rather than waiting in here
+	if (!display_plane_loaded) {
+		tc_write_cc(&TCC0, TC_CCA, 1 + tc_read_count(&TCC0));
+		DISPLAY_PROFILE_END(0);
+		return;
+	}
+
+	// Increment the timer compare value by the on-time of the latched plane
+	tc_write_cc(&TCC0, TC_CCA, DISPLAY_FRAME_TIMER_PERIOD*display_plane_units + tc_read_count(&TCC0));
 	// Latch last frame to display driver shift register Outputs
 	ioport_set_pin_level(DISPLAY_LATCH, 1);
 	// Leave display_latch low
 	ioport_set_pin_level(DISPLAY_LATCH, 0);
-	// Enable the DMA Channel to start the transaction
+
+	// Start shifting out the plane display_dma_done set up
+	display_plane_loaded = false;
 	dma_channel_enable(DMA_CHANNEL);
-	// Increment transaction counter
+
+	DISPLAY_PROFILE_END(0);
+}
+
+/** Interrupt callback function. This is triggered when the DMA has shifted a
+ *  plane into the 74HC595 registers, which stay unlatched until the next frame
+ *  interrupt. It sets the DMA up for the plane after and does the per slot
+ *  bookkeeping the frame interrupt used to do.
+**/
+
+static void display_dma_done(enum dma_channel_status status)
+{
+	(void)status;
+	DISPLAY_PROFILE_START();
+
+	// Move to the slot that was just loaded
 	display_frame_index += 1;
-	
-	// Check to see if we are at the end of the display buffer, then reset DMA 
-	// source address to the start of the display buffer 
-	if(display_frame_index >= (NUM_OF_FRAMES-1))
+	if(display_frame_index >= DISPLAY_BCM_SLOTS)
 	{
 		display_frame_index = 0;
-		//Wait for the last DMA transaction to complete.
-		while (dma_channel_is_busy(DMA_CHANNEL)){};
-		dma_channel_write_source(DMA_CHANNEL, (uint16_t)(uintptr_t)display_frame_buffer);								
 	}
-	
+
+	uint8_t units = bcm_slot_units[display_frame_index];
+	display_plane_units = units;
+
+	// Point the DMA at the plane for the slot after
+	uint8_t next_index = display_frame_index + 1;
+	if (next_index >= DISPLAY_BCM_SLOTS) {
+		next_index = 0;
+		#if DISPLAY_DOUBLE_BUFFER > 0
+		// Swap only between BCM cycles so every plane of a cycle comes from
+		// the same buffer
+		if (display_back_ready) {
+			display_front ^= 1;
+			display_back_ready = false;
+			display_back_stale = true;
+		}
+		#endif
+	}
+	dma_channel_write_source(DMA_CHANNEL, (uint16_t)(uintptr_t)display_frame_buffer[display_front][bcm_slot_plane[next_index]]);
+	display_plane_loaded = true;
+
 	if(!midi_clock_enabled) // !Summer2016Update midi_clock animations
 	{
-		tick += 1;
-		if(tick == 255){
+		// Counted in frame periods so animations run at the same speed as
+		// they did with one interrupt per frame
+		tick += units;
+		if(tick >= 255){
 			animation_counter +=1;
-			tick = 0;
+			tick -= 255;
 		}
 	}
+
+	DISPLAY_PROFILE_END(1);
+}
+
+/**
+ * Selects the gamma curve applied to all RGB colors.
+ *
+ * \param curve [in]	GAMMA_CURVE_LINEAR, GAMMA_CURVE_2_2 or GAMMA_CURVE_2_8,
+ *						anything else selects linear
+ */
+void display_set_gamma_curve(uint8_t curve)
+{
+	display_gamma_curve = (curve < GAMMA_CURVES) ? curve : GAMMA_CURVE_LINEAR;
+	#if DISPLAY_RGB_CACHE > 0
+	rgb_cache_clear();
+	#endif
+}
+
+/**
+ * Sets a ceiling on the brightness of every LED, applied after the brightness
+ * settings and animations.
+ *
+ * \param cap [in]	1 - 126 scales all LEDs by cap/128, 0 or 127+ is no cap
+ */
+void display_set_brightness_cap(uint8_t cap)
+{
+	display_brightness_cap = (cap && cap < DISPLAY_BRIGHTNESS_CAP_OFF) ? cap : DISPLAY_BRIGHTNESS_CAP_OFF;
+	#if DISPLAY_RGB_CACHE > 0
+	rgb_cache_clear();
+	#endif
+
+	#if DISPLAY_OE_PWM > 0
+	irqflags_t flags = cpu_irq_save();
+	display_oe_cap = (display_brightness_cap == DISPLAY_BRIGHTNESS_CAP_OFF) ?
+					 DISPLAY_OE_LEVEL_MAX : display_brightness_cap << 1;
+	display_oe_update();
+	cpu_irq_restore(flags);
+	#endif
+}
+
+/**
+ * Applies the brightness cap to a bit-plane level.
+ */
+static inline uint8_t brightness_capped(uint8_t value)
+{
+	#if DISPLAY_OE_PWM > 0
+	// The /OE PWM caps the whole display instead
+	return value;
+	#else
+	if (display_brightness_cap == DISPLAY_BRIGHTNESS_CAP_OFF) {
+		return value;
+	}
+	return (uint8_t)(((uint16_t)value * display_brightness_cap) >> 7);
+	#endif
+}
+
+/**
+ * Converts a brightness in PWM steps into a bit-plane level.
+ *
+ * \param steps [in]	Brightness in steps of DISPLAY_PWM_STEPS, larger values are full on
+ *
+ * \return Level 0 - DISPLAY_BCM_LEVEL_MAX
+ */
+static uint8_t bcm_level(uint8_t steps)
+{
+	if (steps >= DISPLAY_PWM_STEPS) {
+		return brightness_capped(DISPLAY_BCM_LEVEL_MAX);
+	}
+	return brightness_capped(pgm_read_byte(&step_level_table[steps]));
+}
+
+/**
+ * Converts an 8 bit color channel into a bit-plane level through one of the
+ * color level tables (COLOR_LEVEL_PLAIN or a white balanced channel).
+ */
+static uint8_t bcm_color_level(uint8_t table, uint8_t color)
+{
+	return brightness_capped(pgm_read_byte(&color_level_tables[table][color]));
+}
+
+/**
+ * Scales an indicator brightness (0 - 127) by a brightness setting, where 127
+ * is full. Exact value * brightness / 127 without a divide, valid for any
+ * value up to 127 and brightness up to 255.
+ */
+static inline uint8_t scale_brightness(uint8_t value, uint8_t brightness)
+{
+	uint16_t n = (uint16_t)value * brightness + 1;
+	return (uint8_t)((n + (n >> 7) + (n >> 14)) >> 7);
 }
 
 /**
@@ -304,7 +677,7 @@ void set_encoder_indicator_level(uint8_t encoder, uint8_t position,
 								 uint8_t detent_color, uint8_t brightness)
 {
 	// Do nothing if position is invalid
-	if (position > 127 || position < 0) {
+	if (position > 127) {
 		return;
 	}
 	
@@ -313,40 +686,40 @@ void set_encoder_indicator_level(uint8_t encoder, uint8_t position,
 	
 	if (build_indicator_pattern(&bit_masks, position, type, has_detent, detent_color)){
 		
-		float brightness_coeff = brightness/127.0f;
-		
-		bit_masks.pattern_A_brightness = (uint8_t)(bit_masks.pattern_A_brightness * brightness_coeff);
-		bit_masks.pattern_B_brightness = (uint8_t)(bit_masks.pattern_B_brightness * brightness_coeff);
-		
-		uint8_t mask_A_upper_byte = (uint8_t)(((bit_masks.pattern_A) >> 8) & 0x00FF);
-		uint8_t mask_A_lower_byte = (uint8_t)(((bit_masks.pattern_A)     ) & 0x00E3);
-		uint8_t mask_B_upper_byte = (uint8_t)(((bit_masks.pattern_B) >> 8) & 0x00FF);
-		uint8_t mask_B_lower_byte = (uint8_t)(((bit_masks.pattern_B)     ) & 0x00E3);
-		
-		uint8_t *ptr = display_frame_buffer;
+		bit_masks.pattern_A_brightness = scale_brightness(bit_masks.pattern_A_brightness, brightness);
+		bit_masks.pattern_B_brightness = scale_brightness(bit_masks.pattern_B_brightness, brightness);
 		
+		// LEDs lit by both patterns take the brighter of the two levels
+		uint16_t mask_A_only = bit_masks.pattern_A & ~bit_masks.pattern_B;
+		uint16_t mask_B_only = bit_masks.pattern_B & ~bit_masks.pattern_A;
+		uint16_t mask_AB     = bit_masks.pattern_A & bit_masks.pattern_B;
+
+		uint8_t level_A  = bcm_level(bit_masks.pattern_A_brightness);
+		uint8_t level_B  = bcm_level(bit_masks.pattern_B_brightness);
+		uint8_t level_AB = (level_A > level_B) ? level_A : level_B;
+
 		// Calculate initial buffer address offset for this encoder
-		ptr += ((15-encoder)*2);
-		
-		for (uint8_t i=0;i<NUM_OF_FRAMES;++i)  // NUM_OF_FRAMES = 96 (Midi Fighter Twister)
+		uint8_t offset = ((15-encoder)*2);
+		display_planes_t *buffer = display_write_begin();
+
+		for (uint8_t plane=0;plane<DISPLAY_BIT_PLANES;++plane)
 		{
-			// Clear old data
-			ptr[0] |= 0xE3;
-			ptr[1]  = 0xFF;
-
-			// Write Mask A
-			if ((i*(127/NUM_OF_FRAMES)) < bit_masks.pattern_A_brightness) {
-				ptr[0] &= ~mask_A_lower_byte;
-				ptr[1] &= ~mask_A_upper_byte;
-			}
-			// Write Mask B
-			if ((i*(127/NUM_OF_FRAMES)) < bit_masks.pattern_B_brightness) {
-				ptr[0] &= ~mask_B_lower_byte;
-				ptr[1] &= ~mask_B_upper_byte;
-			}
-			// Jump to next frame
-			ptr += 32;
+			uint8_t *ptr = &(*buffer)[plane][offset];
+			uint16_t on_mask = 0;
+
+			if (level_A & 0x01)  on_mask |= mask_A_only;
+			if (level_B & 0x01)  on_mask |= mask_B_only;
+			if (level_AB & 0x01) on_mask |= mask_AB;
+
+			// Clear old data and write the LEDs which are on in this plane
+			ptr[0] = (ptr[0] | 0xE3) & ~((uint8_t)on_mask & 0xE3);
+			ptr[1] = ~(uint8_t)(on_mask >> 8);
+
+			level_A >>= 1;
+			level_B >>= 1;
+			level_AB >>= 1;
 		}
+		display_write_end();
 		
 		} else {
 		// Building the display failed so return
@@ -354,217 +727,27 @@ void set_encoder_indicator_level(uint8_t encoder, uint8_t position,
 	}
 }
 
-/** 
- * Takes a variety of indicator display settings as input and builds two 16 
- * bit masks with individual brightness settings as output. These masks set the 
- * brightness of the 11 white LEDs and the Red Blue de-tent Indicator color
- * given for the given display type and de tent settings.
- *
- * Inputs: 
- * result:      A pointer to an inidcator_bit_frame struct to store the result
- * position:	The 7bit encoder indicator position (0 - 127)
- * type:		The type of display to build
- * has_detent	If the encoder uses a virtual de tent
- * detent_color The de tent indicator color setting for the indicator
- *
- * Output:		1 if valid result
-**/ 
- 
-int build_indicator_pattern(indicator_bit_mask_t *result, 
-							uint8_t position, 
-							uint16_t type, 
-							bool has_detent, 
-							uint8_t detent_color)
-	{
-	int8_t		dot_count;
-	uint32_t	bit_mask;
-	int8_t		frac;
-	bool		is_blended = false;
-	bool        is_bar_display     = false;
-	bool		is_spread = false;
-
-	float       remainder = 0;
-	
-	if (type == BLENDED_BAR){// || type == BLENDED_DOT) {
-		is_blended = true;
-	}
-	if (type ==  BAR || type == BLENDED_BAR) {
-		is_bar_display = true;
-	}
-	
-	if (type == SPREAD_BAR) {
-		is_blended = true;
-		is_spread = true;
-	}
-	
-	if (is_spread) {
-		if (position <= 0) {
-			result->pattern_A = 0;
-			result->pattern_A_brightness = 0;
-			result->pattern_B = 0;
-			result->pattern_B_brightness = 0;
-			return 1;
-		}
-		bit_mask = 0x0400;
-		float spread_f = ((position - 1) * 5.0f) / 126.0f;
-		uint8_t spread = (uint8_t)spread_f;
-		float frac_f = spread_f - spread;
-		uint8_t blend = (uint8_t)(frac_f * 127);
-
-		for (int8_t i = 0; i < spread; i++) {
-			bit_mask |= (bit_mask >> 1) | (bit_mask << 1);
-		}
-
-		if (blend > 0 && spread < 5) {
-			uint32_t edge_mask = (bit_mask | (bit_mask >> 1) | (bit_mask << 1)) & ~bit_mask;
-			result->pattern_A = (uint16_t)(bit_mask | edge_mask);
-			result->pattern_A_brightness = blend;
-			result->pattern_B = (uint16_t)(bit_mask);
-			result->pattern_B_brightness = 127 - blend;
-			} else {
-			result->pattern_A = 0;
-			result->pattern_A_brightness = 0;
-			result->pattern_B = (uint16_t)(bit_mask);
-			result->pattern_B_brightness = 127;
-		}
-		return 1;
-	}
-	if (has_detent) {	
-		// 
-		if (position == 63 || position == 64 ) {
-			// The encoder is in its detent position, set the detent indicator
-			// to its color and return.
-			result->pattern_A = 0x0001;  // detent color 1 flag 
-			result->pattern_B = 0x0002;  // detent color 2 flag
-			result->pattern_A_brightness = (uint8_t)(detent_color);
-			result->pattern_B_brightness = (uint8_t)(0x7F - (detent_color));
-			return 1;
-		} else {
-			bit_mask = 0x0400;
-			if(is_blended) {
-				dot_count = (int8_t)((position - 63) / 12.7f);
-				remainder = fmodf(position - 63, 12.7f);        
-				frac =  (uint8_t)fabs((remainder * 10));
-			} else {
-				uint8_t center_point = (position > 63) ? 63 : 64;
-				dot_count = (int8_t)((position - center_point) / 15.9f);
-				remainder = fmodf(position - center_point, 15.9f);        
-				frac =  (uint8_t)fabs((remainder * 8));
-				//Not blended detent display does not use 12 o clock white LED
-				if (remainder < 0){
-					dot_count -= 1;
-				} else {
-					dot_count +=1;
-				}
-			}	
-		} 
-	} else {
-		if (is_blended) {
-			dot_count = (int8_t)(position / 11.5f);	
-			remainder = fmodf(position, 11.5f);         
-			frac =  (uint8_t)(remainder * 11);
-			bit_mask = 0x10000;
-		}
-		else {
-			dot_count = (int8_t)(position / 11.65f);
-			bit_mask = 0x8000;
-			frac = 0;
-		}
-		
-		if (position == 0) {
-			bit_mask = 0;
-		}
-		
-	}
-	
-	if (is_bar_display) {
-	// Build a bar bit mask	
-		int8_t count = dot_count;
-		if (dot_count >= 0) {
-			while (count) {
-				bit_mask |= bit_mask >> 1;
-				count--;
-			}
-		} else if (dot_count < 0) {
-			while (count) {
-				bit_mask |= bit_mask << 1;
-				count++;
-			}
-		}
-	} else {
-	// Build a dot bit mask	
-		if (dot_count >= 0) {
-			bit_mask = bit_mask >> dot_count;
-		} else if (dot_count < 0) {
-			bit_mask = bit_mask << dot_count*-1;
-		}
-	}
-	
-	// Store the bit masks and set their respective brightness levels
-	result->pattern_B = (uint16_t)(bit_mask);
-	
-	if ((remainder > 0) && is_blended) {
-		result->pattern_A = (uint16_t)(bit_mask | (bit_mask >> 1));
-		result->pattern_A_brightness = frac;
-		result->pattern_B_brightness = 127 - frac;
-			
-	} else if ((remainder < 0) && is_blended) {
-		result->pattern_A = (uint16_t)(bit_mask | (bit_mask << 1));
-		result->pattern_A_brightness = frac;
-		result->pattern_B_brightness = 127 - frac;
-	}
-	else
-	{
-		result->pattern_A = 0;
-		result->pattern_A_brightness = 0;
-	}
-	result->pattern_B_brightness = 127;
-	return 1;	
-}
-
-// Per-channel white balance gains (0..255, where 255 = 1.0x)
-#define GAIN_R 140
-#define GAIN_G 245
-#define GAIN_B 235
-
-static inline uint8_t scale8(uint8_t v, uint8_t s)
-{
-	return (uint8_t)(((uint16_t)v * (uint16_t)s) / 255u);
-}
-
-/** Builds RGB color bit patterns in the display frame buffer
- *  Inputs:
- *  encoder	- which encoder to set RGB color for
- *	color	- 32 bit color value containing 8 bit RGB information
- *  level   - if not 0 scales the color brightness between 1 - 255 
-**/
 
-void build_rgb(uint8_t encoder, uint32_t color, uint8_t level)
+/**
+ * Applies the fixed per-channel curves (red x^5.0, green x^2.5) the sparkle and
+ * rainbow animations were designed with.
+ */
+uint32_t legacy_gamma(uint32_t color)
 {
-	#if 0
-	float red_pow = 5.0;
-	float green_pow = 2.50f;
-	float blue_pow = 1.0f;
-
-	uint8_t red_byte = (uint8_t)((color >> 16) & 0xFF);
-	red_byte = 255 * pow( (((float)red_byte)/255.0f) , (red_pow));
-
-	uint8_t green_byte = (uint8_t)((color >> 8) & 0xFF);
-	green_byte = 255 * pow( (((float)green_byte)/255.0f) , (green_pow));
+	uint8_t red_byte = pgm_read_byte(&gamma_tables[GAMMA_TABLE_LEGACY_RED][(uint8_t)(color >> 16)]);
+	uint8_t green_byte = pgm_read_byte(&gamma_tables[GAMMA_TABLE_LEGACY_GREEN][(uint8_t)(color >> 8)]);
+	return ((uint32_t)red_byte << 16) | ((uint16_t)green_byte << 8) | (uint8_t)color;
+}
 
-	uint8_t blue_byte =  (uint8_t)(color & 0xFF);
-	blue_byte = 255 * pow( (((float)blue_byte)/255.0f) , (blue_pow));
-	#else
+/**
+ * Works out the bit-plane level of each channel of a color, see build_rgb()
+ */
+static void rgb_levels(uint32_t color, uint8_t level, uint8_t *red_level, uint8_t *green_level,
+					   uint8_t *blue_level)
+{
 	uint8_t red_byte = (uint8_t)((color >> 16) & 0xFF);
 	uint8_t green_byte = (uint8_t)((color >> 8) & 0xFF);
 	uint8_t blue_byte =  (uint8_t)(color & 0xFF);
-	#endif
-
-	if (activeColorMap == colorMap64) {
-		red_byte   = scale8(red_byte,   GAIN_R);
-		green_byte = scale8(green_byte, GAIN_G);
-		blue_byte  = scale8(blue_byte,  GAIN_B);
-	}
 
 	if (level) {
 		red_byte   = (red_byte   * (level-1)) >> 8;
@@ -572,21 +755,65 @@ void build_rgb(uint8_t encoder, uint32_t color, uint8_t level)
 		blue_byte  = (blue_byte  * (level-1)) >> 8;
 	}
 
-	uint8_t *ptr = display_frame_buffer;
-	ptr += ((15-encoder)*2);
+	if (display_gamma_curve != GAMMA_CURVE_LINEAR) {
+		const uint8_t *gamma = gamma_tables[display_gamma_curve - 1];
+		red_byte   = pgm_read_byte(&gamma[red_byte]);
+		green_byte = pgm_read_byte(&gamma[green_byte]);
+		blue_byte  = pgm_read_byte(&gamma[blue_byte]);
+	}
 
-	for (uint8_t i=0;i<NUM_OF_FRAMES;++i)
+	// Only the 2026 color map is white balanced
+	if (activeColorMap == colorMap64) {
+		*blue_level  = bcm_color_level(COLOR_LEVEL_BLUE, blue_byte);
+		*red_level   = bcm_color_level(COLOR_LEVEL_RED, red_byte);
+		*green_level = bcm_color_level(COLOR_LEVEL_GREEN, green_byte);
+	} else {
+		*blue_level  = bcm_color_level(COLOR_LEVEL_PLAIN, blue_byte);
+		*red_level   = bcm_color_level(COLOR_LEVEL_PLAIN, red_byte);
+		*green_level = bcm_color_level(COLOR_LEVEL_PLAIN, green_byte);
+	}
+}
+
+/**
+ * Writes the bit-plane levels of an encoder's RGB segment into the frame buffer
+ */
+static void draw_rgb_levels(uint8_t encoder, uint8_t red_level, uint8_t green_level, uint8_t blue_level)
+{
+	uint8_t offset = ((15-encoder)*2);
+	display_planes_t *buffer = display_write_begin();
+
+	for (uint8_t plane=0;plane<DISPLAY_BIT_PLANES;++plane)
 	{
+		uint8_t *ptr = &(*buffer)[plane][offset];
 		*ptr |= 0x1C;
-		uint8_t value = (i << 1)*(127/NUM_OF_FRAMES);
 
-		if (blue_byte > value)  *ptr &= (uint8_t)~0x04;
-		if (red_byte > value)   *ptr &= (uint8_t)~0x08;
-		if (green_byte > value) *ptr &= (uint8_t)~0x10;
+		if (blue_level & 0x01)  *ptr &= (uint8_t)~0x04;
+		if (red_level & 0x01)   *ptr &= (uint8_t)~0x08;
+		if (green_level & 0x01) *ptr &= (uint8_t)~0x10;
 
-		ptr += 32;
+		blue_level >>= 1;
+		red_level >>= 1;
+		green_level >>= 1;
 	}
-}
+	display_write_end();
+}
+
+/** Builds RGB color bit patterns in the display frame buffer
+ *  Inputs:
+ *  encoder	- which encoder to set RGB color for
+ *	color	- 32 bit color value containing 8 bit RGB information
+ *  level   - if not 0 scales the color brightness between 1 - 255
+ *
+ *  Each channel goes level -> gamma curve -> white balance -> bit-plane level,
+ *  the last three through the color tables.
+**/
+
+void build_rgb(uint8_t encoder, uint32_t color, uint8_t level)
+{
+	uint8_t red_level, green_level, blue_level;
+	rgb_levels(color, level, &red_level, &green_level, &blue_level);
+	draw_rgb_levels(encoder, red_level, green_level, blue_level);
+}
 
 /**
  * Draws the supplied bit pattern on the 11 white LEDs for a given encoder
@@ -612,28 +839,28 @@ void set_indicator_pattern(uint8_t encoder, uint16_t pattern)
 void set_indicator_pattern_level(uint8_t encoder, uint16_t pattern, uint8_t brightness)
 {
 	// Calculate initial byte offset in frame buffer
-	uint8_t *ptr = display_frame_buffer;
-	
-	ptr += ((15-encoder)*2);
-	
+	uint8_t offset = ((15-encoder)*2);
+
 	uint8_t pattern_uper_byte = (uint8_t)(pattern >> 8);
 	uint8_t pattern_lower_byte = (uint8_t)(pattern & 0xFF);
-	
-	// Iterate through and build the bit patterns for the 128 frames
-	for (uint8_t i=0;i<NUM_OF_FRAMES;++i)
+	uint8_t level = bcm_level(brightness);
+	display_planes_t *buffer = display_write_begin();
+
+	// Iterate through and build the bit patterns for the bit-planes
+	for (uint8_t plane=0;plane<DISPLAY_BIT_PLANES;++plane)
 	{
+		uint8_t *ptr = &(*buffer)[plane][offset];
 		// Turn off All LEDs
 		ptr[0] |= 0xE3; // E3: ensure the bits are set to turn off the detent indicators (0x03)
 		ptr[1] |= 0xFF;
-		// Turn on LEDs 
-		if(i < brightness){
+		// Turn on LEDs
+		if(level & 0x01){
 			ptr[0] &= ~(0xE0 & pattern_lower_byte);
 			ptr[1]  = (0xFF & ~pattern_uper_byte);
-			// Esure the 
 		}
-		// Move to next pointer
-		ptr += 32;
+		level >>= 1;
 	}
+	display_write_end();
 }
 
 
@@ -658,8 +885,30 @@ void set_encoder_rgb(uint8_t encoder, uint8_t color)
 void set_encoder_rgb_level(uint8_t encoder, uint8_t color, uint8_t brightness)
 {
 	rgb_color_setting[encoder] = color;
+	#if DISPLAY_RGB_CACHE > 0
+	// The color maps have 128 entries
+	color &= 0x7F;
+	if (rgb_cache_color_map != activeColorMap) {
+		rgb_cache_clear();
+		rgb_cache_color_map = activeColorMap;
+	}
+
+	uint16_t key = RGB_CACHE_VALID | ((uint16_t)color << 8) | brightness;
+	rgb_cache_entry_t *entry = &rgb_cache[(color ^ (color >> 4) ^ brightness ^ (brightness >> 4)) &
+										  (DISPLAY_RGB_CACHE_SIZE - 1)];
+	if (entry->key == key) {
+		display_rgb_cache_hits++;
+	} else {
+		display_rgb_cache_misses++;
+		uint32_t rgb_color = pgm_read_dword(&activeColorMap[color][0]);
+		rgb_levels(rgb_color, brightness, &entry->red_level, &entry->green_level, &entry->blue_level);
+		entry->key = key;
+	}
+	draw_rgb_levels(encoder, entry->red_level, entry->green_level, entry->blue_level);
+	#else
 	uint32_t rgb_color = pgm_read_dword(&activeColorMap[rgb_color_setting[encoder]][0]);
 	build_rgb(encoder, rgb_color, brightness);
+	#endif
 }
 
 /** Sets Indent Red Blue led for a given encoder
@@ -672,26 +921,28 @@ void set_encoder_indent(uint8_t encoder, uint8_t color_index)
 	uint8_t red_byte = (uint8_t)(0xFF - (color_index*2));
 	uint8_t blue_byte =  (uint8_t)((color_index*2) - 0xFF);
 	
-	uint8_t *ptr = display_frame_buffer;
-	
+	uint8_t blue_level = bcm_color_level(COLOR_LEVEL_PLAIN, blue_byte);
+	uint8_t red_level  = bcm_color_level(COLOR_LEVEL_PLAIN, red_byte);
+
 	// Calculate initial byte offset
-	ptr += ((15-encoder)*2);
-	
-	for (uint8_t i=0;i<NUM_OF_FRAMES;++i)
+	uint8_t offset = ((15-encoder)*2);
+	display_planes_t *buffer = display_write_begin();
+
+	for (uint8_t plane=0;plane<DISPLAY_BIT_PLANES;++plane)
 	{
+		uint8_t *ptr = &(*buffer)[plane][offset];
 		// Set RGB bits to "OFF" first
-		*ptr |= 0x03;		
-		// Covert to 8 Bit space
-		//uint8_t value = i << 1;
-		uint8_t value = (i << 1)*(127/NUM_OF_FRAMES);
-		if (blue_byte > value){
-			*ptr &= ~0x01; 
+		*ptr |= 0x03;
+		if (blue_level & 0x01){
+			*ptr &= ~0x01;
 		}
-		if (red_byte > value){
+		if (red_level & 0x01){
 			*ptr &= ~0x02;
 		}
-		ptr += 32;
+		blue_level >>= 1;
+		red_level >>= 1;
 	}
+	display_write_end();
 }
 
 /** Builds various MIDI controlled animations for the RGB segments
@@ -701,6 +952,8 @@ void set_encoder_indent(uint8_t encoder, uint8_t color_index)
  */
 void run_encoder_animation(uint8_t encoder, uint8_t bank, uint8_t animation, uint8_t color)
 {
+	(void)color;
+
 	// 0 is not a valid animation setting
 	if (!animation) {
 		return;
@@ -708,28 +961,26 @@ void run_encoder_animation(uint8_t encoder, uint8_t bank, uint8_t animation, uin
 	
 	if ((animation > 0) && (animation < 9)) {
 		
-		// RGB Strobe Animation
+		// RGB Strobe Animation, the colors and levels are drawn through the
+		// RGB color cache
 		if (!strobe_animation(animation)) {
-			build_rgb(encoder, 0, false);
+			draw_rgb_levels(encoder, 0, 0, 0);
 		} else {
-			uint32_t color = pgm_read_dword(&activeColorMap[rgb_color_setting[encoder]][0]);
-			build_rgb(encoder, color, false);
+			set_encoder_rgb_level(encoder, rgb_color_setting[encoder], 0);
 		}
 		
 	} else if ((animation > 8) && (animation < 17)) {
 		
 		// RGB Pulse Animation
 		uint8_t level = pulse_animation(animation - 8);
-		uint32_t color = pgm_read_dword(&activeColorMap[rgb_color_setting[encoder]][0]);
-		build_rgb(encoder, color, (uint8_t)(level));	
+		set_encoder_rgb_level(encoder, rgb_color_setting[encoder], level);
 			
 	} else if ((animation > 16) && (animation < 49)) {	
 		
 		// RGB Dimming	
-		uint32_t color = pgm_read_dword(&activeColorMap[rgb_color_setting[encoder]][0]);
 		// Replace with a look up table used for ALL DIMING
 		uint8_t level = pgm_read_byte(&animationBrightnessMap[animation-17]);
-		build_rgb(encoder, color, (uint8_t)(level*2));
+		set_encoder_rgb_level(encoder, rgb_color_setting[encoder], (uint8_t)(level*2));
 		
 	} else if ((animation > 48) && (animation < 57)) {
 		// Read Directly from RAM		
@@ -784,32 +1035,20 @@ void run_encoder_animation(uint8_t encoder, uint8_t bank, uint8_t animation, uin
 	
 	} else if (animation == 127) {
 		
-		// Rainbow state
-		const float rgb_freq = .049f;
-		uint8_t rgb_step =(uint8_t)(animation_counter);
-		
-		uint32_t red_level = (uint8_t)(sin(rgb_step*rgb_freq)*126)+128;
-		rgb_step += 85;
-		uint32_t green_level = (uint8_t)(sin(rgb_step*rgb_freq)*126)+128;
-		rgb_step += 85;
-		uint32_t blue_level = (uint8_t)(sin(rgb_step*rgb_freq)*126)+128;
-		
+		// Rainbow state, two cycles of each color per 256 animation steps with
+		// the colors spaced by 85 steps
+		uint16_t rgb_phase = animation_phase << 1;
 
-		uint32_t color = (uint32_t)(red_level << 16) + (green_level << 8) + (blue_level);
+		uint32_t red_level = OSC_UNIPOLAR(osc_wave(OSC_SINE, rgb_phase));
+		rgb_phase += 85 << 9;
+		uint32_t green_level = OSC_UNIPOLAR(osc_wave(OSC_SINE, rgb_phase));
+		rgb_phase += 85 << 9;
+		uint32_t blue_level = OSC_UNIPOLAR(osc_wave(OSC_SINE, rgb_phase));
 
-		// build_rgb no longer does this for us.
-		// XXX this is ugly because I don't want to touch the above code.
-		//     the incorrect use of the uint8_t cast invokes weird behavior,
-		//     and "fixing" it makes the rainbow look very different
-		//     -rfm
-
-		uint32_t adjusted_red = 255 * pow( (((float)((color >> 16) & 0xFF))/255.0f) , 5.0);
-		uint32_t adjusted_green = 255 * pow( (((float)((color >> 8) & 0xFF))/255.0f) , 2.5);
-		uint32_t adjusted_blue = color & 0xFF;
-
-		color = (adjusted_red << 16) | (adjusted_green << 8) | adjusted_blue;
+		uint32_t color = (red_level << 16) | (green_level << 8) | (blue_level);
 
-		build_rgb(encoder, color, 0);
+		// build_rgb no longer does this for us.
+		build_rgb(encoder, legacy_gamma(color), 0);
 	}
 	
 }
@@ -822,7 +1061,7 @@ void run_encoder_animation(uint8_t encoder, uint8_t bank, uint8_t animation, uin
  */
 bool strobe_animation(uint8_t flash_rate)
 {
-	if (animation_counter & (0x01<<(8-flash_rate))) {
+	if (animation_phase & (0x0100<<(8-flash_rate))) {
 		return true;
 	}
 	else {
@@ -830,22 +1069,18 @@ bool strobe_animation(uint8_t flash_rate)
 	}
 }
 
-/** Returns an amplitude value for 8 different pulse rates
- *  Inputs:
- *  Pulse_rate	- which pulse rate we are generating amplitude for
- *  Output		- amplitude of the specified rate at this point in time
- *
- *  NOTE:		- Having trouble linking? Make sure you are linking libm.a
- *                This is not linked by default in some versions of ASF
- */ 
+/** Returns an amplitude value for 8 different pulse rates
+ *  Inputs:
+ *  Pulse_rate	- which pulse rate we are generating amplitude for
+ *  Output		- amplitude of the specified rate at this point in time
+ */
 uint8_t pulse_animation(uint8_t pulse_rate)
 {
-	const float rgb_freq = .04927f;
-	uint8_t phase = (uint8_t)(animation_counter - pulse_anim_origin);
-	uint8_t rgb_step = (uint8_t)(((phase<<5)>>(8-pulse_rate)) & 0xFF);
-	uint8_t level = (uint8_t)(sin(rgb_step*rgb_freq)*126)+128;
-	return level;
-}
+	uint16_t phase = animation_phase - pulse_anim_origin;
+	uint16_t rgb_step = (uint16_t)(((uint32_t)phase<<5)>>(8-pulse_rate));
+	// Two pulses per 256 steps, rgb_step keeps the fraction of the step
+	return OSC_UNIPOLAR(osc_wave(OSC_SINE, rgb_step << 1));
+}
 
 /**
  * A basic settings received animation
@@ -934,61 +1169,150 @@ uint8_t pulse_animation(uint8_t pulse_rate)
 	//}
 //}
 
+// Overlay animations, these take over the display from the encoders until
+// they finish and are advanced from the main loop by display_overlay_tick()
+typedef enum {
+	OVERLAY_NONE,
+	OVERLAY_CONFIRMATION,
+	OVERLAY_SPARKLE,
+	OVERLAY_DEMO,
+} display_overlay_t;
+
+#define CONFIRMATION_STEPS	224		// mS
+#define DEMO_STEP_TIME		150		// mS
+
+static uint8_t display_overlay = OVERLAY_NONE;
+static uint16_t overlay_step;
+static uint32_t confirmation_color;
+
+static bool confirmation_frame(uint8_t elapsed_ms);
+static bool sparkle_frame(uint8_t elapsed_ms);
+static bool build_sparkles(void);
+static bool demo_frame(uint8_t elapsed_ms);
+
+/**
+ * Advances the running overlay animation (confirmation, sparkle or demo) by the
+ * time since it last ran. When the animation finishes the encoder display is
+ * rebuilt.
+ *
+ * \return True while an overlay animation owns the display
+ */
+bool display_overlay_tick(void)
+{
+	if (display_overlay == OVERLAY_NONE) {
+		return false;
+	}
+
+	irqflags_t flags = cpu_irq_save();
+	uint8_t elapsed_ms = overlay_ms_elapsed;
+	overlay_ms_elapsed = 0;
+	cpu_irq_restore(flags);
+
+	if (!elapsed_ms) {
+		return true;
+	}
+
+	bool running;
+	switch (display_overlay) {
+		case OVERLAY_CONFIRMATION:
+		running = confirmation_frame(elapsed_ms);
+		break;
+		case OVERLAY_SPARKLE:
+		running = sparkle_frame(elapsed_ms);
+		break;
+		case OVERLAY_DEMO:
+		running = demo_frame(elapsed_ms);
+		break;
+		default:
+		running = false;
+		break;
+	}
+
+	if (!running) {
+		display_overlay = OVERLAY_NONE;
+		refresh_display();
+	}
+	return running;
+}
+
+/**
+ * Runs the overlay animation to completion, for use only where the main loop
+ * will not run again (e.g. before a reset).
+ */
+void display_overlay_finish(void)
+{
+	while (display_overlay_tick()) {}
+}
+
+static uint8_t confirmation_level(int16_t step)
+{
+	if (step < 0 || step > 127) {
+		return 1;
+	}
+	return (uint8_t)(1 + 2 * osc_wave(OSC_SINE, (uint16_t)step * (OSC_PHASE_CYCLE / 2 / 127)));
+}
+
+/**
+ * Starts the settings received animation, it is drawn by display_overlay_tick()
+ * over the next 224 mS.
+ *
+ * \param color [in]	24 bit RGB color of the animation
+ */
 void setting_confirmation_animation(uint32_t color)
 {
 	clear_display_buffer();
 	PMIC.CTRL |= PMIC_LOLVLEN_bm;
 	display_enable();
 
-	double freq = (3.14159 / 127);
-
-	int16_t step1 = 0;
-	int16_t step2 = -32;
-	int16_t step3 = -64;
-	int16_t step4 = -96;
-
-	uint8_t level1, level2, level3, level4;
-
-	for (uint16_t j = 0; j < 224; ++j) {
-
-		level1 = (step1 > -1 && step1 < 128) ? (uint8_t)(255 * sin(step1 * freq)) + 1 : 1;
-		level2 = (step2 > -1 && step2 < 128) ? (uint8_t)(255 * sin(step2 * freq)) + 1 : 1;
-		level3 = (step3 > -1 && step3 < 128) ? (uint8_t)(255 * sin(step3 * freq)) + 1 : 1;
-		level4 = (step4 > -1 && step4 < 128) ? (uint8_t)(255 * sin(step4 * freq)) + 1 : 1;
+	confirmation_color = color;
+	overlay_step = 0;
+	overlay_ms_elapsed = 1;	// Draw the first frame straight away
+	display_overlay = OVERLAY_CONFIRMATION;
+}
 
-		for (uint8_t e = 0; e < 4; ++e) {
-			build_rgb(e, color, level1);
-			build_rgb(e + 4, color, level2);
-			build_rgb(e + 8, color, level3);
-			build_rgb(e + 12, color, level4);
+// Draws the confirmation animation, one step per mS
+static bool confirmation_frame(uint8_t elapsed_ms)
+{
+	overlay_step += elapsed_ms;
+	if (overlay_step > CONFIRMATION_STEPS) {
+		return false;
+	}
 
-			set_indicator_pattern_level(e, 0xFFE0, level1 >> 1);
-			set_indicator_pattern_level(e + 4, 0xFFE0, level2 >> 1);
-			set_indicator_pattern_level(e + 8, 0xFFE0, level3 >> 1);
-			set_indicator_pattern_level(e + 12, 0xFFE0, level4 >> 1);
-		}
+	// Each row fades up and back down over half a sine cycle (128 steps),
+	// starting 32 steps after the row above
+	int16_t step = (int16_t)overlay_step - 1;
+	uint8_t level1 = confirmation_level(step);
+	uint8_t level2 = confirmation_level(step - 32);
+	uint8_t level3 = confirmation_level(step - 64);
+	uint8_t level4 = confirmation_level(step - 96);
 
-		step1++;
-		step2++;
-		step3++;
-		step4++;
+	for (uint8_t e = 0; e < 4; ++e) {
+		build_rgb(e, confirmation_color, level1);
+		build_rgb(e + 4, confirmation_color, level2);
+		build_rgb(e + 8, confirmation_color, level3);
+		build_rgb(e + 12, confirmation_color, level4);
 
-		Delay_MS(1);
+		set_indicator_pattern_level(e, 0xFFE0, level1 >> 1);
+		set_indicator_pattern_level(e + 4, 0xFFE0, level2 >> 1);
+		set_indicator_pattern_level(e + 8, 0xFFE0, level3 >> 1);
+		set_indicator_pattern_level(e + 12, 0xFFE0, level4 >> 1);
 	}
+	return true;
 }
 
 
 
 /**
- * Runs the 'Sparkle' start up routine
- * 
+ * Starts the 'Sparkle' start up routine, it is drawn by display_overlay_tick()
+ * until the last sparkle has faded.
+ *
  * \param count [in]	The number of sparkles
- * 
- * \return 
  */
 
 static uint8_t sparkle_count = 0;
 static uint8_t sparkle_intensity[16];
+static uint8_t prev_sparkle_intensity[16];
+static uint8_t sparkle_wait_ms;		// Time until the next sparkle
 
 // Sparkle Start and End colors in RGB format
 static uint8_t sparkle_start_color[3] = {0x00,0x00,0xFF};
@@ -997,86 +1321,99 @@ static uint8_t sparkle_end_color[3]	= {0xFE,0x00,0xD3};
 void run_sparkle(uint8_t count)
 {
 	sparkle_count = count;
-	
-	uint8_t prev_sparkle_intensity[16];
-	
+
 	for(uint8_t i=0;i<16;++i){
 		sparkle_intensity[i] = 0;
 		prev_sparkle_intensity[i] = 0;
 	}
-	
+
 	// Initialize some LEDs as on
 	sparkle_intensity[random16() & 0xf] = 0xff;
-	
-	animation_frames_remaining = 16 + (random16() & 0x7f);  // between 4..20
 
-	while (build_sparkles())
-	{
-		uint32_t rb;
-		uint32_t gb;
-		uint32_t bb;
+	sparkle_wait_ms = 16 + (random16() & 0x7f);  // between 16..143 mS
+
+	overlay_ms_elapsed = 0;
+	display_overlay = OVERLAY_SPARKLE;
+}
+
+// Advances the sparkles by the elapsed time and draws those that changed
+static bool sparkle_frame(uint8_t elapsed_ms)
+{
+	bool active;
+	do {
+		active = build_sparkles();
+	} while (active && --elapsed_ms);
+	if (!active) {
+		return false;
+	}
+
+	uint32_t rb;
+	uint32_t gb;
+	uint32_t bb;
+
+	for(uint8_t i=0;i<16 ;++i){
 		
-		for(uint8_t i=0;i<16 ;++i){
+		if (sparkle_intensity[i] != prev_sparkle_intensity[i]){		
 			
-			if (sparkle_intensity[i] != prev_sparkle_intensity[i]){		
-				
-				uint8_t t = sparkle_intensity[i] << 1;
-		
-				if (sparkle_intensity[i] > 127) {
-					rb = lerp(sparkle_start_color[0], sparkle_end_color[0], t) & 0xFF;
-					gb = lerp(sparkle_start_color[1], sparkle_end_color[1], t) & 0xFF;
-					bb = lerp(sparkle_start_color[2], sparkle_end_color[2], t) & 0xFF;
-				} else {
-					rb = lerp(sparkle_end_color[0], 0, t) & 0xFF;
-					gb = lerp(sparkle_end_color[1], 0, t) & 0xFF;
-					bb = lerp(sparkle_end_color[2], 0, t) & 0xFF;
-				}
-
-				// build_rgb no longer does this for us.
-				rb = 255 * pow( (((float)rb)/255.0f) , 5.0);
-				gb = 255 * pow( (((float)gb)/255.0f) , 2.5);
-
-				uint32_t new_color = (rb << 16) | (gb << 8) | (bb);
-
-				build_rgb(i, new_color, 0xFE);
-
-				// Store the value for the next comparison
-				prev_sparkle_intensity[i] = sparkle_intensity[i];
+			uint8_t t = sparkle_intensity[i] << 1;
+	
+			if (sparkle_intensity[i] > 127) {
+				rb = lerp(sparkle_start_color[0], sparkle_end_color[0], t) & 0xFF;
+				gb = lerp(sparkle_start_color[1], sparkle_end_color[1], t) & 0xFF;
+				bb = lerp(sparkle_start_color[2], sparkle_end_color[2], t) & 0xFF;
+			} else {
+				rb = lerp(sparkle_end_color[0], 0, t) & 0xFF;
+				gb = lerp(sparkle_end_color[1], 0, t) & 0xFF;
+				bb = lerp(sparkle_end_color[2], 0, t) & 0xFF;
 			}
+
+			// build_rgb no longer does this for us.
+			uint32_t new_color = legacy_gamma((rb << 16) | (gb << 8) | (bb));
+
+			build_rgb(i, new_color, 0xFE);
+
+			// Store the value for the next comparison
+			prev_sparkle_intensity[i] = sparkle_intensity[i];
 		}
-		
-	}	
+	}
+	return true;
 }
 
-bool build_sparkles(void)
+// Advances the sparkles by one mS, returns false once they have all faded
+static bool build_sparkles(void)
 {
 	bool active = false;
-	
-	// Scan through the remaining sparkles and decrease
-	// their brightness randomly 25% of the time
+
+	// Scan through the remaining sparkles and decrease their brightness
+	// randomly half of the time, the old free running loop managed about one
+	// pass every 30 uS and dimmed 1 in 64 passes
 	for(uint8_t i=0;i<16;++i){
 		if(sparkle_intensity[i] > 0 ) {
 			active = true;
-			if ((random16() & 0x3F) == 0) {
+			if (random16() & 0x01) {
 				--sparkle_intensity[i];
 			}
 		}
 	}
+
+	if (sparkle_wait_ms) {
+		--sparkle_wait_ms;
+	}
 	
 	// Check if we are finished
 	if (sparkle_count == 0 && !active){
 		return false;
 	}
 	
-	if ((sparkle_count > 0) && (animation_frames_remaining == 0)) {
+	if ((sparkle_count > 0) && (sparkle_wait_ms == 0)) {
 		// Add a new sparkle, but only to 'dead' pixels
 		uint8_t new = random16() & 0xf;
-		
+
 		if (!sparkle_intensity[new]){
 			sparkle_intensity[new] = 0xff;
 			sparkle_intensity[random16() & 0xf] = 0xff;
-			// set time to generate next sparkle to random between 16 & 127 ms
-			animation_frames_remaining = 16 + (random16() & 0x7F);
+			// set time to generate next sparkle to random between 16 & 143 ms
+			sparkle_wait_ms = 16 + (random16() & 0x7F);
 			// decrement the sparkle count
 			--sparkle_count;
 		}
@@ -1086,12 +1423,26 @@ bool build_sparkles(void)
 }
 
 
-/** Draws a rainbow display on the RGB segments. */
+/** Starts the rainbow demo on the RGB segments, it runs until reset. */
 void rainbow_demo(void)
+{
+	overlay_step = DEMO_STEP_TIME;	// Draw the first step straight away
+	overlay_ms_elapsed = 0;
+	display_overlay = OVERLAY_DEMO;
+}
+
+// Sets the color of one more encoder every DEMO_STEP_TIME mS
+static bool demo_frame(uint8_t elapsed_ms)
 {
 	static uint8_t idx=0;
 	static uint8_t colorIndex = 0;
-	
+
+	overlay_step += elapsed_ms;
+	if (overlay_step < DEMO_STEP_TIME) {
+		return true;
+	}
+	overlay_step = 0;
+
 	if (colorIndex > 126){
 		colorIndex = 1;
 	}
@@ -1106,10 +1457,10 @@ void rainbow_demo(void)
 	}
 	
 	set_encoder_rgb(idx,color);
-	
+
 	idx+=1;
 	colorIndex +=1;
-	Delay_MS(150);
+	return true;
 }
 
 void bank_change_animation(uint8_t new_bank)
@@ -1134,6 +1485,12 @@ void bank_change_animation(uint8_t new_bank)
 	s_bank_anim_fading = false;
 	s_bank_anim_level  = 0;
 	animation_frames_remaining = 60;  // flash hold time
+
+	#if ENABLE_MAX_LED_UPDATE_SPEED > 0 && DISPLAY_OE_PWM > 0
+	// The caller changes bank straight away, so just fade the new bank in
+	display_set_fade(0);
+	display_fade_to(DISPLAY_OE_LEVEL_MAX, DISPLAY_BANK_FADE_STEP);
+	#endif
 }
 
 void bank_change_animation_tick(void)
@@ -1142,7 +1499,16 @@ void bank_change_animation_tick(void)
 	if (animation_frames_remaining > 0) return;
 
 	if (!s_bank_anim_fading) {
-		// Flash done  switch bank, begin fade
+		#if DISPLAY_OE_PWM > 0
+		// Flash done, black out and fade the new bank in while it is drawn
+		// as normal
+		display_set_fade(0);
+		change_encoder_bank(s_bank_anim_bank);
+		display_fade_to(DISPLAY_OE_LEVEL_MAX, DISPLAY_BANK_FADE_STEP);
+		s_bank_anim_bank = 0xFF;
+		return;
+		#else
+		// Flash done   switch bank, begin fade
 		for (uint8_t e = 0; e < 16; e++) {
 			build_rgb(e, 0, 1);
 			set_indicator_pattern(e, 0x0000);
@@ -1152,6 +1518,7 @@ void bank_change_animation_tick(void)
 		s_bank_anim_level  = 1;
 		animation_frames_remaining = 2;
 		return;
+		#endif
 	}
 
 	for (uint8_t e = 0; e < 16; e++) {
@@ -1182,14 +1549,34 @@ const uint8_t sleep_timeout_map[8] = {0, 1, 3, 5, 10, 20, 30, 60};
 uint8_t sleep_timeout_minutes = 0;
 uint8_t sleep_animation_type = 0;
 
+#if DISPLAY_OE_PWM > 0
+static bool sleep_dark;		// The display has faded out since sleep began
+#endif
+
 void sleep_frame(void)
 {
+	#if DISPLAY_OE_PWM > 0
+	// The sleep animation starts once the display has faded out
+	if (!sleep_dark) {
+		if (display_fading()) {
+			return;
+		}
+		sleep_dark = true;
+		clear_display_buffer();
+		if (sleep_animation_type != 0) {
+			display_fade_to(DISPLAY_OE_LEVEL_MAX, DISPLAY_SLEEP_FADE_STEP);
+		}
+	}
+	#endif
+
 	switch (sleep_animation_type) {
 		case 0:  // Lights off
+		#if DISPLAY_OE_PWM == 0
 		for (uint8_t enc = 0; enc < 16; ++enc) {
 			build_rgb(enc, 0, 1);
 			set_indicator_pattern(enc, 0x0000);
 		}
+		#endif
 		break;
 		case 1:  // Rainbow wave
 		rainbow_wave_frame();
@@ -1199,12 +1586,11 @@ void sleep_frame(void)
 	}
 }
 
-static uint16_t rainbow_phase = 0;
+// One color cycle every 512 frames, each diagonal row is 1/16 cycle behind
+static oscillator_t rainbow_osc = {0, OSC_PHASE_CYCLE / 512, OSC_SINE};
 
 void rainbow_wave_frame(void)
 {
-	double color_freq = (2.0 * 3.14159 / 256);
-
 	const uint8_t row_map[16] = {
 		6, 5, 4, 3,
 		5, 4, 3, 2,
@@ -1213,28 +1599,48 @@ void rainbow_wave_frame(void)
 	};
 
 	for (uint8_t enc = 0; enc < 16; ++enc) {
-		uint8_t phase = (rainbow_phase >> 1) + (row_map[enc] * 16);
+		uint16_t phase = rainbow_osc.phase + ((uint16_t)row_map[enc] << 12);
 
-		uint8_t r = (uint8_t)(127 * sin(phase * color_freq)) + 128;
-		uint8_t g = (uint8_t)(127 * sin((phase + 85) * color_freq)) + 128;
-		uint8_t b = (uint8_t)(127 * sin((phase + 170) * color_freq)) + 128;
+		uint8_t r = OSC_UNIPOLAR(osc_wave(rainbow_osc.shape, phase));
+		uint8_t g = OSC_UNIPOLAR(osc_wave(rainbow_osc.shape, phase + (85 << 8)));
+		uint8_t b = OSC_UNIPOLAR(osc_wave(rainbow_osc.shape, phase + (170 << 8)));
 
 		uint32_t color = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
 
 		build_rgb(enc, color, 0);
 	}
 
-	rainbow_phase++;
-}
+	osc_next(&rainbow_osc);
+}
 volatile uint32_t idle_timer = 0;
 volatile bool sleep_mode_active = false;
 
 void reset_idle_timer(void)
 {
 	idle_timer = 0;
+	#if DISPLAY_OE_PWM > 0
+	if (sleep_mode_active) {
+		display_fade_to(DISPLAY_OE_LEVEL_MAX, DISPLAY_WAKE_FADE_STEP);
+	}
+	#endif
 	sleep_mode_active = false;
     refresh_display();
 
+}
+
+/**
+ * Puts the display to sleep, sleep_frame() draws it from then on.
+ */
+void sleep_begin(void)
+{
+	sleep_mode_active = true;
+	#if DISPLAY_OE_PWM > 0
+	// Fade out what is showing first
+	sleep_dark = false;
+	display_fade_to(0, DISPLAY_SLEEP_FADE_STEP);
+	#else
+	clear_display_buffer();
+	#endif
 }
 
 // Linear interpolation between two values.
@@ -1269,5 +1675,22 @@ uint16_t random16(void)
 
 void reset_pulse_animation(void)
 {
-	pulse_anim_origin = animation_counter;
+	pulse_anim_origin = animation_phase;
+}
+
+/**
+ * Works out the animation phase for this pass of the main loop. With a MIDI
+ * clock it is locked to the clock and interpolated between its ticks,
+ * otherwise it follows the frame timer.
+ */
+void animation_phase_update(void)
+{
+	irqflags_t flags = cpu_irq_save();
+	if (midi_clock_enabled) {
+		animation_phase = animation_clock_phase(tc_read_count(&TCC1));
+		animation_counter = (uint8_t)(animation_phase >> 8);
+	} else {
+		animation_phase = ((uint16_t)animation_counter << 8) | (uint8_t)tick;
+	}
+	cpu_irq_restore(flags);
 }
\ No newline at end of file
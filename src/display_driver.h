@@ -26,8 +26,11 @@
 
 /*	Includes: */
 	#include <asf.h>
-	#include <math.h>
 	#include <colorMap.h>
+	#include <oscillator.h>
+	#include <animation_clock.h>
+	#include <indicator_pattern.h>
+	#include <color_tables.h>
 	
 	#include "encoders.h"
 	
@@ -35,23 +38,72 @@
 /*	Macros: */
 	#define ENABLE_MAX_LED_UPDATE_SPEED 1
 
+	// Draw into a back buffer which is swapped in between BCM cycles, so the
+	// DMA never streams a half written LED. Costs DMA_BUFFER_SIZE bytes of RAM.
+	#define DISPLAY_DOUBLE_BUFFER 1
+	#if DISPLAY_DOUBLE_BUFFER > 0
+	#define DISPLAY_FRAME_BUFFERS 2
+	#else
+	#define DISPLAY_FRAME_BUFFERS 1
+	#endif
+
+	// Remember the bit-plane levels set_encoder_rgb_level worked out for the
+	// most recent color and brightness pairs, so redrawing the same colors
+	// skips the color map and color tables. Costs 5 bytes of RAM per entry.
+	#define DISPLAY_RGB_CACHE 1
+	#define DISPLAY_RGB_CACHE_SIZE	16	// Entries, a power of 2
+
+	// Most encoders update_encoder_display may redraw per main loop pass
+	#if ENABLE_MAX_LED_UPDATE_SPEED > 0
+	#define DISPLAY_UPDATES_PER_PASS 6
+	#else
+	#define DISPLAY_UPDATES_PER_PASS 1
+	#endif
+
+	// Record the worst case time spent in the display interrupts, in CPU
+	// cycles, in display_isr_cycles_max. Read it with a debugger or simulator.
+	#define DISPLAY_ISR_PROFILE 0
+
 	// DMA Constants
 	#define DMA_CHANNEL	        0
-	//#define DMA_BUFFER_SIZE    4096  // 128 Frames
-	//#define DMA_BUFFER_SIZE    3072 // 96 Frames
-	#define DMA_BUFFER_SIZE    2560 // 80 Frames
-	//#define DMA_BUFFER_SIZE    2048 // 64 Frames
-	//#define DMA_BUFFER_SIZE    1024 // 32 Frames
-	//#define DMA_BUFFER_SIZE    512 // 16 Frames
-	//#define DMA_BUFFER_SIZE    128 // 4 Frames - Visibly glitchy
 	#define DMA_FRAME_SIZE     32
-	#define NUM_OF_FRAMES	   (DMA_BUFFER_SIZE/DMA_FRAME_SIZE)
+
+	// Binary Code Modulation - the frame buffer holds one frame per brightness
+	// bit (a bit-plane), and each plane is displayed for a time proportional
+	// to its bit weight. The two largest planes are shown in two halves
+	// spread across the cycle to keep the flicker frequency up.
+	#define DISPLAY_BIT_PLANES	7	// 128 brightness levels
+	#define DISPLAY_BCM_SLOTS	9	// Planes displayed per refresh cycle
+	#define DISPLAY_BCM_LEVEL_MAX ((1 << DISPLAY_BIT_PLANES) - 1)
+	#define DMA_BUFFER_SIZE    (DISPLAY_BIT_PLANES * DMA_FRAME_SIZE) // 224 Bytes
+
+	// Brightness settings are in steps of the old 80 frame linear PWM buffer,
+	// which saturated at 80. They are rescaled to the 7-bit plane levels so
+	// the existing brightness maps look the same.
+	#define DISPLAY_PWM_STEPS	80
+
+	// Brightness cap setting which leaves the LEDs at full brightness
+	#define DISPLAY_BRIGHTNESS_CAP_OFF	127
+
+	// Dim the whole display by pulse width modulating the 74HC595 /OE line at
+	// 125 kHz. The brightness cap, sleep fades and bank change fade in are then
+	// done by the timer rather than by redrawing every LED.
+	#define DISPLAY_OE_PWM 1
+	#define DISPLAY_OE_LEVEL_MAX		255		// Fully on
+	#define DISPLAY_SLEEP_FADE_STEP		1		// Levels per mS, 255 mS fade
+	#define DISPLAY_WAKE_FADE_STEP		8		// 32 mS
+	#define DISPLAY_BANK_FADE_STEP		4		// 64 mS
 	
 
 	// Define Pin Names
 	#define DISPLAY_EN		IOPORT_CREATE_PIN(PORTD, 0)
 	#define DISPLAY_RST     IOPORT_CREATE_PIN(PORTD, 5)
 	#define DISPLAY_LATCH   IOPORT_CREATE_PIN(PORTD, 4)
+
+	// DISPLAY_EN is the OC0A output of this timer
+	#define DISPLAY_OE_TIMER	TCD0
+	// Free running at the CPU clock when DISPLAY_ISR_PROFILE is set
+	#define DISPLAY_PROFILE_TIMER	TCD1
 	#define SPI_DATA        IOPORT_CREATE_PIN(PORTD, 3)
 	#define SPI_CLK         IOPORT_CREATE_PIN(PORTD, 1)
 
@@ -61,23 +113,21 @@
 	#define USART_SPI_MODE              0         // Sample on rising edge.
 	#define USART_SPI_DATA_ORDER        1         // MSB First.
 	
-/*	Types: */
-	
-	// Structure which holds two LED patterns (bit masks) and their respective
-	// brightness settings.
-	typedef struct {
-		uint16_t pattern_A;		// Pattern A is a series of White LEDs (dimmed/PWM'ed), With a Second LED (Blue) at the Detent, lit solid
-		uint8_t  pattern_A_brightness;
-		uint16_t pattern_B;       // Pattern B appears to be is series of White LEDs (lit solid), with a a Second LED (Red) at the Detent
-		uint8_t  pattern_B_brightness;
-	} indicator_bit_mask_t;
-		
-		
 /* Variables */
+	#if DISPLAY_ISR_PROFILE > 0
+	extern volatile uint16_t display_isr_cycles_max[2];	// Frame timer, DMA complete
+	#endif
+
+	#if DISPLAY_RGB_CACHE > 0
+	extern uint32_t display_rgb_cache_hits;		// Reported by the diagnostics SysEx
+	extern uint32_t display_rgb_cache_misses;
+	#endif
+
 
 	// Config structure for DMA channel
 	struct dma_channel_config	dmach_conf;	
-	extern volatile uint8_t animation_counter;		
+	extern volatile uint8_t animation_counter;
+	extern uint16_t animation_phase;				// Set each main loop pass by animation_phase_update()		
 /* Function Prototypes: */
 
 	void display_init(void);
@@ -93,16 +143,25 @@
 	void clear_display_buffer(void);
 	
 	void build_rgb(uint8_t encoder, uint32_t color, uint8_t level);
-	
-	int build_indicator_pattern(indicator_bit_mask_t *result, uint8_t position, uint16_t type, 
-								 bool has_detent, uint8_t detent_color);
+
+	uint32_t legacy_gamma(uint32_t color);
+
+	void display_set_gamma_curve(uint8_t curve);
+
+	void display_set_brightness_cap(uint8_t cap);
+
+	#if DISPLAY_OE_PWM > 0
+	void display_set_fade(uint8_t level);
+
+	void display_fade_to(uint8_t level, uint8_t step);
+
+	bool display_fading(void);
+	#endif
 	
 	bool strobe_animation(uint8_t flash_rate);
 	
 	uint8_t pulse_animation(uint8_t pulse_rate);
 	
-	bool build_sparkles(void);
-	
 	uint8_t lerp(uint8_t high, uint8_t low, uint8_t t);
 	
 	void bank_change_animation(uint8_t new_bank);
@@ -112,6 +171,8 @@
 	uint16_t random16(void);
 	
 	void reset_pulse_animation(void);
+
+	void animation_phase_update(void);
 
 	
 	// External Functions - these are what you should use to interact with the display
@@ -131,6 +192,10 @@
 								
 	void run_encoder_animation(uint8_t encoder, uint8_t bank, uint8_t animation, uint8_t color);
 	
+	bool display_overlay_tick(void);
+
+	void display_overlay_finish(void);
+
 	void setting_confirmation_animation(uint32_t color);
 	
 	void run_sparkle(uint8_t count);
@@ -145,6 +210,7 @@
 
 
 	void reset_idle_timer(void);
+	void sleep_begin(void);
 	void rainbow_wave_frame(void);
 	void sleep_frame(void);	
 
@@ -21,10 +21,502 @@
  *
  */ 
 
+#include <util/crc16.h>
+
 #include "eeprom.h"
+#include "config.h"
 
 // EEPROM Access Functions ----------------------------------------------------
 
+// A page write (erase then write) takes up to 8 mS and the EEPROM can't be read
+// until it finishes. Writes go into RAM copies of their pages instead, which
+// eeprom_queue_task() commits one at a time, so interrupts are only ever held
+// off while a page is loaded into the NVM page buffer. The EEPROM-ready
+// interrupt says when the next page can be started.
+//
+// A page write cut short by power loss leaves the page neither old nor new.
+// Each write to a guarded page is therefore preceded by a guard record naming
+// the page and holding a CRC of its data before and after. Only one page is
+// written at a time, so at boot only the page the newest record names can be
+// torn, and it is if it matches neither CRC. A seal record (eeprom_queue_seal())
+// says the guarded pages are complete and holds a value for the caller.
+//
+// The records go round a ring of EEPROM_GUARD_RECORDS slots at the end of the
+// EEPROM, each with a sequence number and a CRC, and the newest which checks
+// out counts. An atomic page write only erases and writes the page buffer
+// locations which were loaded, so a record write wears just its own slot.
+
+typedef struct {
+	bool used;						// The slot holds a copy of page
+	bool dirty;						// The copy hasn't been written back yet
+	uint8_t page;
+	uint8_t sequence;				// When the copy became dirty, oldest is written first
+	uint8_t data[EEPROM_PAGE_SIZE];
+} eeprom_queue_slot_t;
+
+static eeprom_queue_slot_t eeprom_queue[EEPROM_QUEUE_PAGES];
+static uint8_t eeprom_queue_sequence;
+static volatile bool eeprom_write_busy;		// Cleared by the EEPROM-ready interrupt
+
+static uint8_t eeprom_guard_first;			// Guarded pages, see eeprom_queue_guard()
+static uint8_t eeprom_guard_count;
+static uint8_t eeprom_guard_next;			// Slot for the next guard record
+static uint8_t eeprom_guard_sequence;		// Sequence number of the next guard record
+static bool eeprom_guard_logged;			// The slot before eeprom_guard_next holds the newest record
+static uint8_t eeprom_guard_page = 0xFF;	// Page the newest record names, GUARD_SEAL if none
+static uint16_t eeprom_guard_crc;			// New data CRC the newest record holds for it
+static bool eeprom_seal_waiting;			// The seal record hasn't been written yet
+static uint16_t eeprom_seal;
+
+// Guard record layout
+#define GUARD_PAGE			0	// Guarded page, or GUARD_SEAL
+#define GUARD_OLD_CRC		1	// 2 bytes, LSB first
+#define GUARD_NEW_CRC		3	// 2 bytes, LSB first
+#define GUARD_SEQUENCE		5	// One more than the record before
+#define GUARD_CRC			6	// 2 bytes, LSB first, over the bytes before
+#define GUARD_SEAL_VALUE	GUARD_OLD_CRC	// A seal holds its value in place of the CRCs
+
+#define GUARD_SEAL			0xFF
+
+#if EEPROM_GUARD_RECORD_SIZE != GUARD_CRC + 2 || EEPROM_PAGE_SIZE % EEPROM_GUARD_RECORD_SIZE
+#error The guard records must fill the guard pages
+#endif
+
+uint16_t eeprom_irq_off_max;
+uint32_t eeprom_page_writes;
+
+// The page write started by eeprom_write_start() has finished
+ISR(NVM_EE_vect)
+{
+	// The interrupt fires for as long as the EEPROM is ready
+	NVM.INTCTRL &= ~NVM_EELVL_gm;
+	eeprom_write_busy = false;
+}
+
+static void eeprom_irq_off_end(uint16_t start)
+{
+	uint16_t counts = tc_read_count(&TCC0) - start;
+	if (counts > eeprom_irq_off_max) {
+		eeprom_irq_off_max = counts;
+	}
+}
+
+// Reads straight from the EEPROM, waiting out any page write with interrupts on
+static void eeprom_read_direct(uint16_t address, uint8_t *buffer, uint8_t length)
+{
+	nvm_wait_until_ready();
+
+	irqflags_t flags = cpu_irq_save();
+	uint16_t start = tc_read_count(&TCC0);
+	nvm_eeprom_read_buffer(address, buffer, length);
+	eeprom_irq_off_end(start);
+	cpu_irq_restore(flags);
+}
+
+static uint16_t eeprom_crc(const uint8_t *data, uint8_t length)
+{
+	uint16_t crc = 0xFFFF;
+	for (uint8_t i = 0; i < length; ++i) {
+		crc = _crc_ccitt_update(crc, data[i]);
+	}
+	return crc;
+}
+
+// Starts writing length bytes of a page from offset, the NVM controller must be
+// idle. The rest of the page is left as it is.
+static void eeprom_write_start(uint8_t page, uint8_t offset, const uint8_t *data, uint8_t length)
+{
+	irqflags_t flags = cpu_irq_save();
+	uint16_t start = tc_read_count(&TCC0);
+	for (uint8_t i = 0; i < length; ++i) {
+		nvm_eeprom_load_byte_to_buffer(offset + i, data[i]);
+	}
+	nvm_eeprom_atomic_write_page(page);
+	eeprom_write_busy = true;
+	NVM.INTCTRL = (NVM.INTCTRL & ~NVM_EELVL_gm) | NVM_EELVL_LO_gc;
+	eeprom_irq_off_end(start);
+	cpu_irq_restore(flags);
+
+	eeprom_page_writes++;
+}
+
+// Reads the guard record in a slot, false if it doesn't check out
+static bool eeprom_guard_read(uint8_t index, uint8_t *record)
+{
+	eeprom_read_direct(EEPROM_GUARD_FIRST_PAGE * EEPROM_PAGE_SIZE + index * EEPROM_GUARD_RECORD_SIZE,
+					   record, EEPROM_GUARD_RECORD_SIZE);
+
+	uint16_t crc = record[GUARD_CRC] | ((uint16_t)record[GUARD_CRC + 1] << 8);
+	return crc == eeprom_crc(record, GUARD_CRC) &&
+		   (record[GUARD_PAGE] == GUARD_SEAL || record[GUARD_PAGE] < EEPROM_GUARD_FIRST_PAGE);
+}
+
+// Starts writing a guard record to the next slot, filling in its sequence
+// number and CRC. The NVM controller must be idle.
+static void eeprom_guard_write(uint8_t *record)
+{
+	record[GUARD_SEQUENCE] = eeprom_guard_sequence++;
+	uint16_t crc = eeprom_crc(record, GUARD_CRC);
+	record[GUARD_CRC] = crc & 0xFF;
+	record[GUARD_CRC + 1] = crc >> 8;
+
+	uint16_t offset = eeprom_guard_next * EEPROM_GUARD_RECORD_SIZE;
+	eeprom_write_start(EEPROM_GUARD_FIRST_PAGE + offset / EEPROM_PAGE_SIZE, offset % EEPROM_PAGE_SIZE,
+					   record, EEPROM_GUARD_RECORD_SIZE);
+	if (++eeprom_guard_next >= EEPROM_GUARD_RECORDS) {
+		eeprom_guard_next = 0;
+	}
+	eeprom_guard_logged = true;
+}
+
+// Starts writing the seal record asked for by eeprom_queue_seal()
+static void eeprom_seal_write(void)
+{
+	uint8_t record[EEPROM_GUARD_RECORD_SIZE];
+	record[GUARD_PAGE] = GUARD_SEAL;
+	record[GUARD_SEAL_VALUE] = eeprom_seal & 0xFF;
+	record[GUARD_SEAL_VALUE + 1] = eeprom_seal >> 8;
+	record[GUARD_NEW_CRC] = 0xFF;
+	record[GUARD_NEW_CRC + 1] = 0xFF;
+
+	eeprom_guard_write(record);
+	eeprom_guard_page = GUARD_SEAL;
+	eeprom_seal_waiting = false;
+}
+
+// Starts the next write needed to write a page back, the NVM controller must
+// be idle. A guarded page first needs a guard record naming it with its new
+// data, the copy is only written back (and clean) by a later call.
+static void eeprom_queue_commit(eeprom_queue_slot_t *slot)
+{
+	if ((uint8_t)(slot->page - eeprom_guard_first) < eeprom_guard_count) {
+		uint16_t crc = eeprom_crc(slot->data, EEPROM_PAGE_SIZE);
+		if (slot->page != eeprom_guard_page || crc != eeprom_guard_crc) {
+			uint8_t data[EEPROM_PAGE_SIZE];
+			eeprom_read_direct(slot->page * EEPROM_PAGE_SIZE, data, EEPROM_PAGE_SIZE);
+			uint16_t old_crc = eeprom_crc(data, EEPROM_PAGE_SIZE);
+
+			uint8_t record[EEPROM_GUARD_RECORD_SIZE];
+			record[GUARD_PAGE] = slot->page;
+			record[GUARD_OLD_CRC] = old_crc & 0xFF;
+			record[GUARD_OLD_CRC + 1] = old_crc >> 8;
+			record[GUARD_NEW_CRC] = crc & 0xFF;
+			record[GUARD_NEW_CRC + 1] = crc >> 8;
+
+			eeprom_guard_write(record);
+			eeprom_guard_page = slot->page;
+			eeprom_guard_crc = crc;
+			return;
+		}
+	}
+
+	eeprom_write_start(slot->page, 0, slot->data, EEPROM_PAGE_SIZE);
+	// The copy stays cached, it now matches the EEPROM
+	slot->dirty = false;
+}
+
+static eeprom_queue_slot_t *eeprom_queue_oldest(void)
+{
+	eeprom_queue_slot_t *oldest = NULL;
+	uint8_t oldest_age = 0;
+
+	for (uint8_t i = 0; i < EEPROM_QUEUE_PAGES; ++i) {
+		eeprom_queue_slot_t *slot = &eeprom_queue[i];
+		uint8_t age = eeprom_queue_sequence - slot->sequence;
+		if (slot->dirty && (!oldest || age > oldest_age)) {
+			oldest = slot;
+			oldest_age = age;
+		}
+	}
+	return oldest;
+}
+
+// Starts the next write the queue needs, if any, the NVM controller must be
+// idle. A waiting seal goes first, it was asked for before any guarded page
+// now waiting was changed.
+static void eeprom_queue_write_next(void)
+{
+	if (eeprom_seal_waiting) {
+		eeprom_seal_write();
+		return;
+	}
+
+	eeprom_queue_slot_t *slot = eeprom_queue_oldest();
+	if (slot) {
+		eeprom_queue_commit(slot);
+	}
+}
+
+static eeprom_queue_slot_t *eeprom_queue_find(uint8_t page)
+{
+	for (uint8_t i = 0; i < EEPROM_QUEUE_PAGES; ++i) {
+		if (eeprom_queue[i].used && eeprom_queue[i].page == page) {
+			return &eeprom_queue[i];
+		}
+	}
+	return NULL;
+}
+
+// An unused slot, or failing that one whose page is already written back
+static eeprom_queue_slot_t *eeprom_queue_spare(void)
+{
+	eeprom_queue_slot_t *clean = NULL;
+
+	for (uint8_t i = 0; i < EEPROM_QUEUE_PAGES; ++i) {
+		if (!eeprom_queue[i].used) {
+			return &eeprom_queue[i];
+		}
+		if (!eeprom_queue[i].dirty) {
+			clean = &eeprom_queue[i];
+		}
+	}
+	return clean;
+}
+
+/**
+ * Returns the queue's copy of a page, reading the page in if there isn't one.
+ * When every slot holds a page waiting to be written the oldest is written
+ * first, which waits for the NVM controller (with interrupts on).
+ *
+ * \param page [in]		EEPROM page
+ */
+static eeprom_queue_slot_t *eeprom_queue_slot(uint8_t page)
+{
+	eeprom_queue_slot_t *slot = eeprom_queue_find(page);
+	if (slot) {
+		return slot;
+	}
+
+	slot = eeprom_queue_spare();
+	while (!slot) {
+		nvm_wait_until_ready();
+		eeprom_queue_write_next();
+		slot = eeprom_queue_spare();
+	}
+
+	slot->used = true;
+	slot->dirty = false;
+	slot->page = page;
+	eeprom_read_direct(page * EEPROM_PAGE_SIZE, slot->data, EEPROM_PAGE_SIZE);
+	return slot;
+}
+
+static void eeprom_queue_mark_dirty(eeprom_queue_slot_t *slot)
+{
+	if (!slot->dirty) {
+		slot->dirty = true;
+		slot->sequence = eeprom_queue_sequence++;
+	}
+}
+
+/**
+ * Reads a byte of EEPROM, including writes still waiting in the queue.
+ *
+ * \param address [in]	The location to read from
+ *
+ * \return The byte
+ */
+uint8_t eeprom_queue_read_byte(uint16_t address)
+{
+	eeprom_queue_slot_t *slot = eeprom_queue_find(address / EEPROM_PAGE_SIZE);
+	if (slot) {
+		return slot->data[address % EEPROM_PAGE_SIZE];
+	}
+
+	uint8_t data;
+	eeprom_read_direct(address, &data, 1);
+	return data;
+}
+
+/**
+ * Writes a byte of EEPROM through the queue. Writing the value already stored
+ * doesn't cause a page write.
+ *
+ * \param address [in]	The location to write to
+ *
+ * \param data [in]		The byte
+ */
+void eeprom_queue_write_byte(uint16_t address, uint8_t data)
+{
+	eeprom_queue_slot_t *slot = eeprom_queue_slot(address / EEPROM_PAGE_SIZE);
+	uint8_t *byte = &slot->data[address % EEPROM_PAGE_SIZE];
+
+	if (*byte != data) {
+		*byte = data;
+		eeprom_queue_mark_dirty(slot);
+	}
+}
+
+/**
+ * Reads a block of EEPROM, including writes still waiting in the queue.
+ *
+ * \param address [in]	The location to read from
+ *
+ * \param buffer [out]	Where to put the data
+ *
+ * \param length [in]	Number of bytes to read
+ */
+void eeprom_queue_read_buffer(uint16_t address, uint8_t *buffer, uint8_t length)
+{
+	while (length) {
+		uint8_t offset = address % EEPROM_PAGE_SIZE;
+		uint8_t chunk = EEPROM_PAGE_SIZE - offset;
+		if (chunk > length) {
+			chunk = length;
+		}
+
+		eeprom_queue_slot_t *slot = eeprom_queue_find(address / EEPROM_PAGE_SIZE);
+		if (slot) {
+			memcpy(buffer, &slot->data[offset], chunk);
+		} else {
+			eeprom_read_direct(address, buffer, chunk);
+		}
+
+		address += chunk;
+		buffer += chunk;
+		length -= chunk;
+	}
+}
+
+/**
+ * Queues a whole page to be written. A page which already holds the data (or
+ * will once the queue is written) isn't written again.
+ *
+ * \param page [in]		EEPROM page
+ *
+ * \param data [in]		EEPROM_PAGE_SIZE bytes to write
+ */
+void eeprom_queue_write_page(uint8_t page, const uint8_t *data)
+{
+	eeprom_queue_slot_t *slot = eeprom_queue_slot(page);
+	if (memcmp(slot->data, data, EEPROM_PAGE_SIZE)) {
+		memcpy(slot->data, data, EEPROM_PAGE_SIZE);
+		eeprom_queue_mark_dirty(slot);
+	}
+}
+
+/**
+ * Says whether any of a run of pages has writes still waiting in the queue.
+ *
+ * \param first_page [in]	First EEPROM page of the run
+ *
+ * \param count [in]		Number of pages
+ */
+bool eeprom_queue_pending(uint8_t first_page, uint8_t count)
+{
+	for (uint8_t i = 0; i < EEPROM_QUEUE_PAGES; ++i) {
+		if (eeprom_queue[i].dirty && (uint8_t)(eeprom_queue[i].page - first_page) < count) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Guards a run of pages, every later write to them is logged by a guard record
+ * first. Finds the newest record, which new records follow. Call once, before
+ * writing any of the pages.
+ *
+ * \param first_page [in]	First EEPROM page of the run
+ *
+ * \param count [in]		Number of pages
+ */
+void eeprom_queue_guard(uint8_t first_page, uint8_t count)
+{
+	eeprom_guard_first = first_page;
+	eeprom_guard_count = count;
+
+	// The live records hold consecutive sequence numbers, so the newest is the
+	// one the others are all behind
+	uint8_t record[EEPROM_GUARD_RECORD_SIZE];
+	uint8_t newest = 0;
+	eeprom_guard_logged = false;
+	for (uint8_t i = 0; i < EEPROM_GUARD_RECORDS; ++i) {
+		if (eeprom_guard_read(i, record) &&
+			(!eeprom_guard_logged || (int8_t)(record[GUARD_SEQUENCE] - eeprom_guard_sequence) >= 0)) {
+			eeprom_guard_logged = true;
+			eeprom_guard_sequence = record[GUARD_SEQUENCE] + 1;
+			newest = i;
+		}
+	}
+
+	eeprom_guard_next = eeprom_guard_logged ? (newest + 1) % EEPROM_GUARD_RECORDS : 0;
+}
+
+/**
+ * Says what the newest guard record shows. After a seal the guarded pages are
+ * as they were sealed. After a guarded page write every page is old or new,
+ * unless power was lost part way through that write, leaving it neither. A
+ * record which was itself cut short doesn't check out and the one before it
+ * counts, its page write hadn't started.
+ *
+ * \param seal [out]	The value sealed, for EEPROM_GUARD_SEALED
+ *
+ * \return What the log shows
+ */
+eeprom_guard_state_t eeprom_queue_guard_state(uint16_t *seal)
+{
+	uint8_t record[EEPROM_GUARD_RECORD_SIZE];
+	uint8_t newest = (eeprom_guard_next ? eeprom_guard_next : EEPROM_GUARD_RECORDS) - 1;
+	if (!eeprom_guard_logged || !eeprom_guard_read(newest, record)) {
+		return EEPROM_GUARD_EMPTY;
+	}
+
+	if (record[GUARD_PAGE] == GUARD_SEAL) {
+		*seal = record[GUARD_SEAL_VALUE] | ((uint16_t)record[GUARD_SEAL_VALUE + 1] << 8);
+		return EEPROM_GUARD_SEALED;
+	}
+
+	uint8_t data[EEPROM_PAGE_SIZE];
+	eeprom_queue_read_buffer(record[GUARD_PAGE] * EEPROM_PAGE_SIZE, data, EEPROM_PAGE_SIZE);
+	uint16_t crc = eeprom_crc(data, EEPROM_PAGE_SIZE);
+	if (crc != (record[GUARD_OLD_CRC] | ((uint16_t)record[GUARD_OLD_CRC + 1] << 8)) &&
+		crc != (record[GUARD_NEW_CRC] | ((uint16_t)record[GUARD_NEW_CRC + 1] << 8))) {
+		return EEPROM_GUARD_TORN;
+	}
+	return EEPROM_GUARD_WRITTEN;
+}
+
+/**
+ * Seals the guarded pages with a value, which eeprom_queue_guard_state()
+ * returns until the next guarded page write. Call only when no guarded page
+ * has writes waiting. The seal record is written ahead of any page changed
+ * after the call.
+ *
+ * \param seal [in]		Value to keep with the seal
+ */
+void eeprom_queue_seal(uint16_t seal)
+{
+	eeprom_seal = seal;
+	eeprom_seal_waiting = true;
+}
+
+/**
+ * Starts writing the oldest waiting page if the last page write has finished.
+ * Call once per main loop pass.
+ */
+void eeprom_queue_task(void)
+{
+	if (eeprom_write_busy || (NVM.STATUS & NVM_NVMBUSY_bm)) {
+		return;
+	}
+
+	eeprom_queue_write_next();
+}
+
+/**
+ * Writes every waiting page (and seal) and waits for the last write to finish.
+ * Use before a reset, or anywhere the main loop won't run again.
+ */
+void eeprom_queue_flush(void)
+{
+	while (eeprom_seal_waiting || eeprom_queue_oldest()) {
+		nvm_wait_until_ready();
+		eeprom_queue_write_next();
+	}
+	nvm_wait_until_ready();
+}
+
 // EEPROM Setting Functions ---------------------------------------------------
 
 /**
@@ -26,14 +26,58 @@
 
 	/* Includes: */
 	#include <asf.h>
+	#include <string.h>
 	
 	#include "constants.h"
-	#include "midi.h"
 	
 	/* Macros: */
+	
+	// EEPROM pages held in RAM by the write-behind queue. Writes go to these
+	// copies and eeprom_queue_task() commits one dirty page per main loop pass.
+	#define EEPROM_QUEUE_PAGES	4
+
+	// Before each write to a guarded page the queue logs which page it is and
+	// a CRC of its old and new data, so a write cut short by power loss can be
+	// found at the next boot (see eeprom_queue_guard_state()). The log is a
+	// ring of small records in the last pages of the EEPROM.
+	#ifdef EXTENDED_BANKS
+	#define EEPROM_GUARD_PAGES	5
+	#else
+	#define EEPROM_GUARD_PAGES	1	// The sequencer patterns take the rest
+	#endif
+	#define EEPROM_GUARD_FIRST_PAGE		(EEPROM_SIZE / EEPROM_PAGE_SIZE - EEPROM_GUARD_PAGES)
+	#define EEPROM_GUARD_RECORD_SIZE	8
+	#define EEPROM_GUARD_RECORDS		(EEPROM_GUARD_PAGES * EEPROM_PAGE_SIZE / EEPROM_GUARD_RECORD_SIZE)
+
+/* Types: */
+	// What the guard log says about the guarded pages, see eeprom_queue_guard_state()
+	typedef enum {
+		EEPROM_GUARD_EMPTY,			// Nothing logged
+		EEPROM_GUARD_SEALED,		// Sealed since the last guarded page write
+		EEPROM_GUARD_WRITTEN,		// Written since the last seal, every page is old or new
+		EEPROM_GUARD_TORN,			// The last guarded page write was cut short
+	} eeprom_guard_state_t;
+
+	/* Variables */
+	
+	// Longest time an EEPROM access held interrupts off, in TCC0 counts (8 uS)
+	extern uint16_t eeprom_irq_off_max;
+
+	// Pages actually programmed, for measuring EEPROM wear
+	extern uint32_t eeprom_page_writes;
 
 	/* Function Prototypes: */
 	
+	uint8_t eeprom_queue_read_byte(uint16_t address);
+	void eeprom_queue_write_byte(uint16_t address, uint8_t data);
+	void eeprom_queue_read_buffer(uint16_t address, uint8_t *buffer, uint8_t length);
+	void eeprom_queue_write_page(uint8_t page, const uint8_t *data);
+	bool eeprom_queue_pending(uint8_t first_page, uint8_t count);
+	void eeprom_queue_guard(uint8_t first_page, uint8_t count);
+	eeprom_guard_state_t eeprom_queue_guard_state(uint16_t *seal);
+	void eeprom_queue_seal(uint16_t seal);
+	void eeprom_queue_task(void);
+	void eeprom_queue_flush(void);
 	
 	void eeprom_init(void);
 	void eeprom_factory_reset(void);
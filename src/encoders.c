@@ -31,7 +31,9 @@
 
 #include <encoders.h>
 #include "native_mode.h"
+#include "preset.h"
 #include <side_switch.h>
+#include <gesture.h>
 
 // Constants
 const uint16_t encoder_detent_limit_low = 6240; // 6240 - ok for all modes (6250 causes high res mode to hit '64' on the way up)
@@ -64,6 +66,9 @@ uint16_t enc_indicator_overide[NUM_BANKS];       // Bit field to track if indica
 uint16_t shift_mode_switch_state[2];			// Bit field to track the switch state for											    
 uint16_t shift_mode_midi_override[2];		    // Bit field to track the midi state for the
 												// two shift pages
+static uint16_t shift_mode_drawn_state;		// Bit field of the shift LEDs as last drawn
+static uint16_t shift_mode_drawn_valid;		// Bit field of the encoders drawn since
+												// entering shift mode
 
 // - this is necessary because some parameters are shared between 'shifted' and 'non-shifted' encoders.
 
@@ -81,10 +86,44 @@ int16_t  raw_encoder_value[VIRTUAL_ENCODERS]; // !Summer2016Update: Expanded to
 // --- 112-127: Encoders Bank 4 (Shifted)
 
 static uint8_t encoder_bank = 0;
-static int8_t g_detent_size;
-static int8_t g_dead_zone_size;
+
+// Detent and end stop state machine (one per physical encoder)
+typedef enum {
+	CAPTURE_FREE,
+	CAPTURE_DETENT,
+	CAPTURE_END_LOW,
+	CAPTURE_END_HIGH,
+} capture_zone_t;
+
+static uint8_t encoder_capture_zone[PHYSICAL_ENCODERS];
+static uint8_t encoder_capture_owner[PHYSICAL_ENCODERS];	// virtual encoder the zone belongs to
+
+// Detent and end stop geometry, indexed by the per-encoder settings. Index 0 
+// is the original fixed geometry so existing configurations are unchanged.
+static const int8_t detent_capture_ticks[ENC_DETENT_CAPTURE_MASK + 1] = {8, 4, 12, 16};  // Ticks to leave the detent
+static const int16_t detent_zone_low[ENC_DETENT_WIDTH_MASK + 1] = {6240, 6040};       // Raw value window which snaps into the detent
+static const int16_t detent_zone_high[ENC_DETENT_WIDTH_MASK + 1] = {6450, 6650};
+static const int8_t end_stop_ticks[ENC_END_STOP_MASK + 1] = {2, 6};                    // Ticks to leave an end stop
 //static encoder_config_t encoder_settings[PHYSICAL_ENCODERS];
 encoder_config_t encoder_settings[BANKED_ENCODERS];
+encoder_extra_config_t encoder_extra_settings[BANKED_ENCODERS];
+
+// encoder_settings doubles as the RAM copy of the encoder settings pages in
+// EEPROM. Changed pages are marked here and packed into the EEPROM queue by
+// encoder_config_task() once the settings stop changing.
+#if NUM_BANKS > 8
+#error The encoder settings page dirty bits only cover 8 banks
+#endif
+static uint32_t encoder_page_dirty;			// Bit per encoder settings page (4 per bank)
+static uint8_t gesture_page_dirty;			// Bit per gesture settings page (1 per bank)
+static uint16_t encoder_config_edit_time;	// ms_timer (low 16-bits) of the last change
+
+static void unpack_encoder_config(const uint8_t *buffer, encoder_config_t *cfg_ptr);
+static void unpack_encoder_geometry(const uint8_t *buffer, encoder_extra_config_t *extra_ptr);
+static void unpack_gesture_config(const uint8_t *gesture_buffer, encoder_extra_config_t *extra_ptr);
+static void merge_setting(uint8_t *setting, uint8_t value, uint8_t mask);
+static void merge_channel(uint8_t *setting, uint8_t value);
+static void encoder_config_queue_all(void);
 //static encoder_config_t encoder_settings_transfer_buffer[1];
 
 
@@ -109,6 +148,8 @@ void transfer_encoder_values_to_other_banks(uint8_t current_bank);
 bool animation_is_encoder_indicator(uint8_t animation_value);
 bool animation_is_switch_rgb(uint8_t animation_value);
 bool animation_buffer_conflict_exists(uint8_t bank, uint8_t encoder);
+// - Gestures
+void process_encoder_input_switch_gesture(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, uint16_t bit);
 
 #if VELOCITY_CALC_METHOD > VELOCITY_CALC_M_NONE 
 	uint16_t convert_ticks_per_scan_to_value_multiplier(uint8_t tick_count, uint16_t cycles_count);
@@ -183,29 +224,50 @@ void transfer_encoder_values_to_other_banks(uint8_t current_bank){
 	}
 }
 
+// Reads one settings page from the EEPROM, through the queue
+static void read_eeprom_settings_page(uint8_t page, uint8_t *buffer)
+{
+	eeprom_queue_read_buffer(page * EEPROM_PAGE_SIZE, buffer, EEPROM_PAGE_SIZE);
+}
+
 void encoders_init(void)
 {
-	// Read in all the encoder settings for all banks
-	// - in to the encoder_settings RAM Table
-	//for(uint8_t i=0;i<16;++i){
-	for(uint8_t i=0;i<BANKED_ENCODERS;++i){
-		uint8_t this_bank = i/16;
-		uint8_t this_phys_encoder = i%16;
-		get_encoder_config(this_bank, this_phys_encoder, &encoder_settings[i]);
-		//get_encoder_config(encoder_bank, i, &encoder_settings[i]);
-	}
-	
-	// Build all encoder color state buffer banks
-	// To do this efficiently we read the values directly from
-	// EEPROM rather than reading the entire config structure
-	// Load encoder settings for the currently selected bank
-	
-	uint16_t addr = (ENC_SETTINGS_START_PAGE * 32) + EE_INACTIVE_COLOR_OFFSET;
+	encoders_load_settings(read_eeprom_settings_page);
+}
+
+/**
+ * Loads the encoder settings of every bank and resets the encoder state, as
+ * at power up. The settings come from read_page, which fills in a settings
+ * page as laid out in the EEPROM, so a preset can be loaded the same way.
+ *
+ * \param read_page [in]	Reads one settings page in to a buffer
+ */
+void encoders_load_settings(settings_page_reader_t read_page)
+{
+	// Queue any changed settings first, so they are saved (and read back
+	// when loading from the EEPROM). Changes to a recalled preset are lost.
+	encoder_config_queue_all();
 
-	for (uint8_t i = 0; i<NUM_BANKS;++i){
-		for(uint8_t j=0;j<16;++j){
-			switch_color_buffer[i][j] = eeprom_read(addr);
-			addr+= ENC_EE_SIZE;
+	// Read in all the encoder settings for all banks in one pass, the encoder
+	// pages and then the gesture pages which follow them, decoding each page
+	// in to the encoder_settings RAM Table as it is read
+	uint8_t page_buffer[EEPROM_PAGE_SIZE];
+	uint8_t page = ENC_SETTINGS_START_PAGE;
+
+	for (uint8_t i = 0; i < BANKED_ENCODERS; i += 4, ++page) {
+		read_page(page, page_buffer);
+		for (uint8_t column = 0; column < 4; ++column) {
+			encoder_config_t *cfg = &encoder_settings[i + column];
+			unpack_encoder_config(&page_buffer[column * ENC_EE_SIZE], cfg);
+			unpack_encoder_geometry(&page_buffer[column * ENC_EE_SIZE], &encoder_extra_settings[i + column]);
+			// Build the encoder color state buffer banks
+			switch_color_buffer[i / 16][(i % 16) + column] = cfg->inactive_color;
+		}
+	}
+	for (uint8_t i = 0; i < BANKED_ENCODERS; i += 16, ++page) {
+		read_page(page, page_buffer);
+		for (uint8_t encoder = 0; encoder < 16; ++encoder) {
+			unpack_gesture_config(&page_buffer[encoder * GESTURE_EE_SIZE], &encoder_extra_settings[i + encoder]);
 		}
 	}
 	
@@ -220,6 +282,7 @@ void encoders_init(void)
 	// Initialize Per-Physical Encoder related variables
 	for (uint8_t i = 0; i<PHYSICAL_ENCODERS;++i){ 
 		encoder_detent_counter[i] = 0;
+		encoder_capture_zone[i] = CAPTURE_FREE;
 		enc_switch_toggle_state[encoder_bank] = 0;
 	}
 
@@ -240,10 +303,8 @@ void encoders_init(void)
 	//~ for (uint8_t i=0;i<(NUM_BANKS*16);++i){
 		//~ sync_input_map_to_output_map(i);
 	//~ }
-		
-	// Set the de-tent size	TODO THIS SHOULD BE A SETTING
-	g_detent_size = 8;	
-	g_dead_zone_size = 2;	
+	
+	gesture_init();
 }
 
 /**
@@ -264,18 +325,29 @@ void get_encoder_config(uint8_t bank, uint8_t encoder, encoder_config_t *cfg_ptr
 	
 	uint8_t buffer[8];
 	
-	// We need to disable interrupts while interacting with the EEPROM drivers
-	cpu_irq_disable();
-	nvm_eeprom_read_buffer(addr, buffer, 8);
-	cpu_irq_enable();
+	// Read through the write queue, which also holds interrupts off for
+	// the EEPROM drivers
+	eeprom_queue_read_buffer(addr, buffer, 8);
 	
+	unpack_encoder_config(buffer, cfg_ptr);
+}
+
+/**
+ * Expands one encoder's packed settings, the reverse of pack_encoder_config().
+ *
+ * \param [in] buffer			The encoder's ENC_EE_SIZE bytes of settings
+ *
+ * \param [out] cfg_ptr			The table to load the settings into
+ */
+static void unpack_encoder_config(const uint8_t *buffer, encoder_config_t *cfg_ptr)
+{
 	// Expand compressed settings
 	cfg_ptr->switch_action_type		= buffer[0] & 0x0F;
 	cfg_ptr->switch_midi_type		= 0;//(buffer[0] >> 1) & 0x01;
 	cfg_ptr->switch_midi_channel	= (buffer[0] >> 4) & 0x0F;
 	cfg_ptr->switch_midi_number		= buffer[1] & 0x7F;
-	cfg_ptr->active_color			= buffer[2];
-	cfg_ptr->inactive_color			= buffer[3];
+	cfg_ptr->active_color			= buffer[2] & 0x7F;
+	cfg_ptr->inactive_color			= buffer[3] & 0x7F;
 	cfg_ptr->detent_color			= buffer[4] & 0x7F;
 	cfg_ptr->has_detent				= (buffer[4] >> 7) & 0x01;
 	cfg_ptr->indicator_display_type = buffer[5] & 0x03;
@@ -287,6 +359,35 @@ void get_encoder_config(uint8_t bank, uint8_t encoder, encoder_config_t *cfg_ptr
 	cfg_ptr->is_super_knob          = (buffer[7] >> 7) & 0x01;
 }
 
+/**
+ * Expands one encoder's detent and end stop geometry, which is packed in to
+ * the spare top bits of its ENC_EE_SIZE bytes of settings.
+ *
+ * \param [in] buffer			The encoder's ENC_EE_SIZE bytes of settings
+ *
+ * \param [out] extra_ptr		The table to load the geometry into
+ */
+static void unpack_encoder_geometry(const uint8_t *buffer, encoder_extra_config_t *extra_ptr)
+{
+	extra_ptr->detent_width			= (buffer[1] >> 7) & 0x01;
+	extra_ptr->detent_capture		= ((buffer[2] >> 7) & 0x01) | ((buffer[3] >> 6) & 0x02);
+	extra_ptr->end_stop_size		= (buffer[6] >> 3) & 0x01;
+}
+
+/**
+ * Expands one encoder's gesture times, which live in their own page (unset
+ * values read as 0xFF).
+ *
+ * \param [in] gesture_buffer	The encoder's GESTURE_EE_SIZE bytes of gesture times
+ *
+ * \param [out] extra_ptr		The table to load the settings into
+ */
+static void unpack_gesture_config(const uint8_t *gesture_buffer, encoder_extra_config_t *extra_ptr)
+{
+	extra_ptr->gesture_long_press_time = gesture_time_or_default(gesture_buffer[0], DEF_GESTURE_LONG_PRESS_TIME);
+	extra_ptr->gesture_double_tap_time = gesture_time_or_default(gesture_buffer[1], DEF_GESTURE_DOUBLE_TAP_TIME);
+}
+
 // !review: this may not be correct
 // !revision: less overhead for animations, by removing eeprom reads
 //void get_encoder_config_locally(uint8_t bank, uint8_t encoder, encoder_config_t *cfg_ptr) {
@@ -296,126 +397,215 @@ void get_encoder_config(uint8_t bank, uint8_t encoder, encoder_config_t *cfg_ptr
 //}
 
 /**
- * Takes a table of new configuration data for a given encoder and saves all 
- * valid settings to EEPROM. Valid settings values are 0 - 127. Settings with
- * value above 127 will be ignored. When passing configuration data to this 
- * function any setting which is not being updated must have its value set to
- * 0x80 or above, otherwise it will be overwritten. See header file for a map
- * of the EEPROM layout of encoder settings
+ * Takes a table of new configuration data for a given encoder and merges all 
+ * valid settings into the encoder_settings and encoder_extra_settings RAM
+ * tables. Valid settings values
+ * are 0 - 127. Settings with value above 127 will be ignored. When passing
+ * configuration data to this function any setting which is not being updated
+ * must have its value set to 0x80 or above, otherwise it will be overwritten.
+ * The EEPROM page holding the encoder is marked to be written back by
+ * encoder_config_task(). See header file for a map of the EEPROM layout of
+ * encoder settings
  * 
  * \param bank [in]		The bank of the encoder
  *
  * \param encoder [in]	The index of the encoder
  *
- * \param encoder [in]	The tag table containing the new settings
+ * \param xfer_ptr [in]	The tag table containing the new settings
  * 
  */
-void save_encoder_config(uint8_t bank, uint8_t encoder, encoder_config_t *cfg_ptr)
+void save_encoder_config(uint8_t bank, uint8_t encoder, encoder_transfer_t *xfer_ptr)
 {	
-	// Record the new setting to RAM first
-	uint8_t virtual_encoder_id = get_virtual_encoder_id (bank, encoder);
-	encoder_settings[virtual_encoder_id] = *cfg_ptr;
+	// The settings tables only cover the unshifted encoders, as the EEPROM does
+	encoder_config_t *cfg = &encoder_settings[(bank * PHYSICAL_ENCODERS) + encoder];
+	encoder_extra_config_t *extra = &encoder_extra_settings[(bank * PHYSICAL_ENCODERS) + encoder];
+	const encoder_config_t *cfg_ptr = &xfer_ptr->config;
 	
-	// Create a tempory page_buffer;
-	uint8_t page_buffer[EEPROM_PAGE_SIZE];
+	// Each setting is masked to the bits it is saved in, so the RAM table
+	// matches what would be read back from EEPROM. MIDI channels arrive as
+	// 1 - 16 and are held as 0 - 15.
+	merge_setting(&cfg->switch_action_type, cfg_ptr->switch_action_type, 0x0F);
+	merge_channel(&cfg->switch_midi_channel, cfg_ptr->switch_midi_channel);
+	merge_setting(&cfg->switch_midi_number, cfg_ptr->switch_midi_number, 0x7F);
+	merge_setting(&cfg->active_color, cfg_ptr->active_color, 0x7F);
+	merge_setting(&cfg->inactive_color, cfg_ptr->inactive_color, 0x7F);
+	merge_setting(&cfg->has_detent, cfg_ptr->has_detent, 0x01);
+	merge_setting(&cfg->detent_color, cfg_ptr->detent_color, 0x7F);
+	merge_setting(&cfg->indicator_display_type, cfg_ptr->indicator_display_type, 0x03);
+	merge_setting(&cfg->movement, cfg_ptr->movement, 0x03);
+	merge_channel(&cfg->encoder_shift_midi_channel, cfg_ptr->encoder_shift_midi_channel); // !Summer2016Update shifted encoders midi channel
+	merge_setting(&cfg->encoder_midi_type, cfg_ptr->encoder_midi_type, 0x07); // !Spring2019Update: Added Switch Velocity Control and Mouse Emulation
+	merge_channel(&cfg->encoder_midi_channel, cfg_ptr->encoder_midi_channel);
+	merge_setting(&cfg->encoder_midi_number, cfg_ptr->encoder_midi_number, 0x7F);
+	merge_setting(&cfg->is_super_knob, cfg_ptr->is_super_knob, 0x01);
 	
-	// Each page contains setting for four encoders, so to avoid overwriting the
-	// data for the other 3 encoders we have to read in their setting first.
-	uint16_t page_address = (ENC_SETTINGS_START_PAGE * 32) + (bank * 128) + ((encoder/4)*32);
-	nvm_eeprom_read_buffer(page_address, page_buffer, EEPROM_PAGE_SIZE);
-	
-	uint8_t* buffer_ptr = page_buffer;
-	buffer_ptr += (8 * (encoder % 4));
-	
-	// Switch Action, Switch MIDI type & Switch MIDI channel are saved
-	// in the first byte
-	if (cfg_ptr->switch_action_type < 0x80){
-		*buffer_ptr &= ~0x0F; 
-		*buffer_ptr |= cfg_ptr->switch_action_type & 0x0F;
+	// The geometry is packed in to the same EEPROM record as the settings
+	// above. Bit-fields can't be passed to merge_setting().
+	if (xfer_ptr->detent_capture < 0x80) {
+		extra->detent_capture = xfer_ptr->detent_capture & ENC_DETENT_CAPTURE_MASK;
 	}
-
-	if (cfg_ptr->switch_midi_channel < 0x80){
-		*buffer_ptr &= ~0xF0;
-		*buffer_ptr |= (0xF0 & ((cfg_ptr->switch_midi_channel - 1) << 4));
+	if (xfer_ptr->detent_width < 0x80) {
+		extra->detent_width = xfer_ptr->detent_width & ENC_DETENT_WIDTH_MASK;
 	}
-	buffer_ptr++;  // Full
-	
-	// Switch MIDI number is saved in the second byte
-	if (cfg_ptr->switch_midi_number < 0x80){
-		*buffer_ptr = cfg_ptr->switch_midi_number;
+	if (xfer_ptr->end_stop_size < 0x80) {
+		extra->end_stop_size = xfer_ptr->end_stop_size & ENC_END_STOP_MASK;
 	}
-	buffer_ptr++;  // 1-bit open
 	
-	// Active and Inactive colors are saved in the third and fourth bytes	
-	if (cfg_ptr->active_color < 0x80){
-		*buffer_ptr = cfg_ptr->active_color;
+	// Each page contains settings for four encoders
+	encoder_page_dirty |= (uint32_t)1 << ((4 * bank) + (encoder / 4));
+	
+	// Gesture times are saved in a separate page, each page holds one bank
+	if (xfer_ptr->gesture_long_press_time < 0x80){
+		extra->gesture_long_press_time = gesture_time_or_default(xfer_ptr->gesture_long_press_time, DEF_GESTURE_LONG_PRESS_TIME);
+		gesture_page_dirty |= 1 << bank;
 	}
-	buffer_ptr++;  // 1-bit open
-		
-	if (cfg_ptr->inactive_color < 0x80){
-		*buffer_ptr = cfg_ptr->inactive_color;
+	if (xfer_ptr->gesture_double_tap_time < 0x80){
+		extra->gesture_double_tap_time = gesture_time_or_default(xfer_ptr->gesture_double_tap_time, DEF_GESTURE_DOUBLE_TAP_TIME);
+		gesture_page_dirty |= 1 << bank;
 	}
-	buffer_ptr++;  // 1-bit open
 	
-	// Has de-tent and de-tent color are saved in the 5th byte
-	if (cfg_ptr->has_detent < 0x80){
-		*buffer_ptr &= ~0x80;
-		*buffer_ptr |= (0x80 & (cfg_ptr->has_detent << 7));
-	}	
-	if (cfg_ptr->detent_color < 0x80){
-		*buffer_ptr &= ~0x7F;
-		*buffer_ptr |=  (0x7F & cfg_ptr->detent_color);
+	encoder_config_edit_time = (uint16_t)get_ms_timer();
+
+	// !Summer2016Update: Match the newly changed input_map to match the output_map saved in eeprom
+	// - removed in favor of expanding encoder_map
+	//~ sync_input_map_to_output_map(bank*16 + encoder); // !Summer2016Update: midi_input_map bugfix
+}
+
+// Sets one field of the RAM settings, unless the new value is 0x80 or above
+static void merge_setting(uint8_t *setting, uint8_t value, uint8_t mask)
+{
+	if (value < 0x80) {
+		*setting = value & mask;
 	}
-	buffer_ptr++; // Full
-	
-	// Encoder Indicator & Movement type are save in the 6th byte
-	if (cfg_ptr->indicator_display_type < 0x80){
-		*buffer_ptr &= ~0x03;
-		*buffer_ptr |= (0x03 & cfg_ptr->indicator_display_type);
-	}	
-	if (cfg_ptr->movement < 0x80){
-		*buffer_ptr &= ~0x0C;
-		*buffer_ptr |= (0x0C & (cfg_ptr->movement << 2));
+}
+
+// Sets a MIDI channel of the RAM settings from 1 - 16, unless the new value is
+// 0x80 or above
+static void merge_channel(uint8_t *setting, uint8_t value)
+{
+	if (value < 0x80) {
+		*setting = (value - 1) & 0x0F;
 	}
-	if (cfg_ptr->encoder_shift_midi_channel < 0x80){ // !Summer2016Update shifted encoders midi channel
-		*buffer_ptr &= ~0xF0;
-		*buffer_ptr |= (0xF0 & ((cfg_ptr->encoder_shift_midi_channel - 1) << 4));
+}
+
+/**
+ * Packs one encoder's settings into its ENC_EE_SIZE bytes of EEPROM page.
+ */
+static void pack_encoder_config(const encoder_config_t *cfg, const encoder_extra_config_t *extra, uint8_t *buffer)
+{
+	// Switch Action & Switch MIDI channel are saved in the first byte
+	buffer[0] = (cfg->switch_action_type & 0x0F) | (cfg->switch_midi_channel << 4);
+	// Switch MIDI number and detent width are saved in the second byte
+	buffer[1] = cfg->switch_midi_number | (extra->detent_width << 7);
+	// Active and Inactive colors are saved in the third and fourth bytes,
+	// with the two bits of detent capture strength in their top bits
+	buffer[2] = cfg->active_color | ((extra->detent_capture & 0x01) << 7);
+	buffer[3] = cfg->inactive_color | ((extra->detent_capture & 0x02) << 6);
+	// Has de-tent and de-tent color are saved in the 5th byte
+	buffer[4] = cfg->detent_color | (cfg->has_detent << 7);
+	// Encoder Indicator, Movement type & shifted MIDI channel are saved in the 6th byte
+	buffer[5] = cfg->indicator_display_type | (cfg->movement << 2) | (cfg->encoder_shift_midi_channel << 4);
+	// Encoder MIDI Type, end stop & MIDI channel are saved in the 7th byte
+	buffer[6] = cfg->encoder_midi_type | (extra->end_stop_size << 3) | (cfg->encoder_midi_channel << 4);
+	// Encoder MIDI number & is super knob flag are saved in the 8th byte
+	buffer[7] = cfg->encoder_midi_number | (cfg->is_super_knob << 7);
+}
+
+/**
+ * Packs one encoder or gesture settings page from the encoder_settings RAM
+ * table, as it is laid out in the EEPROM.
+ *
+ * \param page [in]		EEPROM page, from ENC_SETTINGS_START_PAGE to the last
+ *						gesture settings page
+ *
+ * \param buffer [out]	EEPROM_PAGE_SIZE bytes
+ */
+void encoders_pack_settings_page(uint8_t page, uint8_t *buffer)
+{
+	if (page < GESTURE_SETTINGS_START_PAGE) {
+		// Page 4 * bank + row holds banked encoders page * 4 onwards
+		uint8_t first = (page - ENC_SETTINGS_START_PAGE) * 4;
+		for (uint8_t column = 0; column < 4; ++column) {
+			pack_encoder_config(&encoder_settings[first + column], &encoder_extra_settings[first + column],
+								&buffer[column * ENC_EE_SIZE]);
+		}
+	} else {
+		const encoder_extra_config_t *extra = &encoder_extra_settings[(page - GESTURE_SETTINGS_START_PAGE) * PHYSICAL_ENCODERS];
+		for (uint8_t encoder = 0; encoder < PHYSICAL_ENCODERS; ++encoder) {
+			buffer[(encoder * GESTURE_EE_SIZE)] = extra[encoder].gesture_long_press_time;
+			buffer[(encoder * GESTURE_EE_SIZE) + 1] = extra[encoder].gesture_double_tap_time;
+		}
 	}
-	buffer_ptr++; // Full
+}
+
+/**
+ * Packs one changed settings page from the encoder_settings RAM table and
+ * queues it for the EEPROM, which skips pages that haven't really changed.
+ * Changes to a recalled preset are dropped instead, they only last until
+ * power off.
+ */
+static void encoder_config_queue_page(void)
+{
+	uint8_t page_buffer[EEPROM_PAGE_SIZE];
+	uint8_t page;
 	
-	// Encoder MIDI Type & MIDI channel are saved in the 7th byte
-	if (cfg_ptr->encoder_midi_type < 0x80){
-		*buffer_ptr &= ~0x07; // !Spring2019Update: Added Switch Velocity Control and Mouse Emulation
-		*buffer_ptr |= (0x07 & cfg_ptr->encoder_midi_type); // !Spring2019Update: Added Switch Velocity Control and Mouse Emulation
-	}
-	if (cfg_ptr->encoder_midi_channel < 0x80){
-		*buffer_ptr &= ~0xF0;
-		*buffer_ptr |= (0xF0 & ((cfg_ptr->encoder_midi_channel - 1) << 4));
+	if (preset_in_use()) {
+		encoder_page_dirty = 0;
+		gesture_page_dirty = 0;
+		return;
+	} else if (encoder_page_dirty) {
+		page = 0;
+		while (!(encoder_page_dirty & ((uint32_t)1 << page))) {
+			page++;
+		}
+		encoder_page_dirty &= ~((uint32_t)1 << page);
+		page += ENC_SETTINGS_START_PAGE;
+	} else if (gesture_page_dirty) {
+		uint8_t bank = 0;
+		while (!(gesture_page_dirty & (1 << bank))) {
+			bank++;
+		}
+		gesture_page_dirty &= ~(1 << bank);
+		page = GESTURE_SETTINGS_START_PAGE + bank;
+	} else {
+		return;
 	}
-	buffer_ptr++;	// 2-bits Open 0xC0
 	
-	// Encoder MIDI number & is super knob flag are saved in the 8th byte
-	if (cfg_ptr->encoder_midi_number < 0x80){
-		*buffer_ptr &= ~0x7F;
-		*buffer_ptr |= cfg_ptr->encoder_midi_number;
+	encoders_pack_settings_page(page, page_buffer);
+	config_store_write_page(page, page_buffer);
+}
+
+static void encoder_config_queue_all(void)
+{
+	while (encoder_page_dirty || gesture_page_dirty) {
+		encoder_config_queue_page();
 	}
-	if (cfg_ptr->is_super_knob < 0x80){
-		*buffer_ptr &= ~0x80;
-		*buffer_ptr |= (0x80 & (cfg_ptr->is_super_knob << 7));
+}
+
+/**
+ * Queues one changed encoder settings page for the EEPROM once the settings
+ * have not changed for ENCODER_CONFIG_HOLD_OFF mS, so a burst of changes to
+ * the same encoders costs one page write. Call once per main loop pass.
+ */
+void encoder_config_task(void)
+{
+	if (!(encoder_page_dirty || gesture_page_dirty)) {
+		return;
 	}
-	buffer_ptr++;  // Full
-	
-	uint8_t page_index = ENC_SETTINGS_START_PAGE + (4 * bank) + (encoder / 4);
-	
-	// Save the updated page buffer back to EEPROM
-	cpu_irq_disable();
-	nvm_eeprom_load_page_to_buffer(page_buffer);
-	nvm_eeprom_atomic_write_page(page_index);
-	cpu_irq_enable();
+	if ((uint16_t)((uint16_t)get_ms_timer() - encoder_config_edit_time) < ENCODER_CONFIG_HOLD_OFF) {
+		return;
+	}
+	encoder_config_queue_page();
+}
 
-	// !Summer2016Update: Match the newly changed input_map to match the output_map saved in eeprom
-	// - removed in favor of expanding encoder_map
-	//~ sync_input_map_to_output_map(bank*16 + encoder); // !Summer2016Update: midi_input_map bugfix
+/**
+ * Writes every changed encoder setting, their seal and the rest of
+ * the EEPROM queue back now, waiting for the writes to finish.
+ */
+void encoder_config_flush(void)
+{
+	encoder_config_queue_all();
+	config_store_flush();
 }
 
 /**
@@ -423,6 +613,10 @@ void save_encoder_config(uint8_t bank, uint8_t encoder, encoder_config_t *cfg_pt
 **/
 void factory_reset_encoder_config(void)
 {
+	// The defaults replace any changes waiting to be written
+	encoder_page_dirty = 0;
+	gesture_page_dirty = 0;
+	
 	// Create a table of the default settings common to all encoders
 	encoder_config_t enc_default;
 			
@@ -442,8 +636,6 @@ void factory_reset_encoder_config(void)
 	enc_default.encoder_shift_midi_channel = DEF_ENC_SHIFT_CH; // !Summer2016Update: Shifted Encoders MIDI Channel
 	 
 	// !Summer2016Update active/inactive colors modified to be fixed per bank
-	uint8_t color_map = eeprom_read_byte((uint8_t*)EE_COLOR_MAP);
-
 	uint8_t active_colors[NUM_BANKS] = {
 		DEF_ACTIVE_COLOR_BANK1_CLASSIC, DEF_ACTIVE_COLOR_BANK2_CLASSIC,
 		DEF_ACTIVE_COLOR_BANK3_CLASSIC, DEF_ACTIVE_COLOR_BANK4_CLASSIC,
@@ -529,11 +721,8 @@ void factory_reset_encoder_config(void)
 			// 8 = Settings Size
 		}
 
-		// Write the Page
-		cpu_irq_disable();
-		nvm_eeprom_load_page_to_buffer(page_buffer);
-		nvm_eeprom_atomic_write_page(page_index);
-		cpu_irq_enable();
+		// Queue the Page, the queue writes it back once it fills up or from the main loop
+		config_store_write_page(page_index, page_buffer);
 		
 		// Modify Mapping Parameters for the next item.
 		for(uint8_t j=0;j<4;++j){  // For each Data Page (Corresponds to 1 - Horizontal Row of Encoders)
@@ -542,6 +731,15 @@ void factory_reset_encoder_config(void)
 		}
 		page_index++;
 	}
+	
+	// Gesture times, one page per bank
+	for(uint8_t j=0;j<EEPROM_PAGE_SIZE;j+=GESTURE_EE_SIZE){
+		page_buffer[j]   = DEF_GESTURE_LONG_PRESS_TIME;
+		page_buffer[j+1] = DEF_GESTURE_DOUBLE_TAP_TIME;
+	}
+	for(uint8_t i=0;i<NUM_BANKS;++i){
+		config_store_write_page(GESTURE_SETTINGS_START_PAGE + i, page_buffer);
+	}
 }
 //void adjust_
 #if VELOCITY_CALC_METHOD > VELOCITY_CALC_M_NONE 
@@ -557,6 +755,7 @@ uint16_t convert_ticks_per_scan_to_value_multiplier(uint8_t tick_count, uint16_t
 }
 
 void send_midi_velocity_sensitive_encoder(uint8_t encoder_id, uint16_t output_value) { // DEPRECATED?
+	(void)encoder_id;
 	#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
 		uint8_t midi_channel = 0x0F;
 		uint16_t multiplier = convert_ticks_per_scan_to_value_multiplier(1, output_value+1); // !review: '1' no guarantee only 1 tick
@@ -606,22 +805,14 @@ void process_encoder_input_rotary(uint8_t i, uint8_t virtual_encoder_id, uint8_t
 
 	if (new_value) { // if Encoder Has Moved
     reset_idle_timer();
+		mark_encoder_display_dirty(i);
+		gesture_encoder_turned(i);
 		if(native_mode_process_encoder_input_rotary(i, new_value))
 			return;
 			
-		// --- Detents and Deadzones
-		#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
-		if (process_encoder_input_rotary_detent(i, virtual_encoder_id, banked_encoder_id, new_value, cycle_count)) { }
-		#else
-		if (process_encoder_input_rotary_detent(i, virtual_encoder_id, banked_encoder_id, new_value)) { }
-		#endif
-		// everything has been done in 'pei_detent', if that function returned true
-		#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
-		else if (process_encoder_input_rotary_deadzone(i, virtual_encoder_id, banked_encoder_id, new_value, cycle_count)) {}
-		#else
-		else if (process_encoder_input_rotary_deadzone(i, virtual_encoder_id, banked_encoder_id, new_value)) {}
-		#endif
-		// everything has been done in 'pei_deadzone', if that function returned true
+		// --- Detents and End Stops
+		if (process_encoder_input_rotary_capture(i, virtual_encoder_id, banked_encoder_id, new_value)) { }
+		// everything has been done in 'pei_capture', if that function returned true
 		else { // Encoder Event Occurred, and Encoder is not in a Detent or Deadzone.
 			// TODO TIDY THIS ALL UP - NEED TO RETHINK FUNCTION TOPOGRAPHY FOR ENCODERS *?
 			#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
@@ -646,70 +837,85 @@ void process_encoder_input_rotary(uint8_t i, uint8_t virtual_encoder_id, uint8_t
 
 }
 
-#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
-bool process_encoder_input_rotary_detent(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value, uint16_t cycle_count)
-#else
-bool process_encoder_input_rotary_detent(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value)
-#endif
+/**
+ * Detents and end stops share a single state machine per physical encoder. 
+ * The zone is worked out from the raw value every time the encoder moves, 
+ * and the tick counter restarts whenever the encoder enters a new zone (or 
+ * a different virtual encoder is being turned) so leftover travel from one 
+ * zone can never release the encoder from the next.
+ *
+ * Only absolute encoders are captured, relative encoders have no position.
+ *
+ * \return true if the movement was absorbed by a detent or end stop
+ */
+bool process_encoder_input_rotary_capture(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value)
 {
-	if (!encoder_settings[banked_encoder_id].has_detent) {
-		//midi_stream_raw_cc(9,99,1);
-		return false;
-	} else if (!encoder_is_in_detent(raw_encoder_value[virtual_encoder_id])) {
-		//midi_stream_raw_cc(9,99,2);
+	encoder_config_t *cfg = &encoder_settings[banked_encoder_id];
+	encoder_extra_config_t *extra = &encoder_extra_settings[banked_encoder_id];
+	int16_t value = raw_encoder_value[virtual_encoder_id];
+	
+	if (encoder_midi_type_is_relative(i)) {
 		return false;
 	}
-
-
-	encoder_detent_counter[i] += new_value;
-	if (encoder_detent_counter[i] > g_detent_size){ // Exiting detent (CW)
-		//raw_encoder_value[virtual_encoder_id] = 6500;
-		raw_encoder_value[virtual_encoder_id] = encoder_detent_limit_high;
-		//midi_stream_raw_cc(9,99,11);
-	} else if (encoder_detent_counter[i] < -g_detent_size) { // Exiting detent (CCW)
-		//raw_encoder_value[virtual_encoder_id] = 6200;
-		raw_encoder_value[virtual_encoder_id] = encoder_detent_limit_low;
-		//midi_stream_raw_cc(9,99,12);
-	} else { // Still In Detent
-		//midi_stream_raw_cc(9,99,13);
-		// Patch: Ensure the Detent LED is set even for higher resolution modes, like velocity sensitivity
-		indicator_value_buffer[encoder_bank][i] = 63;
-	}
-	return true;
-}
-
-// - Rotary Sub Function
-#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
-  bool process_encoder_input_rotary_deadzone(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value, uint16_t cycle_count)
-#else
-  bool process_encoder_input_rotary_deadzone(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value)
-#endif
-{
-	uint16_t value = raw_encoder_value[virtual_encoder_id];
-	if (encoder_settings[banked_encoder_id].encoder_midi_type == SEND_REL_ENC || encoder_settings[banked_encoder_id].encoder_midi_type == SEND_REL_ENC_MOUSE_EMU_DRAG || encoder_settings[banked_encoder_id].encoder_midi_type == SEND_REL_ENC_MOUSE_EMU_SCROLL) {
-		return false;
-	} else if (!encoder_is_in_deadzone(value)) {
-		return false;
+	
+	// Work out which zone we are in
+	uint8_t zone;
+	if (cfg->has_detent && value > detent_zone_low[extra->detent_width] && 
+						   value < detent_zone_high[extra->detent_width]) {
+		zone = CAPTURE_DETENT;
+	} else if (value < 1) {
+		zone = CAPTURE_END_LOW;
+	} else if (value > 12699) {
+		zone = CAPTURE_END_HIGH;
+	} else {
+		zone = CAPTURE_FREE;
 	}
-	// The encoder is in a end zone, only change the encoder value
-	//   once we have moved out of the dead zone.
-	if( ((raw_encoder_value[virtual_encoder_id] < 100) && (new_value > 0)) ||
-	((raw_encoder_value[virtual_encoder_id] > 12600) && (new_value < 0)) ) {
-		
-		encoder_detent_counter[i] += new_value;
+	
+	if (zone != encoder_capture_zone[i] || virtual_encoder_id != encoder_capture_owner[i]) {
+		encoder_capture_zone[i] = zone;
+		encoder_capture_owner[i] = virtual_encoder_id;
+		encoder_detent_counter[i] = 0;
 	}
-	// - Allow movement to get us out of the dead zone, if we've traveled enough.
-	if ((encoder_detent_counter[i] > g_dead_zone_size) &&
-	(raw_encoder_value[virtual_encoder_id] < 100)) { // CW
+	
+	switch (zone) {
+		case CAPTURE_DETENT:{
+			int8_t capture = detent_capture_ticks[extra->detent_capture];
+			encoder_detent_counter[i] += new_value;
+			if (encoder_detent_counter[i] > capture){ // Exiting detent (CW)
+				raw_encoder_value[virtual_encoder_id] = detent_zone_high[extra->detent_width];
+			} else if (encoder_detent_counter[i] < -capture) { // Exiting detent (CCW)
+				raw_encoder_value[virtual_encoder_id] = detent_zone_low[extra->detent_width];
+			} else { // Still In Detent
+				// Patch: Ensure the Detent LED is set even for higher resolution modes, like velocity sensitivity
+				indicator_value_buffer[encoder_bank][i] = 63;
+			}
+		}
+		break;
 		
-		raw_encoder_value[virtual_encoder_id] = 100;
-		encoder_detent_counter[i] = 0;
+		// In an end zone, only count movement away from the end and change the 
+		// encoder value once we have traveled far enough
+		case CAPTURE_END_LOW:{
+			if (new_value > 0) {
+				encoder_detent_counter[i] += new_value;
+			}
+			if (encoder_detent_counter[i] > end_stop_ticks[extra->end_stop_size]) {
+				raw_encoder_value[virtual_encoder_id] = 100;
+			}
+		}
+		break;
 		
-	} else if ((encoder_detent_counter[i] < -g_dead_zone_size) &&
-	(raw_encoder_value[virtual_encoder_id] > 12600)) {  // CCW
+		case CAPTURE_END_HIGH:{
+			if (new_value < 0) {
+				encoder_detent_counter[i] += new_value;
+			}
+			if (encoder_detent_counter[i] < -end_stop_ticks[extra->end_stop_size]) {
+				raw_encoder_value[virtual_encoder_id] = 12600;
+			}
+		}
+		break;
 		
-		raw_encoder_value[virtual_encoder_id] = 12600;
-		encoder_detent_counter[i] = 0;
+		default:
+			return false;
 	}
 	return true;
 }
@@ -721,6 +927,7 @@ bool process_encoder_input_rotary_detent(uint8_t i, uint8_t virtual_encoder_id,
   bool process_encoder_input_rotary_relative(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value, uint16_t bit)
 #endif
 {
+	(void)virtual_encoder_id;
 	if (!(encoder_settings[banked_encoder_id].encoder_midi_type == SEND_REL_ENC || encoder_settings[banked_encoder_id].encoder_midi_type == SEND_REL_ENC_MOUSE_EMU_DRAG || encoder_settings[banked_encoder_id].encoder_midi_type == SEND_REL_ENC_MOUSE_EMU_SCROLL)) {
 		return false;
 	}
@@ -855,7 +1062,11 @@ bool process_encoder_input_rotary_detent(uint8_t i, uint8_t virtual_encoder_id,
 #endif
 
 void process_encoder_input_switch(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, uint16_t bit) {
-	
+
+	if (bit & (get_enc_switch_down() | get_enc_switch_up())) {
+		mark_encoder_display_dirty(i);
+	}
+
 	if (get_bank_select_active()) {
 		if (bit & get_enc_switch_down()) {
 			uint8_t target_bank = i % NUM_BANKS;
@@ -867,6 +1078,13 @@ void process_encoder_input_switch(uint8_t i, uint8_t virtual_encoder_id, uint8_t
 		}
 		return;
 	}
+	
+	// Gesture actions also need the held state, so they are handled separately
+	if (encoder_settings[banked_encoder_id].switch_action_type >= ENC_LONG_PRESS &&
+		encoder_settings[banked_encoder_id].switch_action_type <= ENC_PRESS_TURN) {
+		process_encoder_input_switch_gesture(i, virtual_encoder_id, banked_encoder_id, bit);
+		return;
+	}
 
 	if (bit & get_enc_switch_down() || bit & get_enc_switch_up()) {
 		reset_idle_timer(); 
@@ -1055,6 +1273,78 @@ void process_encoder_input_switch(uint8_t i, uint8_t virtual_encoder_id, uint8_t
 		}
 	}
 }
+
+/**
+ * Handles the gesture switch actions. The gesture recognizer is fed every 
+ * switch event, including held, so long-presses can be reported while the
+ * switch is still down.
+ */
+void process_encoder_input_switch_gesture(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, uint16_t bit) {
+	
+	switch_event_t event;
+	if (bit & get_enc_switch_down()) {
+		event = SW_DOWN;
+	} else if (bit & get_enc_switch_up()) {
+		event = SW_UP;
+	} else if (bit & get_enc_switch_state()) {
+		event = SW_HELD;
+	} else {
+		return;
+	}
+	
+	if (event != SW_HELD) {
+		reset_idle_timer();
+		if(native_mode_process_encoder_input_switch_pressed(i, event == SW_DOWN))
+			return;
+	}
+	
+	encoder_config_t *cfg = &encoder_settings[banked_encoder_id];
+	encoder_extra_config_t *extra = &encoder_extra_settings[banked_encoder_id];
+	gesture_t gesture = gesture_process(i, event, 
+							gesture_time_or_default(extra->gesture_long_press_time, DEF_GESTURE_LONG_PRESS_TIME),
+							gesture_time_or_default(extra->gesture_double_tap_time, DEF_GESTURE_DOUBLE_TAP_TIME),
+							cfg->switch_action_type == ENC_DOUBLE_TAP ? GESTURE_DOUBLE_TAP : GESTURE_NONE);
+	
+	switch (cfg->switch_action_type)
+	{
+		case ENC_LONG_PRESS:{}
+		// cascade to the next case ... NO BREAK ON PURPOSE
+		case ENC_DOUBLE_TAP:{
+			if ((cfg->switch_action_type == ENC_LONG_PRESS && gesture == GESTURE_LONG_PRESS) ||
+				(cfg->switch_action_type == ENC_DOUBLE_TAP && gesture == GESTURE_DOUBLE_TAP)) {
+				enc_switch_midi_state[encoder_bank][i] = 127;
+			} else if (gesture == GESTURE_RELEASE && enc_switch_midi_state[encoder_bank][i]) {
+				enc_switch_midi_state[encoder_bank][i] = 0;
+			} else {
+				break;
+			}
+			// Update the display
+			if (!color_overide_active(encoder_bank,i)) {
+				switch_color_buffer[encoder_bank][i] = enc_switch_midi_state[encoder_bank][i] ?
+				cfg->active_color : cfg->inactive_color;
+				mark_encoder_display_dirty(i);
+			}
+			// And send any MIDI
+			send_element_midi(SWITCH, banked_encoder_id, enc_switch_midi_state[encoder_bank][i],
+			enc_switch_midi_state[encoder_bank][i]);
+		}
+		break;
+		
+		case ENC_PRESS_TURN:{
+			// While the switch is held the encoder controls its shifted value, so 
+			// show whichever value the encoder is now controlling
+			if (event != SW_HELD) {
+				indicator_value_buffer[encoder_bank][i]=(uint8_t)(raw_encoder_value[virtual_encoder_id]/100);
+			}
+			// A click without turning sends a momentary CC
+			if (gesture == GESTURE_TAP) {
+				send_element_midi(SWITCH, banked_encoder_id, 127, true);
+				send_element_midi(SWITCH, banked_encoder_id, 0, false);
+			}
+		}
+		break;
+	}
+}
 // ======================== Process Encoder Input Functions==================END=
 
 
@@ -1069,6 +1359,7 @@ void process_encoder_input_switch(uint8_t i, uint8_t virtual_encoder_id, uint8_t
 void run_shift_mode(uint8_t page){
 	
 	static uint8_t idx = 0x00;
+	uint8_t budget = DISPLAY_UPDATES_PER_PASS;
 	
 	// First we check the encoder switch states and send any MIDI
 	update_encoder_switch_state();
@@ -1097,19 +1388,39 @@ void run_shift_mode(uint8_t page){
 		bit <<=1;
 	}
 		
-	// The we update the display.
-	if (shift_mode_switch_state[page] & (0x01<<idx)){
-		// Set the LEDs on
-		set_encoder_rgb(idx, 0);
-		set_encoder_indicator(idx,127, false, BAR, 0);
-	} else {
-		set_encoder_rgb(idx, 0);
-		set_encoder_indicator(idx,0, false, BAR, 0);
+	// The we update the display, redrawing only the encoders whose state has
+	// changed since they were drawn
+	uint16_t changed = (shift_mode_switch_state[page] ^ shift_mode_drawn_state) | ~shift_mode_drawn_valid;
+	for (uint8_t n = 0; changed && budget && n < 16; ++n) {
+		bit = 0x0001 << idx;
+		if (changed & bit) {
+			if (shift_mode_switch_state[page] & bit){
+				// Set the LEDs on
+				set_encoder_rgb(idx, 0);
+				set_encoder_indicator(idx,127, false, BAR, 0);
+				shift_mode_drawn_state |= bit;
+			} else {
+				set_encoder_rgb(idx, 0);
+				set_encoder_indicator(idx,0, false, BAR, 0);
+				shift_mode_drawn_state &= ~bit;
+			}
+			shift_mode_drawn_valid |= bit;
+			budget--;
+		}
+		
+		// Increment the encoder index for next time
+		idx += 1;
+		if(idx > 15){idx = 0;}
 	}
-	
-	// Increment the encoder index for next time
-	idx += 1;
-	if(idx > 15){idx = 0;}
+}
+
+/**
+ * Forces every encoder to be redrawn the next time shift mode runs, for when
+ * the display has been showing something else.
+ */
+void invalidate_shift_mode_display(void)
+{
+	shift_mode_drawn_valid = 0x0000;
 }
 
 //void send_encoder_pitchbend(uint8_t midi_channel, uint16_t value, bool state, bool shifted) {
@@ -1118,6 +1429,7 @@ void run_shift_mode(uint8_t page){
 
 void send_encoder_midi(uint8_t banked_encoder_idx, uint8_t value, bool state, bool shifted)
 {
+	(void)state;
 	uint8_t midi_channel = shifted ? encoder_settings[banked_encoder_idx].encoder_shift_midi_channel: encoder_settings[banked_encoder_idx].encoder_midi_channel;
 	// !revision resuse unused switch midi number for shifts: midi_number = shifted? encoder_midi_num/ switch_midi_num 20190806 
 	// Sending encoder as note is not useful so this can likely be simplified
@@ -1244,7 +1556,10 @@ void send_element_midi(enc_control_type_t type, uint8_t banked_encoder_idx, uint
 				encoder_settings[banked_encoder_idx].switch_action_type == ENC_SHIFT_HOLD ||
 				encoder_settings[banked_encoder_idx].switch_action_type == ENC_SHIFT_TOGGLE ||
 				encoder_settings[banked_encoder_idx].switch_action_type == ENC_RESET_VALUE ||
-				encoder_settings[banked_encoder_idx].switch_action_type == ENC_RESET_VALUE_INV){
+				encoder_settings[banked_encoder_idx].switch_action_type == ENC_RESET_VALUE_INV ||
+				encoder_settings[banked_encoder_idx].switch_action_type == ENC_LONG_PRESS ||
+				encoder_settings[banked_encoder_idx].switch_action_type == ENC_DOUBLE_TAP ||
+				encoder_settings[banked_encoder_idx].switch_action_type == ENC_PRESS_TURN){
 					
 				uint8_t adj_val = adjust_switch_value_by_encoder_value(banked_encoder_idx, value, state);
 				//midi_stream_raw_cc(encoder_settings[banked_encoder_idx].switch_midi_channel, 
@@ -1310,6 +1625,7 @@ void send_element_midi(enc_control_type_t type, uint8_t banked_encoder_idx, uint
 
 void process_element_midi(uint8_t channel, uint8_t type, uint8_t number, uint8_t value, uint8_t state) // Midi Feedback - Main Routine
 {
+	(void)state;
 	if(native_mode_consume_midi_event(type, channel, number, value))
 		return;
 	
@@ -1464,6 +1780,7 @@ void process_indicator_update(uint8_t idx, uint8_t value, uint8_t rx_msg_shifted
 			raw_encoder_value[virtual_encoder_id] = raw_value;
 			if (current_shift_state == rx_msg_shifted_mapping) { // If Value is currently on display, update the display
 				indicator_value_buffer[bank][encoder] = value;
+				mark_encoder_display_dirty(encoder);
 			}
 		}	
 	} else {
@@ -1497,6 +1814,9 @@ void process_sw_rgb_update(uint8_t idx, uint8_t value) // Midi Feedback - Switch
 		switch_color_overide[bank] |= (0x01<<encoder);
 		switch_color_buffer[bank][encoder] = encoder_settings[idx].active_color;
 	}
+	if (bank == current_encoder_bank()) {
+		mark_encoder_display_dirty(encoder);
+	}
 }
 
 // Midi Feedback - Switch Stored Toggle State (RGB LEDs) - !Summer2016Update
@@ -1547,6 +1867,9 @@ void process_sw_encoder_shift_update(uint8_t idx, uint8_t value){
 	if (encoder_is_in_shift_state(bank, encoder))
 		{virtual_encoder_id += BANKED_ENCODERS;}
 	indicator_value_buffer[bank][encoder]=(uint8_t)(raw_encoder_value[virtual_encoder_id]/100); // update display buffer
+	if (bank == current_encoder_bank()) {
+		mark_encoder_display_dirty(encoder);
+	}
 }
 
 void process_sw_animation_update(uint8_t idx, uint8_t value)
@@ -1554,6 +1877,9 @@ void process_sw_animation_update(uint8_t idx, uint8_t value)
 	uint8_t bank = idx / 16;
 	uint8_t encoder = idx % 16;
 	switch_animation_buffer[bank][encoder] = value;
+	if (bank == current_encoder_bank()) {
+		mark_encoder_display_dirty(encoder);
+	}
 }
 
 void process_encoder_animation_update(uint8_t idx, uint8_t value)	// !Summer2016Update: dual animations
@@ -1561,11 +1887,15 @@ void process_encoder_animation_update(uint8_t idx, uint8_t value)	// !Summer2016
 	uint8_t bank = idx / 16;
 	uint8_t encoder = idx % 16;
 	encoder_animation_buffer[bank][encoder] = value;
+	if (bank == current_encoder_bank()) {
+		mark_encoder_display_dirty(encoder);
+	}
 }
 
 void process_shift_update(uint8_t idx, uint8_t value)
 {
-	
+	(void)idx;
+	(void)value;
 }
 
 /**
@@ -1579,6 +1909,19 @@ static uint8_t prevSwitchColorValue[16];
 static uint8_t prevEncoderAnimationValue[16];
 static uint8_t prevSwAnimationValue[16];
 
+// Display scheduler state, 1-bit per physical encoder. Encoders marked dirty by
+// input or MIDI feedback are redrawn first, then any running animations, and
+// the remaining budget sweeps the rest to catch buffer writes nobody marked.
+static uint16_t display_dirty_mask = 0xFFFF;
+static uint16_t display_animation_mask;
+static uint8_t display_animation_tick;
+static uint8_t display_sweep_idx;
+
+// Time from the last bank change until all of its encoders were redrawn
+uint16_t bank_change_time;
+static uint16_t bank_change_start;
+static bool bank_change_timing;
+
 // - Switch Animations 1-48, 127
 bool animation_is_switch_rgb(uint8_t animation_value) { // !Summer2016Update: Dual Animations - Identify to Eliminate Conflicts
 	if (!animation_value) {return false;}
@@ -1687,15 +2030,72 @@ static void update_encoder_display_single(const uint8_t idx)
 	}
 }
 
+/**
+ * Marks an encoder's display as needing a redraw, it will be drawn ahead of
+ * the background sweep on the next call to update_encoder_display.
+ *
+ * \param[in] encoder		The physical encoder (0-15) to redraw.
+ */
+void mark_encoder_display_dirty(uint8_t encoder)
+{
+	display_dirty_mask |= (0x0001 << (encoder & 0x0F));
+}
+
+/**
+ * Returns the bit of the highest priority encoder in mask, lowest encoder first.
+ */
+static uint8_t display_mask_first(uint16_t mask)
+{
+	uint8_t idx = 0;
+	while (!(mask & 0x0001)) {
+		mask >>= 1;
+		idx++;
+	}
+	return idx;
+}
+
+/**
+ * Redraws up to DISPLAY_UPDATES_PER_PASS encoders. Dirty encoders are drawn
+ * first, then animated encoders once per animation step, and any budget left
+ * over is spent on a round robin sweep.
+ */
 void update_encoder_display(void)
-{	
-	static uint8_t idx = 0;
-	
-	update_encoder_display_single(idx);
-	
-	// Increment the encoder index for next time
-	idx += 1;
-	if(idx > 15){idx = 0;}
+{
+	uint8_t budget = DISPLAY_UPDATES_PER_PASS;
+
+	// Four times an animation step every encoder with an animation running (or
+	// just stopped) needs a redraw, so pulses follow the fraction of the step
+	if (display_animation_tick != (uint8_t)(animation_phase >> 6)) {
+		display_animation_tick = (uint8_t)(animation_phase >> 6);
+		uint16_t bit = 0x0001;
+		for (uint8_t i = 0; i < PHYSICAL_ENCODERS; i++) {
+			if (encoder_animation_buffer[encoder_bank][i] || switch_animation_buffer[encoder_bank][i] ||
+				prevEncoderAnimationValue[i] || prevSwAnimationValue[i]) {
+				display_animation_mask |= bit;
+			}
+			bit <<= 1;
+		}
+	}
+
+	while (budget && (display_dirty_mask || display_animation_mask)) {
+		uint8_t idx = display_dirty_mask ? display_mask_first(display_dirty_mask) :
+										   display_mask_first(display_animation_mask);
+		uint16_t bit = 0x0001 << idx;
+		display_dirty_mask &= ~bit;
+		display_animation_mask &= ~bit;
+		update_encoder_display_single(idx);
+		budget--;
+	}
+
+	if (bank_change_timing && !display_dirty_mask) {
+		bank_change_time = tc_read_count(&TCC0) - bank_change_start;
+		bank_change_timing = false;
+	}
+
+	if (budget) {
+		update_encoder_display_single(display_sweep_idx);
+		display_sweep_idx = (display_sweep_idx + 1) & 0x0F;
+	}
 }
 
 /**
@@ -1707,6 +2107,9 @@ void update_encoder_display(void)
  */
 void change_encoder_bank(uint8_t new_bank) // Change Bank
 {
+	bank_change_start = tc_read_count(&TCC0);
+	bank_change_timing = true;
+
 	// Prepare the state buffers for the new bank
 	transfer_encoder_values_to_other_banks(encoder_bank);
 
@@ -1728,7 +2131,8 @@ void change_encoder_bank(uint8_t new_bank) // Change Bank
 
 		// Set the prev values to -1 which forces a display update
 		prevIndicatorValue[i] = -1;
-		prevSwitchColorValue[i] = -1;	
+		prevSwitchColorValue[i] = -1;
+		mark_encoder_display_dirty(i);
 		
 		// Read in all the encoder settings for the current bank
 		// - !Summer2016Update: Removed in favor of expanding encoder_settings to include all banks 
@@ -1750,6 +2154,9 @@ void change_encoder_bank(uint8_t new_bank) // Change Bank
 	} 
 	
 	encoder_bank = new_bank;                                                 
+
+	// Native mode draws its own display, which is also redrawn in full
+	native_mode_invalidate_display();
 }
 
 /**
@@ -1762,6 +2169,66 @@ uint8_t current_encoder_bank(void)
 	return encoder_bank;
 }
 
+/**
+ * Copies the state of a bank which isn't saved with the settings (the shift
+ * toggles, toggle switch states and encoder positions) for the journal.
+ *
+ * \param bank [in]		The bank
+ *
+ * \param buffer [out]	ENCODER_BANK_STATE_SIZE bytes
+ */
+void encoders_save_bank_state(uint8_t bank, uint8_t *buffer)
+{
+	uint16_t switch_state = 0;
+	
+	buffer[0] = enc_switch_toggle_state[bank] & 0xFF;
+	buffer[1] = enc_switch_toggle_state[bank] >> 8;
+	for (uint8_t i = 0; i < 16; ++i) {
+		uint8_t banked_encoder_id = get_virtual_encoder_id(bank, i);
+		uint8_t action = encoder_settings[banked_encoder_id].switch_action_type;
+		
+		if ((action == CC_TOGGLE || action == NOTE_TOGGLE) && enc_switch_midi_state[bank][i]) {
+			switch_state |= 0x0001 << i;
+		}
+		// Positions are kept to the nearest MIDI value
+		int16_t value = raw_encoder_value[banked_encoder_id];
+		buffer[4 + i] = (value > 0) ? scale_encoder_value(value) : 0;
+	}
+	buffer[2] = switch_state & 0xFF;
+	buffer[3] = switch_state >> 8;
+}
+
+/**
+ * Restores the state copied by encoders_save_bank_state(). The display is
+ * updated by the next bank change.
+ *
+ * \param bank [in]		The bank
+ *
+ * \param buffer [in]	ENCODER_BANK_STATE_SIZE bytes
+ */
+void encoders_restore_bank_state(uint8_t bank, const uint8_t *buffer)
+{
+	uint16_t switch_state = buffer[2] | ((uint16_t)buffer[3] << 8);
+	
+	enc_switch_toggle_state[bank] = buffer[0] | ((uint16_t)buffer[1] << 8);
+	for (uint8_t i = 0; i < 16; ++i) {
+		uint8_t banked_encoder_id = get_virtual_encoder_id(bank, i);
+		encoder_config_t *cfg = &encoder_settings[banked_encoder_id];
+		uint16_t bit = 0x0001 << i;
+		
+		if (cfg->switch_action_type == CC_TOGGLE || cfg->switch_action_type == NOTE_TOGGLE) {
+			enc_switch_midi_state[bank][i] = (switch_state & bit) ? 127 : 0;
+			switch_color_buffer[bank][i] = (switch_state & bit) ? cfg->active_color : cfg->inactive_color;
+		} else if (cfg->switch_action_type == ENC_SHIFT_TOGGLE) {
+			switch_color_buffer[bank][i] = (enc_switch_toggle_state[bank] & bit) ? cfg->active_color : cfg->inactive_color;
+		}
+		if (buffer[4 + i] < 0x80) {
+			raw_encoder_value[banked_encoder_id] = clamp_encoder_raw_value(buffer[4 + i] * 100);
+			indicator_value_buffer[bank][i] = buffer[4 + i];
+		}
+	}
+}
+
 /**
  * Convenience function which forces a refresh of the encoder display and values
  */
@@ -1845,6 +2312,7 @@ bool encoder_is_in_shift_state(uint8_t bank, uint8_t encoder)
 		 encoder_settings[encoder].switch_action_type == ENC_SHIFT_TOGGLE) &&
 	   ((get_enc_switch_state() & bit) || (enc_switch_toggle_state[bank] & bit)))*/ 
 	if ( ((encoder_settings[banked_encoder_idx].switch_action_type == ENC_SHIFT_HOLD)  && (get_enc_switch_state() & bit)) ||
+		 ((encoder_settings[banked_encoder_idx].switch_action_type == ENC_PRESS_TURN)  && (get_enc_switch_state() & bit)) ||
 		 ((encoder_settings[banked_encoder_idx].switch_action_type == ENC_SHIFT_TOGGLE) && (enc_switch_toggle_state[bank] & bit)) ) 
 	{
 		return true;
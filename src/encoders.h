@@ -69,6 +69,9 @@
 			ENC_FINE_ADJUST,
 			ENC_SHIFT_HOLD,
 			ENC_SHIFT_TOGGLE,
+			ENC_LONG_PRESS,		// CC 127 once held for the long-press time, 0 on release
+			ENC_DOUBLE_TAP,		// CC 127 on the second press of a double-tap, 0 on release
+			ENC_PRESS_TURN,		// A click sends CC 127/0, turning while held adjusts the shifted encoder
 		} enc_sw_action_type_t;
 	
 		// Encoder switch movement enum
@@ -108,6 +111,16 @@
 		// Tag-Value table which holds the configuration for 1 encoder
 		#define ENC_CFG_SIZE 15
 		#define ENC_REL_FINE_LIMIT 0x04 // how many 'ticks' per output when encoder is Relative and Fine
+		#define ENC_DETENT_CAPTURE_MASK 0x03
+		#define ENC_DETENT_WIDTH_MASK	0x01
+		#define ENC_END_STOP_MASK		0x01
+		
+		// Time without an encoder settings change before the changed
+		// settings pages are queued for the EEPROM
+		#define ENCODER_CONFIG_HOLD_OFF	500	// mS
+		
+		// Runtime state of one bank kept by the journal, see encoders_save_bank_state()
+		#define ENCODER_BANK_STATE_SIZE	20
 		typedef union {  // Each of these fields is designed to be written to directly from MIDI Sysex Data
 			struct {     // - so you can only use 7-bits of these uint8_t's to store data.
 				uint8_t			has_detent;
@@ -130,6 +143,34 @@
 			uint8_t bytes[ENC_CFG_SIZE];
 		} encoder_config_t;
 		
+		// Settings of 1 encoder which rarely change, kept in their own table
+		// so encoder_config_t stays small. The geometry shares one byte.
+		typedef struct {
+			uint8_t			gesture_long_press_time;	// x10ms, stored outside the packed encoder settings
+			uint8_t			gesture_double_tap_time;	// x10ms, stored outside the packed encoder settings
+			uint8_t			detent_capture	: 2;		// 0-3, ticks needed to leave the detent
+			uint8_t			detent_width	: 1;		// 0-1, normal or wide detent window
+			uint8_t			end_stop_size	: 1;		// 0-1, ticks needed to leave an end stop
+		} encoder_extra_config_t;
+		
+		// Tag table of one SysEx settings transfer, the encoder_config_t tags
+		// followed by the encoder_extra_config_t tags
+		#define ENC_XFER_SIZE 20
+		typedef union {
+			struct {
+				encoder_config_t	config;
+				uint8_t			gesture_long_press_time;
+				uint8_t			gesture_double_tap_time;
+				uint8_t			detent_capture;
+				uint8_t			detent_width;
+				uint8_t			end_stop_size;
+			};
+			uint8_t bytes[ENC_XFER_SIZE];
+		} encoder_transfer_t;
+		
+		// Reads one settings page, laid out as in the EEPROM, in to buffer
+		typedef void (*settings_page_reader_t)(uint8_t page, uint8_t *buffer);
+		
 
 		/* Constants */
 		extern const uint16_t encoder_detent_limit_low;
@@ -141,35 +182,41 @@
 		//extern encoder_config_t encoder_settings[64];
 		extern uint8_t indicator_value_buffer[NUM_BANKS][16];
 		extern encoder_config_t encoder_settings[NUM_BANKS * PHYSICAL_ENCODERS];
+		extern encoder_extra_config_t encoder_extra_settings[NUM_BANKS * PHYSICAL_ENCODERS];
+		extern uint16_t bank_change_time;		// TCC0 counts (8 uS) to redraw the last bank change
 		// - overall, the use of input_map over an enlarged encoder_settings saves about 236 Bytes of RAM (624->960)
 		// -- But logically, the use of encoder_settings is a much simpler and faster implementation
 
 		/* Function Prototypes: */
 		void get_encoder_config(uint8_t bank, uint8_t encoder, encoder_config_t *cfg_ptr);
-		void save_encoder_config(uint8_t bank, uint8_t encoder, encoder_config_t *cfg_ptr);
+		void save_encoder_config(uint8_t bank, uint8_t encoder, encoder_transfer_t *cfg_ptr);
 		void factory_reset_encoder_config(void);
+		void encoder_config_task(void);
+		void encoder_config_flush(void);
 		
 		void encoders_init(void);
+		void encoders_load_settings(settings_page_reader_t read_page);
+		void encoders_pack_settings_page(uint8_t page, uint8_t *buffer);
 		void process_encoder_input_rotary(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, uint16_t bit);
 
 		#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
 			bool process_encoder_input_rotary_relative(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value, uint16_t bit, uint16_t cycle_count);
 			bool process_encoder_input_rotary_absolute(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value, uint16_t bit, uint16_t cycle_count);
-			bool process_encoder_input_rotary_detent(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value, uint16_t cycle_count);
-			bool process_encoder_input_rotary_deadzone(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value, uint16_t cycle_count);
 		#else
 			bool process_encoder_input_rotary_relative(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value, uint16_t bit);
 			bool process_encoder_input_rotary_absolute(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value, uint16_t bit);
-			bool process_encoder_input_rotary_detent(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value);
-			bool process_encoder_input_rotary_deadzone(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value);
 		#endif
+		bool process_encoder_input_rotary_capture(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, int8_t new_value);
 
 
 		void process_encoder_input_switch(uint8_t i, uint8_t virtual_encoder_id, uint8_t banked_encoder_id, uint16_t bit);
 		void process_encoder_input(void);
 		void update_encoder_display(void);
+		void mark_encoder_display_dirty(uint8_t encoder);
 		void change_encoder_bank(uint8_t new_bank);
 		uint8_t current_encoder_bank(void);
+		void encoders_save_bank_state(uint8_t bank, uint8_t *buffer);
+		void encoders_restore_bank_state(uint8_t bank, const uint8_t *buffer);
 		void refresh_display(void);
 		
 		void process_element_midi(uint8_t channel, uint8_t type, uint8_t number, uint8_t value, uint8_t state);
@@ -182,6 +229,7 @@
 		void process_shift_update(uint8_t idx, uint8_t value);
 		
 		void run_shift_mode(uint8_t page);
+		void invalidate_shift_mode_display(void);
 		
 		uint8_t scale_encoder_value(int16_t value);
 		int16_t clamp_encoder_raw_value(int16_t value);
@@ -0,0 +1,158 @@
+/*
+ * gesture.c
+ *
+ * Switch gesture recognition. Each switch slot keeps the time of its last
+ * press and release, the recognizer is fed the debounced switch edges once
+ * per main loop pass and returns at most one gesture per call.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <gesture.h>
+
+#include <string.h>
+
+// Gesture state flags
+#define GF_PRESSED			0x01	// Switch is currently down
+#define GF_GESTURE_SENT		0x02	// A gesture has been reported for this press
+#define GF_TURNED			0x04	// The encoder was turned during this press
+#define GF_TAP_ARMED		0x08	// The last press was a tap, a second press may be a double-tap
+
+typedef struct {
+	uint16_t down_time;		// ms_timer (low 16-bits) when the switch was pressed
+	uint16_t release_time;	// ms_timer (low 16-bits) when the switch was released
+	uint8_t  tap_window;	// Double-tap time (x10ms) in force when the tap was released
+	uint8_t  flags;
+} gesture_state_t;
+
+static gesture_state_t gesture_state[GESTURE_NUM_SWITCHES];
+
+void gesture_init(void)
+{
+	memset(gesture_state, 0x00, sizeof(gesture_state));
+}
+
+/**
+ * Returns the stored gesture time, or the default if the stored value is not 
+ * set (0) or invalid (erased EEPROM reads as 0xFF).
+ */
+uint8_t gesture_time_or_default(uint8_t time, uint8_t default_time)
+{
+	if (time == 0 || time > 0x7F) {
+		return default_time;
+	}
+	return time;
+}
+
+/**
+ * Advances the gesture recognizer for a single switch and returns the gesture
+ * (if any) recognized by this event. Only 16-bits of the ms_timer are used, 
+ * which is plenty for the time differences we are interested in.
+ *
+ * \param sw [in]				Gesture slot, 0-15 encoder switches, 16-21 side switches
+ *
+ * \param event [in]			The debounced switch event for this main loop pass
+ *
+ * \param long_press_time [in]	Long press threshold (x10ms)
+ *
+ * \param double_tap_time [in]	Maximum time between a tap and the next press (x10ms)
+ *
+ * \param wanted [in]			The gesture the switch action uses. A press soon after
+ *								a tap is only taken as a double-tap when this is
+ *								GESTURE_DOUBLE_TAP, otherwise it is a new press which
+ *								can still become a long-press.
+ *
+ * \return the recognized gesture or GESTURE_NONE
+ */
+gesture_t gesture_process(uint8_t sw, switch_event_t event, uint8_t long_press_time, 
+						  uint8_t double_tap_time, gesture_t wanted)
+{
+	gesture_state_t *g = &gesture_state[sw];
+	uint16_t now = (uint16_t)get_ms_timer();
+	
+	switch (event) {
+		case SW_DOWN:{
+			bool is_double_tap = wanted == GESTURE_DOUBLE_TAP && (g->flags & GF_TAP_ARMED) &&
+				((uint16_t)(now - g->release_time) <= (uint16_t)double_tap_time * GESTURE_TIME_UNIT_MS);
+			g->down_time = now;
+			g->flags = GF_PRESSED;
+			if (is_double_tap) {
+				g->flags |= GF_GESTURE_SENT;
+				return GESTURE_DOUBLE_TAP;
+			}
+		}
+		break;
+		
+		case SW_HELD:{
+			if (g->flags & GF_GESTURE_SENT) {
+				break;
+			}
+			// Turning takes precedence, a press that has been turned is never a long-press
+			if (g->flags & GF_TURNED) {
+				g->flags |= GF_GESTURE_SENT;
+				return GESTURE_PRESS_TURN;
+			}
+			if ((uint16_t)(now - g->down_time) >= (uint16_t)long_press_time * GESTURE_TIME_UNIT_MS) {
+				g->flags |= GF_GESTURE_SENT;
+				return GESTURE_LONG_PRESS;
+			}
+		}
+		break;
+		
+		case SW_UP:{
+			uint8_t flags = g->flags;
+			g->release_time = now;
+			g->flags = 0;
+			if (flags & (GF_GESTURE_SENT | GF_TURNED)) {
+				return GESTURE_RELEASE;
+			}
+			g->flags = GF_TAP_ARMED;
+			g->tap_window = double_tap_time;
+			return GESTURE_TAP;
+		}
+		break;
+	}
+	return GESTURE_NONE;
+}
+
+/**
+ * Disarms any tap whose double-tap window has passed. Only 16-bits of the
+ * ms_timer are kept, so without this a press some multiple of 65.5 seconds
+ * after a tap would be seen as a double-tap. Called once per main loop pass.
+ */
+void gesture_task(void)
+{
+	uint16_t now = (uint16_t)get_ms_timer();
+	
+	for (uint8_t sw = 0; sw < GESTURE_NUM_SWITCHES; ++sw) {
+		gesture_state_t *g = &gesture_state[sw];
+		if ((g->flags & GF_TAP_ARMED) &&
+			(uint16_t)(now - g->release_time) > (uint16_t)g->tap_window * GESTURE_TIME_UNIT_MS) {
+			g->flags &= ~GF_TAP_ARMED;
+		}
+	}
+}
+
+/**
+ * Marks the encoder as having been turned while its switch is held, the next
+ * call to gesture_process for that switch will report GESTURE_PRESS_TURN.
+ */
+void gesture_encoder_turned(uint8_t sw)
+{
+	if (gesture_state[sw].flags & GF_PRESSED) {
+		gesture_state[sw].flags |= GF_TURNED;
+	}
+}
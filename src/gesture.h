@@ -0,0 +1,70 @@
+/*
+ * gesture.h
+ *
+ * Recognizes timing based switch gestures (long-press, double-tap and
+ * press-and-turn) from the debounced switch edges and the ms_timer, so
+ * the decision is made on the device rather than by the host.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+
+#ifndef GESTURE_H_
+#define GESTURE_H_
+
+/*	Includes: */
+	#include <asf.h>
+	#include <input.h>
+	#include <encoders.h>
+
+/*	Macros: */
+
+	// Gesture slots: 16 encoder switches followed by the 6 side switches
+	#define GESTURE_SIDE_SWITCH_OFFSET	16
+	#define GESTURE_NUM_SWITCHES		(GESTURE_SIDE_SWITCH_OFFSET + 6)
+	
+	// Gesture thresholds are stored as 7-bit values in units of 10ms so
+	// they can be transferred directly in SysEx (0 - 1.27 seconds)
+	#define GESTURE_TIME_UNIT_MS		10
+	#define DEF_GESTURE_LONG_PRESS_TIME	50	// 500ms
+	#define DEF_GESTURE_DOUBLE_TAP_TIME	30	// 300ms
+
+/*	Types: */
+
+	// Events returned by the gesture recognizer
+	typedef enum {
+		GESTURE_NONE,
+		GESTURE_TAP,			// Released before the long-press time, without turning
+		GESTURE_LONG_PRESS,		// Held for the long-press time (reported once per press)
+		GESTURE_DOUBLE_TAP,		// Pressed a second time within the double-tap window
+		GESTURE_PRESS_TURN,		// Encoder turned while the switch is held (reported once per press)
+		GESTURE_RELEASE,		// Released after one of the above gestures was reported
+	} gesture_t;
+
+/* Function Prototypes: */
+
+	void gesture_init(void);
+	
+	gesture_t gesture_process(uint8_t sw, switch_event_t event, uint8_t long_press_time, 
+							  uint8_t double_tap_time, gesture_t wanted);
+	
+	void gesture_encoder_turned(uint8_t sw);
+	
+	void gesture_task(void);
+	
+	uint8_t gesture_time_or_default(uint8_t time, uint8_t default_time);
+
+#endif /* GESTURE_H_ */
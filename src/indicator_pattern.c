@@ -0,0 +1,95 @@
+/*
+ * indicator_pattern.c
+ *
+ * Indicator ring patterns. The display type, detent setting and position
+ * select a precomputed entry, which avoids float math on every update.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+
+#include <indicator_pattern.h>
+
+/** 
+ * Takes a variety of indicator display settings as input and builds two 16 
+ * bit masks with individual brightness settings as output. These masks set the 
+ * brightness of the 11 white LEDs and the Red Blue de-tent Indicator color
+ * given for the given display type and de tent settings.
+ *
+ * Inputs: 
+ * result:      A pointer to an inidcator_bit_frame struct to store the result
+ * position:	The 7bit encoder indicator position (0 - 127)
+ * type:		The type of display to build
+ * has_detent	If the encoder uses a virtual de tent
+ * detent_color The de tent indicator color setting for the indicator
+ *
+ * Output:		1 if valid result
+**/ 
+ 
+int build_indicator_pattern(indicator_bit_mask_t *result, 
+							uint8_t position, 
+							uint16_t type, 
+							bool has_detent, 
+							uint8_t detent_color)
+{
+	uint8_t table;
+	
+	position &= (INDICATOR_POSITIONS - 1);
+	
+	// Unknown display types have always been drawn as a dot
+	if (type >= INDICATOR_TYPES) {
+		type = INDICATOR_TYPE_DOT;
+	}
+	
+	if (type == INDICATOR_TYPE_SPREAD_BAR) {
+		// The spread bar ignores the detent setting
+		if (position == 0) {
+			result->pattern_A = 0;
+			result->pattern_A_brightness = 0;
+			result->pattern_B = 0;
+			result->pattern_B_brightness = 0;
+			return 1;
+		}
+		table = INDICATOR_TYPE_SPREAD_BAR;
+	} else if (has_detent) {
+		if (position == 63 || position == 64 ) {
+			// The encoder is in its detent position, set the detent indicator
+			// to its color and return.
+			result->pattern_A = 0x0001;  // detent color 1 flag 
+			result->pattern_B = 0x0002;  // detent color 2 flag
+			result->pattern_A_brightness = (uint8_t)(detent_color);
+			result->pattern_B_brightness = (uint8_t)(0x7F - (detent_color));
+			return 1;
+		}
+		table = INDICATOR_TYPES + type;
+	} else {
+		table = type;
+	}
+	
+	const indicator_table_entry_t *entry = &indicator_table[table][position];
+	result->pattern_A = pgm_read_word(&entry->pattern_A);
+	result->pattern_B = pgm_read_word(&entry->pattern_B);
+	result->pattern_A_brightness = pgm_read_byte(&entry->pattern_A_brightness);
+	
+	// The spread bar cross fades between its patterns, the others only 
+	// blend Pattern A in over a solid Pattern B
+	if (table == INDICATOR_TYPE_SPREAD_BAR) {
+		result->pattern_B_brightness = 127 - result->pattern_A_brightness;
+	} else {
+		result->pattern_B_brightness = 127;
+	}
+	return 1;	
+}
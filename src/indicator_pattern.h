@@ -0,0 +1,71 @@
+/*
+ * indicator_pattern.h
+ *
+ * Builds the LED patterns for the encoder indicator rings from precomputed
+ * tables, see tools/indicator_tables for how the tables are generated.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+
+#ifndef INDICATOR_PATTERN_H_
+#define INDICATOR_PATTERN_H_
+
+/*	Includes: */
+	#include <stdint.h>
+	#include <stdbool.h>
+	#include <avr/pgmspace.h>
+
+/*	Macros: */
+	// Indicator display types, these match display_type_t in encoders.h
+	#define INDICATOR_TYPE_DOT			0
+	#define INDICATOR_TYPE_BAR			1
+	#define INDICATOR_TYPE_BLENDED_BAR	2
+	#define INDICATOR_TYPE_SPREAD_BAR	3
+	#define INDICATOR_TYPES				4
+	
+	// One table for each display type, plus one for each type which draws 
+	// differently with a detent (all but the spread bar)
+	#define INDICATOR_TABLES			(INDICATOR_TYPES + INDICATOR_TYPE_SPREAD_BAR)
+	#define INDICATOR_POSITIONS			128
+	
+/*	Types: */
+	
+	// Structure which holds two LED patterns (bit masks) and their respective
+	// brightness settings.
+	typedef struct {
+		uint16_t pattern_A;		// Pattern A is a series of White LEDs (dimmed/PWM'ed), With a Second LED (Blue) at the Detent, lit solid
+		uint8_t  pattern_A_brightness;
+		uint16_t pattern_B;       // Pattern B appears to be is series of White LEDs (lit solid), with a a Second LED (Red) at the Detent
+		uint8_t  pattern_B_brightness;
+	} indicator_bit_mask_t;
+	
+	// One precomputed indicator position. Pattern B's brightness is not stored,
+	// it is full unless Pattern A is blended into it (see build_indicator_pattern)
+	typedef struct {
+		uint16_t pattern_A;
+		uint16_t pattern_B;
+		uint8_t  pattern_A_brightness;
+	} indicator_table_entry_t;
+
+/* Variables */
+	extern const indicator_table_entry_t indicator_table[INDICATOR_TABLES][INDICATOR_POSITIONS] PROGMEM;
+
+/* Function Prototypes: */
+	int build_indicator_pattern(indicator_bit_mask_t *result, uint8_t position, uint16_t type, 
+								bool has_detent, uint8_t detent_color);
+
+#endif /* INDICATOR_PATTERN_H_ */
@@ -0,0 +1,267 @@
+/*
+ * indicator_tables.c
+ *
+ * Generated by tools/indicator_tables/gen_indicator_tables.c, do not edit.
+ *
+ * Indicator patterns for each display type and position, {pattern A,
+ * pattern B, pattern A brightness}. The detent position itself and the
+ * empty spread bar are handled in build_indicator_pattern().
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <indicator_pattern.h>
+
+const indicator_table_entry_t indicator_table[INDICATOR_TABLES][INDICATOR_POSITIONS] PROGMEM = {
+	{ // Dot
+		{0x0000, 0x0000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0},
+		{0x0000, 0x8000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0},
+		{0x0000, 0x8000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0},
+		{0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0},
+		{0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0},
+		{0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0},
+		{0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0},
+		{0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0},
+		{0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x1000,   0},
+		{0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0},
+		{0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0},
+		{0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x0800,   0},
+		{0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0},
+		{0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0},
+		{0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0400,   0},
+		{0x0000, 0x0400,   0}, {0x0000, 0x0400,   0}, {0x0000, 0x0400,   0}, {0x0000, 0x0400,   0},
+		{0x0000, 0x0400,   0}, {0x0000, 0x0400,   0}, {0x0000, 0x0400,   0}, {0x0000, 0x0400,   0},
+		{0x0000, 0x0400,   0}, {0x0000, 0x0400,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0},
+		{0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0},
+		{0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0},
+		{0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0},
+		{0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0},
+		{0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0},
+		{0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0},
+		{0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0},
+		{0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0},
+		{0x0000, 0x0080,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0},
+		{0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0},
+		{0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0},
+		{0x0000, 0x0040,   0}, {0x0000, 0x0020,   0}, {0x0000, 0x0020,   0}, {0x0000, 0x0020,   0},
+		{0x0000, 0x0020,   0}, {0x0000, 0x0020,   0}, {0x0000, 0x0020,   0}, {0x0000, 0x0020,   0},
+		{0x0000, 0x0020,   0}, {0x0000, 0x0020,   0}, {0x0000, 0x0020,   0}, {0x0000, 0x0020,   0},
+	},
+	{ // Bar
+		{0x0000, 0x0000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0},
+		{0x0000, 0x8000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0},
+		{0x0000, 0x8000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0}, {0x0000, 0x8000,   0},
+		{0x0000, 0xC000,   0}, {0x0000, 0xC000,   0}, {0x0000, 0xC000,   0}, {0x0000, 0xC000,   0},
+		{0x0000, 0xC000,   0}, {0x0000, 0xC000,   0}, {0x0000, 0xC000,   0}, {0x0000, 0xC000,   0},
+		{0x0000, 0xC000,   0}, {0x0000, 0xC000,   0}, {0x0000, 0xC000,   0}, {0x0000, 0xC000,   0},
+		{0x0000, 0xE000,   0}, {0x0000, 0xE000,   0}, {0x0000, 0xE000,   0}, {0x0000, 0xE000,   0},
+		{0x0000, 0xE000,   0}, {0x0000, 0xE000,   0}, {0x0000, 0xE000,   0}, {0x0000, 0xE000,   0},
+		{0x0000, 0xE000,   0}, {0x0000, 0xE000,   0}, {0x0000, 0xE000,   0}, {0x0000, 0xF000,   0},
+		{0x0000, 0xF000,   0}, {0x0000, 0xF000,   0}, {0x0000, 0xF000,   0}, {0x0000, 0xF000,   0},
+		{0x0000, 0xF000,   0}, {0x0000, 0xF000,   0}, {0x0000, 0xF000,   0}, {0x0000, 0xF000,   0},
+		{0x0000, 0xF000,   0}, {0x0000, 0xF000,   0}, {0x0000, 0xF000,   0}, {0x0000, 0xF800,   0},
+		{0x0000, 0xF800,   0}, {0x0000, 0xF800,   0}, {0x0000, 0xF800,   0}, {0x0000, 0xF800,   0},
+		{0x0000, 0xF800,   0}, {0x0000, 0xF800,   0}, {0x0000, 0xF800,   0}, {0x0000, 0xF800,   0},
+		{0x0000, 0xF800,   0}, {0x0000, 0xF800,   0}, {0x0000, 0xF800,   0}, {0x0000, 0xFC00,   0},
+		{0x0000, 0xFC00,   0}, {0x0000, 0xFC00,   0}, {0x0000, 0xFC00,   0}, {0x0000, 0xFC00,   0},
+		{0x0000, 0xFC00,   0}, {0x0000, 0xFC00,   0}, {0x0000, 0xFC00,   0}, {0x0000, 0xFC00,   0},
+		{0x0000, 0xFC00,   0}, {0x0000, 0xFC00,   0}, {0x0000, 0xFE00,   0}, {0x0000, 0xFE00,   0},
+		{0x0000, 0xFE00,   0}, {0x0000, 0xFE00,   0}, {0x0000, 0xFE00,   0}, {0x0000, 0xFE00,   0},
+		{0x0000, 0xFE00,   0}, {0x0000, 0xFE00,   0}, {0x0000, 0xFE00,   0}, {0x0000, 0xFE00,   0},
+		{0x0000, 0xFE00,   0}, {0x0000, 0xFE00,   0}, {0x0000, 0xFF00,   0}, {0x0000, 0xFF00,   0},
+		{0x0000, 0xFF00,   0}, {0x0000, 0xFF00,   0}, {0x0000, 0xFF00,   0}, {0x0000, 0xFF00,   0},
+		{0x0000, 0xFF00,   0}, {0x0000, 0xFF00,   0}, {0x0000, 0xFF00,   0}, {0x0000, 0xFF00,   0},
+		{0x0000, 0xFF00,   0}, {0x0000, 0xFF00,   0}, {0x0000, 0xFF80,   0}, {0x0000, 0xFF80,   0},
+		{0x0000, 0xFF80,   0}, {0x0000, 0xFF80,   0}, {0x0000, 0xFF80,   0}, {0x0000, 0xFF80,   0},
+		{0x0000, 0xFF80,   0}, {0x0000, 0xFF80,   0}, {0x0000, 0xFF80,   0}, {0x0000, 0xFF80,   0},
+		{0x0000, 0xFF80,   0}, {0x0000, 0xFFC0,   0}, {0x0000, 0xFFC0,   0}, {0x0000, 0xFFC0,   0},
+		{0x0000, 0xFFC0,   0}, {0x0000, 0xFFC0,   0}, {0x0000, 0xFFC0,   0}, {0x0000, 0xFFC0,   0},
+		{0x0000, 0xFFC0,   0}, {0x0000, 0xFFC0,   0}, {0x0000, 0xFFC0,   0}, {0x0000, 0xFFC0,   0},
+		{0x0000, 0xFFC0,   0}, {0x0000, 0xFFE0,   0}, {0x0000, 0xFFE0,   0}, {0x0000, 0xFFE0,   0},
+		{0x0000, 0xFFE0,   0}, {0x0000, 0xFFE0,   0}, {0x0000, 0xFFE0,   0}, {0x0000, 0xFFE0,   0},
+		{0x0000, 0xFFE0,   0}, {0x0000, 0xFFE0,   0}, {0x0000, 0xFFE0,   0}, {0x0000, 0xFFE0,   0},
+	},
+	{ // Blended Bar
+		{0x0000, 0x0000,   0}, {0x8000, 0x0000,  11}, {0x8000, 0x0000,  22}, {0x8000, 0x0000,  33},
+		{0x8000, 0x0000,  44}, {0x8000, 0x0000,  55}, {0x8000, 0x0000,  66}, {0x8000, 0x0000,  77},
+		{0x8000, 0x0000,  88}, {0x8000, 0x0000,  99}, {0x8000, 0x0000, 110}, {0x8000, 0x0000, 121},
+		{0xC000, 0x8000,   5}, {0xC000, 0x8000,  16}, {0xC000, 0x8000,  27}, {0xC000, 0x8000,  38},
+		{0xC000, 0x8000,  49}, {0xC000, 0x8000,  60}, {0xC000, 0x8000,  71}, {0xC000, 0x8000,  82},
+		{0xC000, 0x8000,  93}, {0xC000, 0x8000, 104}, {0xC000, 0x8000, 115}, {0x0000, 0xC000,   0},
+		{0xE000, 0xC000,  11}, {0xE000, 0xC000,  22}, {0xE000, 0xC000,  33}, {0xE000, 0xC000,  44},
+		{0xE000, 0xC000,  55}, {0xE000, 0xC000,  66}, {0xE000, 0xC000,  77}, {0xE000, 0xC000,  88},
+		{0xE000, 0xC000,  99}, {0xE000, 0xC000, 110}, {0xE000, 0xC000, 121}, {0xF000, 0xE000,   5},
+		{0xF000, 0xE000,  16}, {0xF000, 0xE000,  27}, {0xF000, 0xE000,  38}, {0xF000, 0xE000,  49},
+		{0xF000, 0xE000,  60}, {0xF000, 0xE000,  71}, {0xF000, 0xE000,  82}, {0xF000, 0xE000,  93},
+		{0xF000, 0xE000, 104}, {0xF000, 0xE000, 115}, {0x0000, 0xF000,   0}, {0xF800, 0xF000,  11},
+		{0xF800, 0xF000,  22}, {0xF800, 0xF000,  33}, {0xF800, 0xF000,  44}, {0xF800, 0xF000,  55},
+		{0xF800, 0xF000,  66}, {0xF800, 0xF000,  77}, {0xF800, 0xF000,  88}, {0xF800, 0xF000,  99},
+		{0xF800, 0xF000, 110}, {0xF800, 0xF000, 121}, {0xFC00, 0xF800,   5}, {0xFC00, 0xF800,  16},
+		{0xFC00, 0xF800,  27}, {0xFC00, 0xF800,  38}, {0xFC00, 0xF800,  49}, {0xFC00, 0xF800,  60},
+		{0xFC00, 0xF800,  71}, {0xFC00, 0xF800,  82}, {0xFC00, 0xF800,  93}, {0xFC00, 0xF800, 104},
+		{0xFC00, 0xF800, 115}, {0x0000, 0xFC00,   0}, {0xFE00, 0xFC00,  11}, {0xFE00, 0xFC00,  22},
+		{0xFE00, 0xFC00,  33}, {0xFE00, 0xFC00,  44}, {0xFE00, 0xFC00,  55}, {0xFE00, 0xFC00,  66},
+		{0xFE00, 0xFC00,  77}, {0xFE00, 0xFC00,  88}, {0xFE00, 0xFC00,  99}, {0xFE00, 0xFC00, 110},
+		{0xFE00, 0xFC00, 121}, {0xFF00, 0xFE00,   5}, {0xFF00, 0xFE00,  16}, {0xFF00, 0xFE00,  27},
+		{0xFF00, 0xFE00,  38}, {0xFF00, 0xFE00,  49}, {0xFF00, 0xFE00,  60}, {0xFF00, 0xFE00,  71},
+		{0xFF00, 0xFE00,  82}, {0xFF00, 0xFE00,  93}, {0xFF00, 0xFE00, 104}, {0xFF00, 0xFE00, 115},
+		{0x0000, 0xFF00,   0}, {0xFF80, 0xFF00,  11}, {0xFF80, 0xFF00,  22}, {0xFF80, 0xFF00,  33},
+		{0xFF80, 0xFF00,  44}, {0xFF80, 0xFF00,  55}, {0xFF80, 0xFF00,  66}, {0xFF80, 0xFF00,  77},
+		{0xFF80, 0xFF00,  88}, {0xFF80, 0xFF00,  99}, {0xFF80, 0xFF00, 110}, {0xFF80, 0xFF00, 121},
+		{0xFFC0, 0xFF80,   5}, {0xFFC0, 0xFF80,  16}, {0xFFC0, 0xFF80,  27}, {0xFFC0, 0xFF80,  38},
+		{0xFFC0, 0xFF80,  49}, {0xFFC0, 0xFF80,  60}, {0xFFC0, 0xFF80,  71}, {0xFFC0, 0xFF80,  82},
+		{0xFFC0, 0xFF80,  93}, {0xFFC0, 0xFF80, 104}, {0xFFC0, 0xFF80, 115}, {0x0000, 0xFFC0,   0},
+		{0xFFE0, 0xFFC0,  11}, {0xFFE0, 0xFFC0,  22}, {0xFFE0, 0xFFC0,  33}, {0xFFE0, 0xFFC0,  44},
+		{0xFFE0, 0xFFC0,  55}, {0xFFE0, 0xFFC0,  66}, {0xFFE0, 0xFFC0,  77}, {0xFFE0, 0xFFC0,  88},
+		{0xFFE0, 0xFFC0,  99}, {0xFFE0, 0xFFC0, 110}, {0xFFE0, 0xFFC0, 121}, {0xFFF0, 0xFFE0,   5},
+	},
+	{ // Spread Bar
+		{0x0000, 0x0000,   0}, {0x0000, 0x0400,   0}, {0x0E00, 0x0400,   5}, {0x0E00, 0x0400,  10},
+		{0x0E00, 0x0400,  15}, {0x0E00, 0x0400,  20}, {0x0E00, 0x0400,  25}, {0x0E00, 0x0400,  30},
+		{0x0E00, 0x0400,  35}, {0x0E00, 0x0400,  40}, {0x0E00, 0x0400,  45}, {0x0E00, 0x0400,  50},
+		{0x0E00, 0x0400,  55}, {0x0E00, 0x0400,  60}, {0x0E00, 0x0400,  65}, {0x0E00, 0x0400,  70},
+		{0x0E00, 0x0400,  75}, {0x0E00, 0x0400,  80}, {0x0E00, 0x0400,  85}, {0x0E00, 0x0400,  90},
+		{0x0E00, 0x0400,  95}, {0x0E00, 0x0400, 100}, {0x0E00, 0x0400, 105}, {0x0E00, 0x0400, 110},
+		{0x0E00, 0x0400, 115}, {0x0E00, 0x0400, 120}, {0x0E00, 0x0400, 125}, {0x1F00, 0x0E00,   4},
+		{0x1F00, 0x0E00,   9}, {0x1F00, 0x0E00,  14}, {0x1F00, 0x0E00,  19}, {0x1F00, 0x0E00,  24},
+		{0x1F00, 0x0E00,  29}, {0x1F00, 0x0E00,  34}, {0x1F00, 0x0E00,  39}, {0x1F00, 0x0E00,  44},
+		{0x1F00, 0x0E00,  49}, {0x1F00, 0x0E00,  54}, {0x1F00, 0x0E00,  59}, {0x1F00, 0x0E00,  64},
+		{0x1F00, 0x0E00,  69}, {0x1F00, 0x0E00,  74}, {0x1F00, 0x0E00,  79}, {0x1F00, 0x0E00,  84},
+		{0x1F00, 0x0E00,  89}, {0x1F00, 0x0E00,  94}, {0x1F00, 0x0E00,  99}, {0x1F00, 0x0E00, 104},
+		{0x1F00, 0x0E00, 109}, {0x1F00, 0x0E00, 114}, {0x1F00, 0x0E00, 119}, {0x1F00, 0x0E00, 124},
+		{0x3F80, 0x1F00,   3}, {0x3F80, 0x1F00,   8}, {0x3F80, 0x1F00,  13}, {0x3F80, 0x1F00,  18},
+		{0x3F80, 0x1F00,  23}, {0x3F80, 0x1F00,  28}, {0x3F80, 0x1F00,  33}, {0x3F80, 0x1F00,  38},
+		{0x3F80, 0x1F00,  43}, {0x3F80, 0x1F00,  48}, {0x3F80, 0x1F00,  53}, {0x3F80, 0x1F00,  58},
+		{0x3F80, 0x1F00,  63}, {0x3F80, 0x1F00,  68}, {0x3F80, 0x1F00,  73}, {0x3F80, 0x1F00,  78},
+		{0x3F80, 0x1F00,  83}, {0x3F80, 0x1F00,  88}, {0x3F80, 0x1F00,  93}, {0x3F80, 0x1F00,  98},
+		{0x3F80, 0x1F00, 103}, {0x3F80, 0x1F00, 108}, {0x3F80, 0x1F00, 113}, {0x3F80, 0x1F00, 118},
+		{0x3F80, 0x1F00, 123}, {0x7FC0, 0x3F80,   2}, {0x7FC0, 0x3F80,   7}, {0x7FC0, 0x3F80,  12},
+		{0x7FC0, 0x3F80,  17}, {0x7FC0, 0x3F80,  22}, {0x7FC0, 0x3F80,  27}, {0x7FC0, 0x3F80,  32},
+		{0x7FC0, 0x3F80,  37}, {0x7FC0, 0x3F80,  42}, {0x7FC0, 0x3F80,  47}, {0x7FC0, 0x3F80,  52},
+		{0x7FC0, 0x3F80,  57}, {0x7FC0, 0x3F80,  62}, {0x7FC0, 0x3F80,  67}, {0x7FC0, 0x3F80,  72},
+		{0x7FC0, 0x3F80,  77}, {0x7FC0, 0x3F80,  82}, {0x7FC0, 0x3F80,  87}, {0x7FC0, 0x3F80,  92},
+		{0x7FC0, 0x3F80,  97}, {0x7FC0, 0x3F80, 102}, {0x7FC0, 0x3F80, 107}, {0x7FC0, 0x3F80, 112},
+		{0x7FC0, 0x3F80, 117}, {0x7FC0, 0x3F80, 122}, {0xFFE0, 0x7FC0,   1}, {0xFFE0, 0x7FC0,   6},
+		{0xFFE0, 0x7FC0,  11}, {0xFFE0, 0x7FC0,  16}, {0xFFE0, 0x7FC0,  21}, {0xFFE0, 0x7FC0,  26},
+		{0xFFE0, 0x7FC0,  31}, {0xFFE0, 0x7FC0,  36}, {0xFFE0, 0x7FC0,  41}, {0xFFE0, 0x7FC0,  46},
+		{0xFFE0, 0x7FC0,  51}, {0xFFE0, 0x7FC0,  56}, {0xFFE0, 0x7FC0,  61}, {0xFFE0, 0x7FC0,  66},
+		{0xFFE0, 0x7FC0,  71}, {0xFFE0, 0x7FC0,  76}, {0xFFE0, 0x7FC0,  81}, {0xFFE0, 0x7FC0,  86},
+		{0xFFE0, 0x7FC0,  91}, {0xFFE0, 0x7FC0,  96}, {0xFFE0, 0x7FC0, 101}, {0xFFE0, 0x7FC0, 106},
+		{0xFFE0, 0x7FC0, 111}, {0xFFE0, 0x7FC0, 116}, {0xFFE0, 0x7FC0, 121}, {0x0000, 0xFFE0,   0},
+	},
+	{ // Dot with detent
+		{0x0000, 0x8000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0},
+		{0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0},
+		{0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0},
+		{0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0}, {0x0000, 0x4000,   0},
+		{0x0000, 0x4000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0},
+		{0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0},
+		{0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0},
+		{0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0}, {0x0000, 0x2000,   0},
+		{0x0000, 0x2000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0},
+		{0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0},
+		{0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0},
+		{0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0}, {0x0000, 0x1000,   0},
+		{0x0000, 0x1000,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0},
+		{0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0},
+		{0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0},
+		{0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0800,   0}, {0x0000, 0x0000,   0},
+		{0x0000, 0x0000,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0},
+		{0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0},
+		{0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0},
+		{0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0200,   0}, {0x0000, 0x0100,   0},
+		{0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0},
+		{0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0},
+		{0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0},
+		{0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0100,   0}, {0x0000, 0x0080,   0},
+		{0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0},
+		{0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0},
+		{0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0},
+		{0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0080,   0}, {0x0000, 0x0040,   0},
+		{0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0},
+		{0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0},
+		{0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0},
+		{0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0040,   0}, {0x0000, 0x0020,   0},
+	},
+	{ // Bar with detent
+		{0x0000, 0xFC00,   0}, {0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0},
+		{0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0},
+		{0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0},
+		{0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0}, {0x0000, 0x7C00,   0},
+		{0x0000, 0x7C00,   0}, {0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0},
+		{0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0},
+		{0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0},
+		{0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0}, {0x0000, 0x3C00,   0},
+		{0x0000, 0x3C00,   0}, {0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0},
+		{0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0},
+		{0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0},
+		{0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0}, {0x0000, 0x1C00,   0},
+		{0x0000, 0x1C00,   0}, {0x0000, 0x0C00,   0}, {0x0000, 0x0C00,   0}, {0x0000, 0x0C00,   0},
+		{0x0000, 0x0C00,   0}, {0x0000, 0x0C00,   0}, {0x0000, 0x0C00,   0}, {0x0000, 0x0C00,   0},
+		{0x0000, 0x0C00,   0}, {0x0000, 0x0C00,   0}, {0x0000, 0x0C00,   0}, {0x0000, 0x0C00,   0},
+		{0x0000, 0x0C00,   0}, {0x0000, 0x0C00,   0}, {0x0000, 0x0C00,   0}, {0x0000, 0x0000,   0},
+		{0x0000, 0x0000,   0}, {0x0000, 0x0600,   0}, {0x0000, 0x0600,   0}, {0x0000, 0x0600,   0},
+		{0x0000, 0x0600,   0}, {0x0000, 0x0600,   0}, {0x0000, 0x0600,   0}, {0x0000, 0x0600,   0},
+		{0x0000, 0x0600,   0}, {0x0000, 0x0600,   0}, {0x0000, 0x0600,   0}, {0x0000, 0x0600,   0},
+		{0x0000, 0x0600,   0}, {0x0000, 0x0600,   0}, {0x0000, 0x0600,   0}, {0x0000, 0x0700,   0},
+		{0x0000, 0x0700,   0}, {0x0000, 0x0700,   0}, {0x0000, 0x0700,   0}, {0x0000, 0x0700,   0},
+		{0x0000, 0x0700,   0}, {0x0000, 0x0700,   0}, {0x0000, 0x0700,   0}, {0x0000, 0x0700,   0},
+		{0x0000, 0x0700,   0}, {0x0000, 0x0700,   0}, {0x0000, 0x0700,   0}, {0x0000, 0x0700,   0},
+		{0x0000, 0x0700,   0}, {0x0000, 0x0700,   0}, {0x0000, 0x0700,   0}, {0x0000, 0x0780,   0},
+		{0x0000, 0x0780,   0}, {0x0000, 0x0780,   0}, {0x0000, 0x0780,   0}, {0x0000, 0x0780,   0},
+		{0x0000, 0x0780,   0}, {0x0000, 0x0780,   0}, {0x0000, 0x0780,   0}, {0x0000, 0x0780,   0},
+		{0x0000, 0x0780,   0}, {0x0000, 0x0780,   0}, {0x0000, 0x0780,   0}, {0x0000, 0x0780,   0},
+		{0x0000, 0x0780,   0}, {0x0000, 0x0780,   0}, {0x0000, 0x0780,   0}, {0x0000, 0x07C0,   0},
+		{0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0},
+		{0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0},
+		{0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0},
+		{0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0}, {0x0000, 0x07C0,   0}, {0x0000, 0x07E0,   0},
+	},
+	{ // Blended Bar with detent
+		{0xFC00, 0x7C00, 122}, {0xFC00, 0x7C00, 112}, {0xFC00, 0x7C00, 102}, {0xFC00, 0x7C00,  92},
+		{0xFC00, 0x7C00,  82}, {0xFC00, 0x7C00,  72}, {0xFC00, 0x7C00,  62}, {0xFC00, 0x7C00,  52},
+		{0xFC00, 0x7C00,  42}, {0xFC00, 0x7C00,  32}, {0xFC00, 0x7C00,  22}, {0xFC00, 0x7C00,  12},
+		{0xFC00, 0x7C00,   2}, {0x7C00, 0x3C00, 119}, {0x7C00, 0x3C00, 109}, {0x7C00, 0x3C00,  99},
+		{0x7C00, 0x3C00,  89}, {0x7C00, 0x3C00,  79}, {0x7C00, 0x3C00,  69}, {0x7C00, 0x3C00,  59},
+		{0x7C00, 0x3C00,  49}, {0x7C00, 0x3C00,  39}, {0x7C00, 0x3C00,  29}, {0x7C00, 0x3C00,  19},
+		{0x7C00, 0x3C00,   9}, {0x3C00, 0x1C00, 126}, {0x3C00, 0x1C00, 116}, {0x3C00, 0x1C00, 106},
+		{0x3C00, 0x1C00,  96}, {0x3C00, 0x1C00,  86}, {0x3C00, 0x1C00,  76}, {0x3C00, 0x1C00,  66},
+		{0x3C00, 0x1C00,  56}, {0x3C00, 0x1C00,  46}, {0x3C00, 0x1C00,  36}, {0x3C00, 0x1C00,  26},
+		{0x3C00, 0x1C00,  16}, {0x3C00, 0x1C00,   6}, {0x1C00, 0x0C00, 123}, {0x1C00, 0x0C00, 113},
+		{0x1C00, 0x0C00, 103}, {0x1C00, 0x0C00,  93}, {0x1C00, 0x0C00,  83}, {0x1C00, 0x0C00,  73},
+		{0x1C00, 0x0C00,  63}, {0x1C00, 0x0C00,  53}, {0x1C00, 0x0C00,  43}, {0x1C00, 0x0C00,  33},
+		{0x1C00, 0x0C00,  23}, {0x1C00, 0x0C00,  13}, {0x1C00, 0x0C00,   3}, {0x0C00, 0x0400, 120},
+		{0x0C00, 0x0400, 110}, {0x0C00, 0x0400, 100}, {0x0C00, 0x0400,  90}, {0x0C00, 0x0400,  80},
+		{0x0C00, 0x0400,  70}, {0x0C00, 0x0400,  60}, {0x0C00, 0x0400,  50}, {0x0C00, 0x0400,  40},
+		{0x0C00, 0x0400,  30}, {0x0C00, 0x0400,  20}, {0x0C00, 0x0400,  10}, {0x0000, 0x0000,   0},
+		{0x0000, 0x0000,   0}, {0x0600, 0x0400,  20}, {0x0600, 0x0400,  30}, {0x0600, 0x0400,  40},
+		{0x0600, 0x0400,  50}, {0x0600, 0x0400,  60}, {0x0600, 0x0400,  70}, {0x0600, 0x0400,  80},
+		{0x0600, 0x0400,  90}, {0x0600, 0x0400, 100}, {0x0600, 0x0400, 110}, {0x0600, 0x0400, 120},
+		{0x0700, 0x0600,   3}, {0x0700, 0x0600,  13}, {0x0700, 0x0600,  23}, {0x0700, 0x0600,  33},
+		{0x0700, 0x0600,  43}, {0x0700, 0x0600,  53}, {0x0700, 0x0600,  63}, {0x0700, 0x0600,  73},
+		{0x0700, 0x0600,  83}, {0x0700, 0x0600,  93}, {0x0700, 0x0600, 103}, {0x0700, 0x0600, 113},
+		{0x0700, 0x0600, 123}, {0x0780, 0x0700,   6}, {0x0780, 0x0700,  16}, {0x0780, 0x0700,  26},
+		{0x0780, 0x0700,  36}, {0x0780, 0x0700,  46}, {0x0780, 0x0700,  56}, {0x0780, 0x0700,  66},
+		{0x0780, 0x0700,  76}, {0x0780, 0x0700,  86}, {0x0780, 0x0700,  96}, {0x0780, 0x0700, 106},
+		{0x0780, 0x0700, 116}, {0x0780, 0x0700, 126}, {0x07C0, 0x0780,   9}, {0x07C0, 0x0780,  19},
+		{0x07C0, 0x0780,  29}, {0x07C0, 0x0780,  39}, {0x07C0, 0x0780,  49}, {0x07C0, 0x0780,  59},
+		{0x07C0, 0x0780,  69}, {0x07C0, 0x0780,  79}, {0x07C0, 0x0780,  89}, {0x07C0, 0x0780,  99},
+		{0x07C0, 0x0780, 109}, {0x07C0, 0x0780, 119}, {0x07E0, 0x07C0,   2}, {0x07E0, 0x07C0,  12},
+		{0x07E0, 0x07C0,  22}, {0x07E0, 0x07C0,  32}, {0x07E0, 0x07C0,  42}, {0x07E0, 0x07C0,  52},
+		{0x07E0, 0x07C0,  62}, {0x07E0, 0x07C0,  72}, {0x07E0, 0x07C0,  82}, {0x07E0, 0x07C0,  92},
+		{0x07E0, 0x07C0, 102}, {0x07E0, 0x07C0, 112}, {0x07E0, 0x07C0, 122}, {0x07F0, 0x07E0,   5},
+	},
+};
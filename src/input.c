@@ -29,6 +29,11 @@
 #include <string.h>
 
 static uint32_t ms_timer;
+static uint16_t ms_timer_fraction; // TCC1 ticks x4 not yet counted into ms_timer
+
+// Current encoder scan period (TCC1 ticks) and its length in scan units
+static uint8_t  scan_rate = INPUT_SCAN_RATE_FAST;
+static uint8_t  scan_units = INPUT_SCAN_RATE_FAST / INPUT_SCAN_UNIT;
 
 // Buffers used to debounce the switch states;
 uint16_t enc_switch_debounce_buffer[SWITCH_DEBOUNCE_BUFFER_SIZE];
@@ -76,7 +81,7 @@ uint16_t encoder_event_cycle_counts[16];
 
 // - Velocity Measurements (ms per tick)
 // -- Ticks per 360-degrees: 96  
-// -- Encoder Poll Time (interrupt): measured as 1.21ms
+// -- Encoder Poll Time (interrupt): 0.512ms (moving) / 1.536ms (idle), counted in 0.512ms scan units
 // -- Very slow turn: 200-500ms (1 multiplier)  (2 to 5 ticks-per-second)
 // -- slow turn: 200-100ms (1 multiplier)  		(5 to 10 ticks-per-second)
 // -- med turn: ~50ms							(20 ticks-per-second)
@@ -146,7 +151,7 @@ void input_init(void)
 	
 	#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
 		memset(encoder_last_movement, 0x00, 16); // 0 is "unknown movement"
-		memset(encoder_event_cycle_counts, 0xFF, 32); // memset works in units of uint8_t so double the members for a uint16_t array 0xFF -> 255ms+
+		memset(encoder_event_cycle_counts, 0xFF, 32); // memset works in units of uint8_t so double the members for a uint16_t array 0xFFFF -> 65535 scan units (INPUT_SCAN_UNIT), about 33.5s+
 	#endif
 	
 	
@@ -164,14 +169,13 @@ void input_init(void)
 	// Timer Initialization ---------------------------------------------------
 	
 	/** The Input Driver uses timer counter compare A interrupt to ensure the 
-	 *	inputs are scanned every 1.28 ms. (1/32x10^6) x 1024 x 40
+	 *	inputs are scanned every 0.512 ms while the encoders are moving, 
+	 *  (1/32x10^6) x 1024 x 16, and every 1.536 ms once they are idle.
 	 *  To support the timing requirements of the sequencer and other functions
 	 *  access to the second CC channel is provided, allowing scheduling of
 	 *  events.
 	 */
 	
-	#define INPUT_SCAN_RATE 40
-	
 	// Enable Timer 1 
 	tc_enable(&TCC1);
 	// Set Timer 1 overflow callback to display_frame_timer()
@@ -179,8 +183,9 @@ void input_init(void)
 	tc_set_ccb_interrupt_callback(&TCC1, do_task);
 	// Set Timer 1 waveform mode to count up
 	tc_set_wgm(&TCC1, TC_WG_NORMAL);
-	// Set Timer 1 CCA match value to 40 (1mS)
-	tc_write_cc(&TCC1, TC_CCA, INPUT_SCAN_RATE);
+	// Set Timer 1 CCA match value to the fast scan rate (0.512mS)
+	timer_cca_value = INPUT_SCAN_RATE_FAST;
+	tc_write_cc(&TCC1, TC_CCA, timer_cca_value);
 	// Set Timer 1 CCA interrupt level to low
 	tc_set_cca_interrupt_level(&TCC1, TC_INT_LVL_HI);  // Interrupt Priority: Buttons 1
 	// Disable the CCB interrupt
@@ -191,6 +196,7 @@ void input_init(void)
 	tc_write_clock_source(&TCC1, TC_CLKSEL_DIV1024_gc);
 	
 	ms_timer = 0;
+	ms_timer_fraction = 0;
 	
 	ioport_set_pin_dir(DEBUG_PIN, IOPORT_DIR_OUTPUT);
 }
@@ -255,15 +261,20 @@ bool cancel_task()
 
 
 /**
- * Returns a 32 bit counter, this counter is incremented ever 1ms by the input
- * scan routine. This is NOT accurate (CLK is +/- 1.5%)
+ * Returns a 32 bit counter, this counter is advanced in 1ms steps by the input
+ * scan routine from the elapsed compare periods, so it does not depend on the 
+ * current scan rate. This is NOT accurate (CLK is +/- 1.5%)
  *
  * \return ms_timer value
  */
 
 uint32_t get_ms_timer(void)
 {
-	return ms_timer;
+	// The scan interrupt updates the counter, so read all 4 bytes atomically
+	irqflags_t flags = cpu_irq_save();
+	uint32_t value = ms_timer;
+	cpu_irq_restore(flags);
+	return value;
 }
 
 /*	
@@ -271,6 +282,7 @@ uint32_t get_ms_timer(void)
  *  relative movements which are stored in the encoder_state array.
  */
 static uint8_t enc_switch_buffer_pos = 0;
+static uint8_t enc_switch_slot_ticks = 0; // TCC1 ticks scanned in to the current slot
 // #define ENCODER_INTERPRET_VERSION_ORIG 0 
 // #define ENCODER_INTERPRET_VERSION_STATE_TABLE 1
 // #define ENCODER_INTERPRET_VERSION ENCODER_INTERPRET_VERSION_STATE_TABLE
@@ -289,10 +301,15 @@ const int8_t EncoderActionByState[16] = {
 void encoder_scan(void)   // MIDI Output: Digital Inputs -> Encoders (Read Pins)
 {
 	// Increment the timer compare value
-	timer_cca_value += INPUT_SCAN_RATE;
+	timer_cca_value += scan_rate;
 	tc_write_cc(&TCC1, TC_CCA, timer_cca_value);
-	// Increment the ms_timer count
-	ms_timer++;
+	// Advance the ms_timer count by the period that just elapsed
+	ms_timer_fraction += scan_rate << 2;
+	while (ms_timer_fraction >= INPUT_TICKS_PER_MS_X4) {
+		ms_timer_fraction -= INPUT_TICKS_PER_MS_X4;
+		ms_timer++;
+	}
+	bool any_encoder_active = false;
 	
 	// Latch the encoder data into the shift registers, latching data also 
 	// presents first bit to ENC_DATA so no need to clk in the first bit
@@ -309,10 +326,17 @@ void encoder_scan(void)   // MIDI Output: Digital Inputs -> Encoders (Read Pins)
 		ioport_set_pin_level(ENC_CLK, true); //CLK is active on the rising edge
 	}
 	
-	// Add the current state to the circular debounce buffer, and increment the 
-	// buffer pos.
-	enc_switch_debounce_buffer[enc_switch_buffer_pos] = current_enc_switch_state;
-	enc_switch_buffer_pos = (enc_switch_buffer_pos + 1) % SWITCH_DEBOUNCE_BUFFER_SIZE;
+	// Add the current state to the circular debounce buffer. A slot covers
+	// SWITCH_DEBOUNCE_SLOT_TICKS, so the buffer pos is moved on by the time
+	// that has passed rather than once per scan. An idle scan can span more
+	// than one slot, the state is carried in to each slot it covers.
+	enc_switch_debounce_buffer[enc_switch_buffer_pos] |= current_enc_switch_state;
+	enc_switch_slot_ticks += scan_rate;
+	while (enc_switch_slot_ticks >= SWITCH_DEBOUNCE_SLOT_TICKS) {
+		enc_switch_slot_ticks -= SWITCH_DEBOUNCE_SLOT_TICKS;
+		enc_switch_buffer_pos = (enc_switch_buffer_pos + 1) % SWITCH_DEBOUNCE_BUFFER_SIZE;
+		enc_switch_debounce_buffer[enc_switch_buffer_pos] = enc_switch_slot_ticks ? current_enc_switch_state : 0;
+	}
 	uint16_t encoder_cha_state = 0;
 	uint16_t encoder_chb_state = 0;
 	bit   = 0x8000;
@@ -342,7 +366,10 @@ void encoder_scan(void)   // MIDI Output: Digital Inputs -> Encoders (Read Pins)
 		if (encoder_action == 0 || encoder_action <= -127) { // Encoder is Idle
 			// TODO: Handle the -127 'ambiguous' state more gracefully (presuming direction by momentum for example)
 			if ( encoder_inactive_counter[i] < ENCODER_INACTIVE_THRESHOLD ){ // For determining when an encoder is inactive
-				encoder_inactive_counter[i]++;
+				encoder_inactive_counter[i] += scan_units;
+				if (encoder_inactive_counter[i] > ENCODER_INACTIVE_THRESHOLD) {
+					encoder_inactive_counter[i] = ENCODER_INACTIVE_THRESHOLD;
+				}
 			}
 
 		} //else if (enocder_action <= -127) { // Encoder is in an ambiguous state
@@ -350,7 +377,7 @@ void encoder_scan(void)   // MIDI Output: Digital Inputs -> Encoders (Read Pins)
 		else if (encoder_action < 0) { // Event! Moving CCW
 			// encoder event table: mark event type +store event cycle count + increment event counter
 			#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
-				uint16_t cycle_count = encoder_inactive_counter[i] + 1;
+				uint16_t cycle_count = encoder_inactive_counter[i] + scan_units;
 				int8_t last_move = encoder_last_movement[i]; 
 				if (cycle_count >= ENCODER_DEBOUNCE_CYCLE_TIMEOUT) { // event spacing was reasonable, allow to travel freely in either direction
 					// Add event to the tally
@@ -374,7 +401,7 @@ void encoder_scan(void)   // MIDI Output: Digital Inputs -> Encoders (Read Pins)
 		} else { // Event! Moving CW
 			// !mark encoder event table: mark event type +store event cycle count + increment event counter
 			#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
-				uint16_t cycle_count = encoder_inactive_counter[i] + 1;
+				uint16_t cycle_count = encoder_inactive_counter[i] + scan_units;
 				int8_t last_move = encoder_last_movement[i];
 				if (cycle_count >= ENCODER_DEBOUNCE_CYCLE_TIMEOUT) { // event spacing was reasonable, allow to travel freely in either direction
 					// Add event to the tally
@@ -396,6 +423,9 @@ void encoder_scan(void)   // MIDI Output: Digital Inputs -> Encoders (Read Pins)
 				encoder_inactive_counter[i] = 0; // clear the inactive counter
 			#endif
 		}
+		if (encoder_inactive_counter[i] < ENCODER_INACTIVE_THRESHOLD) {
+			any_encoder_active = true;
+		}
 		bit <<= 1;
 		// endif ENCODER_INTERPRET_VERSION == ENCODER_INTERPRET_VERSION_STATE_TABLE
 		//#elif ENCODER_INTERPRET_VERSION == ENCODER_INTERPRET_VERSION_ORIG
@@ -404,6 +434,16 @@ void encoder_scan(void)   // MIDI Output: Digital Inputs -> Encoders (Read Pins)
 	// Store current state for future comparisons
 	encoder_cha_state_prev = encoder_cha_state;
 	encoder_chb_state_prev = encoder_chb_state;
+	
+	// Pick the rate for the next scan. Any movement switches to the fast rate
+	// straight away, we only drop back to the idle rate once every encoder has
+	// been still for ENCODER_INACTIVE_THRESHOLD (the hysteresis).
+	if (any_encoder_active) {
+		scan_rate = INPUT_SCAN_RATE_FAST;
+	} else {
+		scan_rate = INPUT_SCAN_RATE_IDLE;
+	}
+	scan_units = scan_rate / INPUT_SCAN_UNIT;
 }
 
 /**
@@ -430,8 +470,8 @@ uint16_t get_encoder_cycle_count(uint8_t encoder) {
 uint16_t update_encoder_switch_state(void)
 {
 	// De-bounce the encoder switch's by ORing the columns of the buffer
-	// Any switch down even is immediately recognized, however it will take 10 samples
-	// for a switch design to be recognized
+	// Any switch down even is immediately recognized, however it will take 10 slots
+	// (12.8ms) for a switch design to be recognized
 	g_enc_switch_state = 0;
 	
 	for(uint8_t i=0;i<SWITCH_DEBOUNCE_BUFFER_SIZE;++i) {
@@ -29,8 +29,28 @@
 /* Macros: */
 
 	#define SWITCH_DEBOUNCE_BUFFER_SIZE	10
+	// Each encoder switch debounce sample covers a fixed time, whatever the
+	// scan rate, so a release still takes 10 x 1.28ms to be recognized
+	#define SWITCH_DEBOUNCE_SLOT_TICKS	40 // 1.28ms in TCC1 ticks
 	
-	#define ENCODER_INACTIVE_THRESHOLD 100
+	// ===== Adaptive Scan Rate ============================
+	// The encoders are scanned quickly while any of them is turning and more
+	// slowly once they have all been still for ENCODER_INACTIVE_THRESHOLD.
+	// - All rates are in TCC1 ticks (1024 / 32MHz = 32us per tick)
+	// - Inactivity and velocity counters are kept in scan units (INPUT_SCAN_UNIT
+	//   ticks) so they measure time, regardless of the current scan rate.
+	#define ENABLE_ADAPTIVE_SCAN_RATE 1
+	
+	#define INPUT_SCAN_UNIT			16 // 512us
+	#define INPUT_SCAN_RATE_FAST	16 // 512us, while encoders are moving
+	#if ENABLE_ADAPTIVE_SCAN_RATE > 0
+	#define INPUT_SCAN_RATE_IDLE	48 // 1.536ms, while all encoders are still
+	#else
+	#define INPUT_SCAN_RATE_IDLE	INPUT_SCAN_RATE_FAST
+	#endif
+	#define INPUT_TICKS_PER_MS_X4	125 // 31.25 ticks per ms, scaled by 4 to stay integer
+	
+	#define ENCODER_INACTIVE_THRESHOLD 250 // Scan units (128ms)
 	#define ENCODER_INACTIVE_MAXIMUM 255
 
 	// Input Pin Definitions
@@ -67,9 +87,9 @@
 	#if VELOCITY_CALC_METHOD > VELOCITY_CALC_M_NONE
 	#define VELOCITY_CALC_MIN_MULTIPLIER 1
 	#define VELOCITY_CALC_MAX_MULTIPLIER 256 // sweeps 14-bit value in 48 ticks (half turn) 
-	//#define VELOCITY_CALC_TPS_MIN 0.0121f // 1.21ms per sample, 10 Ticks per second -> 1 tick every 81.64 samples
-	#define VELOCITY_CALC_TPS_MIN 0.0363f // 1.21ms per sample, 30 Ticks per second -> 1 tick every 27.55 samples
-	#define VELOCITY_CALC_TPS_MAX 0.3025f // 1.21ms per sample, 250 Ticks per second -> 1 tick every 3.31 samples
+	//#define VELOCITY_CALC_TPS_MIN 0.00512f // 0.512ms per scan unit, 10 Ticks per second -> 1 tick every 195.3 units
+	#define VELOCITY_CALC_TPS_MIN 0.01536f // 0.512ms per scan unit, 30 Ticks per second -> 1 tick every 65.1 units
+	#define VELOCITY_CALC_TPS_MAX 0.128f   // 0.512ms per scan unit, 250 Ticks per second -> 1 tick every 7.8 units
 	#endif
 
 /* Global Variables */
@@ -84,7 +104,7 @@
 		//int8_t encoder_last_movement[16];
 		//uint8_t encoder_event_counts[16];
 	#if VELOCITY_CALC_METHOD == VELOCITY_CALC_M_TPS_BLOCKS
-		#define ENCODER_DEBOUNCE_CYCLE_TIMEOUT 6 // Can't change direction faster than this (approx. ms)
+		#define ENCODER_DEBOUNCE_CYCLE_TIMEOUT 15 // Can't change direction faster than this (scan units, approx. 7.7ms)
 		int8_t encoder_last_movement[16];
 		uint16_t encoder_event_cycle_counts[16];
 	#endif
@@ -0,0 +1,276 @@
+/*
+ * journal.c
+ *
+ * Keeps runtime state which changes too often to save with the settings (the
+ * encoder bank, toggle states and encoder positions) across a power cycle. The
+ * state is split into chunks, and each change is appended to a journal of
+ * EEPROM pages as a record with a sequence number and a CRC. The writes rotate
+ * through all the journal pages, and boot finds the newest copy of each chunk
+ * with one scan of the journal.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <util/crc16.h>
+
+#include "journal.h"
+#include "eeprom.h"
+#include "encoders.h"
+#include "input.h"
+
+#if JOURNAL_START_PAGE + JOURNAL_PAGES > EEPROM_GUARD_FIRST_PAGE
+#error The journal does not fit in the EEPROM
+#endif
+#if ENCODER_BANK_STATE_SIZE > JOURNAL_DATA_SIZE
+#error The bank state does not fit in a journal record
+#endif
+#if !defined(EXTENDED_BANKS) && JOURNAL_START_PAGE + JOURNAL_PAGES > SEQ_EEPROM_START_PAGE
+#error The journal overlaps the sequencer patterns
+#endif
+
+// Record layout, one EEPROM page
+#define RECORD_SEQUENCE		0	// 2 bytes, LSB first
+#define RECORD_CHUNK		2
+#define RECORD_CRC			3	// 2 bytes, LSB first, over the rest of the record
+#define RECORD_DATA			5
+
+#define NO_SLOT				0xFF
+
+uint32_t journal_records_written;
+uint16_t journal_boot_time;
+
+static uint8_t journal_slot[JOURNAL_CHUNKS];		// Page holding each chunk's newest record
+static uint16_t journal_written_crc[JOURNAL_CHUNKS];	// CRC of each chunk's data as last written
+static uint16_t journal_seen_crc[JOURNAL_CHUNKS];		// CRC of each chunk's data when last checked
+static uint8_t journal_settle[JOURNAL_CHUNKS];		// Checks the chunk has been the same for
+static uint8_t journal_head;		// Next page to write
+static uint16_t journal_sequence;	// Sequence number of the next record
+static uint8_t journal_poll_chunk;
+static uint16_t journal_poll_time;
+
+static uint16_t journal_crc(const uint8_t *data, uint8_t length, uint16_t crc)
+{
+	while (length--) {
+		crc = _crc_ccitt_update(crc, *data++);
+	}
+	return crc;
+}
+
+static uint16_t record_crc(const uint8_t *record)
+{
+	uint16_t crc = journal_crc(record, RECORD_CRC, 0xFFFF);
+	return journal_crc(&record[RECORD_DATA], JOURNAL_DATA_SIZE, crc);
+}
+
+// Fills in a chunk's data from the current state
+static void journal_build(uint8_t chunk, uint8_t *data)
+{
+	memset(data, 0, JOURNAL_DATA_SIZE);
+	if (chunk == JOURNAL_CHUNK_BANK) {
+		data[0] = current_encoder_bank();
+	} else {
+		encoders_save_bank_state(chunk - 1, data);
+	}
+}
+
+static void journal_restore(uint8_t chunk, const uint8_t *data)
+{
+	if (chunk == JOURNAL_CHUNK_BANK) {
+		if (data[0] < NUM_BANKS) {
+			change_encoder_bank(data[0]);
+		}
+	} else {
+		encoders_restore_bank_state(chunk - 1, data);
+	}
+}
+
+// Appends a record of one chunk's current state at the head of the journal
+static void journal_append(uint8_t chunk)
+{
+	uint8_t record[EEPROM_PAGE_SIZE];
+	
+	journal_build(chunk, &record[RECORD_DATA]);
+	record[RECORD_SEQUENCE] = journal_sequence & 0xFF;
+	record[RECORD_SEQUENCE + 1] = journal_sequence >> 8;
+	record[RECORD_CHUNK] = chunk;
+	uint16_t crc = record_crc(record);
+	record[RECORD_CRC] = crc & 0xFF;
+	record[RECORD_CRC + 1] = crc >> 8;
+	
+	eeprom_queue_write_page(JOURNAL_START_PAGE + journal_head, record);
+	journal_records_written++;
+	
+	uint16_t data_crc = journal_crc(&record[RECORD_DATA], JOURNAL_DATA_SIZE, 0xFFFF);
+	journal_written_crc[chunk] = data_crc;
+	journal_seen_crc[chunk] = data_crc;
+	journal_slot[chunk] = journal_head;
+	journal_sequence++;
+	if (++journal_head >= JOURNAL_PAGES) {
+		journal_head = 0;
+	}
+}
+
+/**
+ * Writes a chunk to the journal. Where the next page holds the newest record
+ * of another chunk, that chunk is copied forward first so it isn't lost. There
+ * are twice as many pages as chunks, so this copies each unchanged chunk once
+ * per lap at most.
+ */
+static void journal_write(uint8_t chunk)
+{
+	for (;;) {
+		uint8_t owner = NO_SLOT;
+		for (uint8_t i = 0; i < JOURNAL_CHUNKS; ++i) {
+			if (journal_slot[i] == journal_head) {
+				owner = i;
+			}
+		}
+		if (owner == NO_SLOT || owner == chunk) {
+			break;
+		}
+		journal_append(owner);
+	}
+	journal_append(chunk);
+}
+
+/**
+ * Starts polling from the state as it is now, so nothing is rewritten until it
+ * changes.
+ */
+static void journal_start_polling(void)
+{
+	uint8_t data[JOURNAL_DATA_SIZE];
+	
+	for (uint8_t chunk = 0; chunk < JOURNAL_CHUNKS; ++chunk) {
+		journal_build(chunk, data);
+		journal_written_crc[chunk] = journal_crc(data, JOURNAL_DATA_SIZE, 0xFFFF);
+		journal_seen_crc[chunk] = journal_written_crc[chunk];
+		journal_settle[chunk] = 0;
+	}
+	journal_poll_chunk = 0;
+	journal_poll_time = (uint16_t)get_ms_timer();
+}
+
+/**
+ * Finds the newest record of each chunk and restores the state from it. Reads
+ * every journal page once, and the newest pages once more. Call after the
+ * encoders and the display are set up.
+ */
+void journal_init(void)
+{
+	uint16_t start = tc_read_count(&TCC0);
+	uint8_t record[EEPROM_PAGE_SIZE];
+	uint16_t chunk_sequence[JOURNAL_CHUNKS];
+	uint16_t newest = 0;
+	bool found = false;
+	
+	memset(journal_slot, NO_SLOT, sizeof(journal_slot));
+	journal_head = 0;
+	journal_sequence = 0;
+	
+	for (uint8_t page = 0; page < JOURNAL_PAGES; ++page) {
+		eeprom_queue_read_buffer((JOURNAL_START_PAGE + page) * EEPROM_PAGE_SIZE, record, EEPROM_PAGE_SIZE);
+		
+		uint8_t chunk = record[RECORD_CHUNK];
+		uint16_t crc = record[RECORD_CRC] | ((uint16_t)record[RECORD_CRC + 1] << 8);
+		if (chunk >= JOURNAL_CHUNKS || crc != record_crc(record)) {
+			continue;	// Erased or torn
+		}
+		
+		// Sequence numbers wrap, but the records in the journal are always
+		// within JOURNAL_PAGES of each other
+		uint16_t sequence = record[RECORD_SEQUENCE] | ((uint16_t)record[RECORD_SEQUENCE + 1] << 8);
+		if (journal_slot[chunk] == NO_SLOT || (int16_t)(sequence - chunk_sequence[chunk]) > 0) {
+			journal_slot[chunk] = page;
+			chunk_sequence[chunk] = sequence;
+		}
+		if (!found || (int16_t)(sequence - newest) > 0) {
+			newest = sequence;
+			journal_head = page + 1;
+			found = true;
+		}
+	}
+	if (found) {
+		journal_sequence = newest + 1;
+		if (journal_head >= JOURNAL_PAGES) {
+			journal_head = 0;
+		}
+	}
+	
+	// The bank chunk is last, so the bank change shows the restored state
+	for (int8_t chunk = JOURNAL_CHUNKS - 1; chunk >= 0; --chunk) {
+		if (journal_slot[chunk] != NO_SLOT) {
+			eeprom_queue_read_buffer((JOURNAL_START_PAGE + journal_slot[chunk]) * EEPROM_PAGE_SIZE, record, EEPROM_PAGE_SIZE);
+			journal_restore(chunk, &record[RECORD_DATA]);
+		}
+	}
+	
+	journal_start_polling();
+	
+	journal_boot_time = tc_read_count(&TCC0) - start;
+}
+
+/**
+ * Checks one chunk of the state every JOURNAL_POLL_TIME mS, and writes it to
+ * the journal once it has changed and then settled. Call once per main loop
+ * pass.
+ */
+void journal_task(void)
+{
+	uint16_t now = (uint16_t)get_ms_timer();
+	if ((uint16_t)(now - journal_poll_time) < JOURNAL_POLL_TIME) {
+		return;
+	}
+	journal_poll_time = now;
+	
+	uint8_t chunk = journal_poll_chunk;
+	if (++journal_poll_chunk >= JOURNAL_CHUNKS) {
+		journal_poll_chunk = 0;
+	}
+	
+	uint8_t data[JOURNAL_DATA_SIZE];
+	journal_build(chunk, data);
+	uint16_t crc = journal_crc(data, JOURNAL_DATA_SIZE, 0xFFFF);
+	
+	if (crc != journal_seen_crc[chunk]) {
+		// Still changing
+		journal_seen_crc[chunk] = crc;
+		journal_settle[chunk] = 0;
+	} else if (crc != journal_written_crc[chunk]) {
+		if (++journal_settle[chunk] >= JOURNAL_SETTLE_POLLS) {
+			journal_settle[chunk] = 0;
+			journal_write(chunk);
+		}
+	}
+}
+
+/**
+ * Erases the journal, for a factory reset. Call after the state has been
+ * reset, the journal starts again from it as journal_init() would.
+ */
+void journal_reset(void)
+{
+	uint8_t blank[EEPROM_PAGE_SIZE];
+	memset(blank, 0xFF, EEPROM_PAGE_SIZE);
+	
+	for (uint8_t page = 0; page < JOURNAL_PAGES; ++page) {
+		eeprom_queue_write_page(JOURNAL_START_PAGE + page, blank);
+	}
+	memset(journal_slot, NO_SLOT, sizeof(journal_slot));
+	journal_head = 0;
+	journal_sequence = 0;
+	journal_start_polling();
+}
@@ -0,0 +1,62 @@
+/*
+ * journal.h
+ *
+ * Keeps runtime state which changes too often to save with the settings (the
+ * encoder bank, toggle states and encoder positions) across a power cycle. The
+ * state is split into chunks, and each change is appended to a journal of
+ * EEPROM pages as a record with a sequence number and a CRC. The writes rotate
+ * through all the journal pages, and boot finds the newest copy of each chunk
+ * with one scan of the journal.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+/*	Includes: */
+	#include <asf.h>
+	
+	#include "constants.h"
+
+/*	Macros: */
+	// Chunk 0 holds the bank, then one chunk per bank
+	#define JOURNAL_CHUNK_BANK		0
+	#define JOURNAL_CHUNKS			(1 + NUM_BANKS)
+	
+	// Each record is one EEPROM page, there are two pages per chunk so an
+	// unchanged chunk is only copied forward once per lap of the journal
+	#define JOURNAL_PAGES			(2 * JOURNAL_CHUNKS)
+	#define JOURNAL_START_PAGE		(GESTURE_SETTINGS_START_PAGE + NUM_BANKS)
+	#define JOURNAL_DATA_SIZE		(EEPROM_PAGE_SIZE - 5)
+	
+	// A chunk is written once it has stopped changing, it is checked every
+	// JOURNAL_POLL_TIME * JOURNAL_CHUNKS mS and written after it is the same
+	// for JOURNAL_SETTLE_POLLS checks
+	#define JOURNAL_POLL_TIME		100		// mS
+	#define JOURNAL_SETTLE_POLLS	2
+
+/* Variables */
+	extern uint32_t journal_records_written;
+	extern uint16_t journal_boot_time;		// TCC0 counts (8 uS) taken by journal_init()
+
+/* Function Prototypes: */
+	void journal_init(void);
+	void journal_task(void);
+	void journal_reset(void);
+
+#endif /* JOURNAL_H_ */
@@ -21,6 +21,7 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */ 
 #include "jump_to_bootloader.h"
+#include "encoders.h"
 
 // This attribute ensures this variables is not initialized on reset
 uint32_t Boot_Key ATTR_NO_INIT;
@@ -48,6 +49,9 @@ void Bootloader_Jump_Check(void)
  */
 void Jump_To_Bootloader(void)
 {	
+	// Write back any settings still waiting to be saved
+	encoder_config_flush();
+
 	USB_Disable();
 	
 	cpu_irq_disable();
@@ -47,6 +47,8 @@
 #include "sequencer.h"
 #endif
 #include "self_test.h"
+#include "journal.h"
+#include "gesture.h"
 
 //#define DEMO 
 	
@@ -55,6 +57,19 @@ void board_init(void);
 
 bool watchdog_flag = false;
 
+uint16_t boot_config_load_time;
+uint16_t boot_usb_ready_time;
+
+// BOOT_TIMER free runs from system_init() until USB is configured, to time the
+// boot. Once it overflows the boot took too long to measure.
+static uint16_t boot_timer_read(void)
+{
+	if (tc_is_overflow(&BOOT_TIMER)) {
+		return 0xFFFF;
+	}
+	return tc_read_count(&BOOT_TIMER);
+}
+
 void Midifighter_Task(void); // -Wmissing-prototypes
  void Midifighter_Task(void) {
 	if (USB_DeviceState != DEVICE_STATE_Configured) {
@@ -62,12 +77,12 @@ void Midifighter_Task(void); // -Wmissing-prototypes
 	}
 	
 	#ifdef DEMO
-	if(update_encoder_switch_state() == 0x0001)
+	static bool demo_running = false;
+	if(!demo_running && update_encoder_switch_state() == 0x0001)
 	{
 		display_enable();
-		while(true){
-			rainbow_demo();
-		}
+		rainbow_demo();
+		demo_running = true;
 	}
 	#endif
 
@@ -82,37 +97,33 @@ void Midifighter_Task(void); // -Wmissing-prototypes
 			if (sleep_timeout_minutes > 0 && !sleep_mode_active) {
 				uint32_t timeout_ms = (uint32_t)sleep_timeout_minutes * 60000;
 				if (idle_timer >= timeout_ms) {
-					sleep_mode_active = true;
-					clear_display_buffer();
+					sleep_begin();
 				}
 			}
 
 			// Process any encoder movements or changes to the switch state
 			process_encoder_input();
+
+			// Find where the animations are up to for this pass
+			animation_phase_update();
 			
-			  if (sleep_mode_active) {
+			  if (display_overlay_tick()) {
+				  // A start up or confirmation animation has the display
+				  } else if (sleep_mode_active) {
 				  sleep_frame();
 				  } else {
 			
 		
-			// Check for any change to the encoder state and refresh the display, because
-			// redrawing any display is slow we only check and update 1 encoder per main loop
-			#if ENABLE_MAX_LED_UPDATE_SPEED > 0
-			#warning LED Controllers are being Updated at a Higher Speed! This results in latency up to 8ms.
-			// !Summer2016Update: improve LED Update Times
-			// Performance Testing: Dual Animations running on Every Encoder. MIDI Feedback sent Constantly 1-message/ millisecond.
-			// - Target Range is a maximum of 8ms.
-			// < 1: latency = 2ms
-			// < 4: latency in range (4-6ms)
-			// < 6: latency in range (6-8ms)*
-			// < 8: latency in range (8-10ms)
-			// < 16:latency = (16-20ms)
-			for(uint8_t encoder_display_counter = 0; encoder_display_counter < 6; encoder_display_counter++)
-			{
-				if (!get_bank_select_active()) {
-					update_encoder_display();
-				}
-			}
+			// Redraw any encoders whose display has changed, because redrawing is slow
+			// only DISPLAY_UPDATES_PER_PASS encoders are drawn per main loop
+			#if ENABLE_MAX_LED_UPDATE_SPEED > 0
+			// !Summer2016Update: improve LED Update Times
+			// Performance Testing: Dual Animations running on Every Encoder. MIDI Feedback sent Constantly 1-message/ millisecond.
+			// - Target Range is a maximum of 8ms.
+			// - Changed encoders are now drawn on the next pass rather than waiting for a round robin
+			if (!get_bank_select_active()) {
+				update_encoder_display();
+			}
 			#else
 			if (!get_bank_select_active() && !bank_change_animation_fading()) {
 				update_encoder_display();
@@ -229,6 +240,15 @@ void main_loop(void) {
 	// Read keys and motion tracking for User and MIDI events to process,
 	// setting LEDs to display the resulting state.
 	Midifighter_Task();
+	
+	// Forget taps which can no longer become a double-tap
+	gesture_task();
+
+	// Write back one queued EEPROM page if the last write has finished
+	journal_task();
+	encoder_config_task();
+	config_store_task();
+	eeprom_queue_task();
 	        
 	// Let the LUFA MIDI Device drivers have a go.
 	// MIDI_Device_USBTask(g_midi_interface_info);
@@ -259,12 +279,15 @@ int main (void)
 	input_init();
 	midi_init();
 	encoders_init();
+	boot_config_load_time = boot_timer_read();
 	side_switch_init();	
 	display_init();
 	#ifndef EXTENDED_BANKS
 	sequencer_init();
 	#endif
-	
+	// Restore the bank, toggles and encoder positions from before power off
+	journal_init();
+		
 	// Disable the display until we are connected and ready to start the 
 	// start-up animation.
 	display_disable();
@@ -331,6 +354,10 @@ void system_init()
 	XMEGACLK_StartPLL(CLOCK_SRC_INT_RC2MHZ, 2000000, F_CPU);
 	XMEGACLK_SetCPUClockSource(CLOCK_SRC_PLL);
 
+	// Start the boot timer (32 uS per count) now the CPU is at full speed
+	tc_enable(&BOOT_TIMER);
+	tc_write_clock_source(&BOOT_TIMER, TC_CLKSEL_DIV1024_gc);
+
 	/* Start the 32MHz internal RC oscillator and start the DFLL to increase it to 48MHz using the USB SOF as a reference */
 	XMEGACLK_StartInternalOscillator(CLOCK_SRC_INT_RC32MHZ);
 	XMEGACLK_StartDFLL(CLOCK_SRC_INT_RC32MHZ, DFLL_REF_INT_USBSOF, F_USB);
@@ -361,6 +388,13 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 {
 	bool ConfigSuccess = true;
 
+	// The first configuration ends the boot, stop the boot timer
+	if (!boot_usb_ready_time) {
+		boot_usb_ready_time = boot_timer_read();
+		tc_write_clock_source(&BOOT_TIMER, TC_CLKSEL_OFF_gc);
+		tc_disable(&BOOT_TIMER);
+	}
+
 	ConfigSuccess &= MIDI_Device_ConfigureEndpoints(g_midi_interface_info);
 
 	//LEDs_SetAllLEDs(ConfigSuccess ? LEDMASK_USB_READY : LEDMASK_USB_ERROR);
@@ -23,6 +23,7 @@
  * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */ 
 #include "midi.h"
+#include "animation_clock.h"
 //#include "display_driver.h"
 
 static midi_port_type_t midi_port_mode;
@@ -110,8 +111,10 @@ void set_midi_serial(void)
 		midi_port_mode = SERIAL_CONNECTION;
 		USB_Disable();
 		display_enable();
-		// Display the start up animation
+		// Display the start up animation, the main loop doesn't run without
+		// USB so it plays out here
 		run_sparkle(6);
+		display_overlay_finish();
 		// Build the display
 		set_op_mode(normal);
 		refresh_display();
@@ -247,19 +250,16 @@ void midi_clock(void)
 
 	// If not enabled enable MIDI Clock for animations 
 	// - !Summer2016Update: midi clock for animations
-	if(!midi_clock_enabled){animation_counter=0;midi_clock_enable(true);}
+	if(!midi_clock_enabled){animation_clock_reset();midi_clock_enable(true);}
+
+	// Lock the animations to this tick, see animation_phase_update()
+	animation_clock_pulse(tc_read_count(&TCC1), (uint8_t)tick_counter);
 
 	// Increment the tick counter
 	tick_counter+=1;
 	if(tick_counter >= 24) {
 		tick_counter = 0;
 	}
-
-	// MIDI Clock for Animations Servicing - !Summer2016Update: midi clock for animations
-	if (tick_counter % 3 == 2) // Increment animation_counter every 3rd clock tick.
-	{
-		animation_counter += 1;
-	}
 }
 
 void midi_clock_enable(bool state) // !Summer2016Update: midi clock for animations
@@ -286,6 +286,7 @@ void real_time_start(void)
 	tick_counter = 0;
 	average = 0;
 	prev_count = 0;
+	animation_clock_reset();
 	//// Todo: Send Note Offs for any active notes ..
 	clock_stable = false;
 #if 0	// XXX FIXME! conditioned out for -Wunused
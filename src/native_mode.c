@@ -40,6 +40,8 @@ typedef struct
 	native_mode_enc_indicator_config_t enc_indicator_configs[PHYSICAL_ENCODERS];
 	native_mode_enc_switch_config_t enc_switch_configs[PHYSICAL_ENCODERS];
 	uint8_t indicator_value_buffer[PHYSICAL_ENCODERS]; // Holds the 7 bit indicator value (native mode)
+	uint16_t indicator_dirty; // 1-bit per encoder, set when its indicator needs redrawing
+	uint16_t rgb_dirty; // 1-bit per encoder, set when its RGB needs redrawing
 } native_mode_state_t;
 
 native_mode_state_t nm_state;
@@ -59,12 +61,25 @@ static bool native_mode_set_active(bool active)
 }
 
 static inline bool is_in_range(uint8_t value, uint8_t min, uint8_t max) { return value >= min && value <= max; }
-static bool is_valid_enc_index(uint8_t value) { return is_in_range(value, 0, PHYSICAL_ENCODERS); }
+static bool is_valid_enc_index(uint8_t value) { return is_in_range(value, 0, PHYSICAL_ENCODERS - 1); }
 static bool is_valid_enc_indicator_display_type(uint8_t value) { return is_in_range(value, 0, NUM_DISPLAY_TYPES); }
 static bool is_sysex_byte_valid_bool(uint8_t value) { return value == 0 || value == 1; }
 static bool sysex_byte_to_bool(uint8_t value) { return value != 0; }
 static bool is_valid_enc_color(uint8_t value) { return is_in_range(value, 0, 0x7F); }
 
+// Schedules a redraw of part of an encoder, only what is flagged gets redrawn
+static void native_mode_mark_dirty(uint16_t *dirty_flags, uint8_t index)
+{
+	*dirty_flags |= (0x0001 << index);
+	mark_encoder_display_dirty(index);
+}
+
+void native_mode_invalidate_display(void)
+{
+	nm_state.indicator_dirty = 0xFFFF;
+	nm_state.rgb_dirty = 0xFFFF;
+}
+
 static void native_mode_reset_enc_indicator_config(uint8_t dest_index)
 {
 	static const native_mode_enc_indicator_config_t ENC_INDICATOR_CONFIG_DEFAULT = {0, 0, 0};
@@ -107,8 +122,12 @@ static bool native_mode_parse_sysex_enc_indicator_config(uint8_t length, uint8_t
 	if (!native_mode_is_enc_indicator_config_valid(&config_data.config))
 		return false;
 
-	nm_state.enc_indicator_configs[config_data.index] = config_data.config;
-	// native_mode_set_enc_indicator_config(index, enc_indicator_cfg_buffer);
+	const native_mode_enc_indicator_config_t *current = &nm_state.enc_indicator_configs[config_data.index];
+	if (current->display_type != config_data.config.display_type || current->has_detent != config_data.config.has_detent || current->detent_color != config_data.config.detent_color)
+	{
+		nm_state.enc_indicator_configs[config_data.index] = config_data.config;
+		native_mode_mark_dirty(&nm_state.indicator_dirty, config_data.index);
+	}
 	return true;
 }
 
@@ -134,7 +153,12 @@ static bool native_mode_parse_sysex_enc_switch_config(uint8_t length, uint8_t *b
 	if (!native_mode_is_enc_switch_config_valid(&config_data.config))
 		return false;
 
-	nm_state.enc_switch_configs[config_data.index] = config_data.config;
+	const native_mode_enc_switch_config_t *current = &nm_state.enc_switch_configs[config_data.index];
+	if (current->color_r != config_data.config.color_r || current->color_g != config_data.config.color_g || current->color_b != config_data.config.color_b)
+	{
+		nm_state.enc_switch_configs[config_data.index] = config_data.config;
+		native_mode_mark_dirty(&nm_state.rgb_dirty, config_data.index);
+	}
 	return true;
 }
 
@@ -198,7 +222,6 @@ static void native_mode_handle_sysex_enc_config(uint8_t length, uint8_t *buffer)
 			return;
 		}
 	}
-	refresh_display();
 }
 
 void native_mode_handle_sysex_command(uint8_t length, uint8_t *buffer)
@@ -222,7 +245,12 @@ bool native_mode_consume_midi_event(uint8_t type, uint8_t channel, uint8_t numbe
 	if (!native_mode_is_active() || type != SEND_CC || channel != NATIVE_MODE_MIDI_CHANNEL_ENC_POS || !is_in_range(number, 0, 0x7F))
 		return false;
 
-	nm_state.indicator_value_buffer[number] = value;
+	// Hosts resend positions that haven't changed, those need no redraw
+	if (is_valid_enc_index(number) && nm_state.indicator_value_buffer[number] != value)
+	{
+		nm_state.indicator_value_buffer[number] = value;
+		native_mode_mark_dirty(&nm_state.indicator_dirty, number);
+	}
 	return true;
 }
 
@@ -231,15 +259,26 @@ bool native_mode_update_encoder_display_single(const uint8_t idx)
 {
 	if (!native_mode_is_active())
 		return false;
-	set_encoder_indicator_level(
-		idx, nm_state.indicator_value_buffer[idx],
-		nm_state.enc_indicator_configs[idx].has_detent,
-		nm_state.enc_indicator_configs[idx].display_type,
-		nm_state.enc_indicator_configs[idx].detent_color,
-		0x7F);
-	uint32_t rgb_color =
-		((uint32_t)nm_state.enc_switch_configs[idx].color_r << (16 + NATIVE_MODE_BITSHIFT_SYSEX_TO_BYTE)) | ((uint32_t)nm_state.enc_switch_configs[idx].color_g << (8 + NATIVE_MODE_BITSHIFT_SYSEX_TO_BYTE)) | ((uint32_t)nm_state.enc_switch_configs[idx].color_b << (0 + NATIVE_MODE_BITSHIFT_SYSEX_TO_BYTE));
-	build_rgb(idx, rgb_color, false);
+	// Clean encoders are left alone, the display sweep calls this for every
+	// encoder whether anything changed or not
+	const uint16_t bit = 0x0001 << idx;
+	if (nm_state.indicator_dirty & bit)
+	{
+		nm_state.indicator_dirty &= ~bit;
+		set_encoder_indicator_level(
+			idx, nm_state.indicator_value_buffer[idx],
+			nm_state.enc_indicator_configs[idx].has_detent,
+			nm_state.enc_indicator_configs[idx].display_type,
+			nm_state.enc_indicator_configs[idx].detent_color,
+			0x7F);
+	}
+	if (nm_state.rgb_dirty & bit)
+	{
+		nm_state.rgb_dirty &= ~bit;
+		uint32_t rgb_color =
+			((uint32_t)nm_state.enc_switch_configs[idx].color_r << (16 + NATIVE_MODE_BITSHIFT_SYSEX_TO_BYTE)) | ((uint32_t)nm_state.enc_switch_configs[idx].color_g << (8 + NATIVE_MODE_BITSHIFT_SYSEX_TO_BYTE)) | ((uint32_t)nm_state.enc_switch_configs[idx].color_b << (0 + NATIVE_MODE_BITSHIFT_SYSEX_TO_BYTE));
+		build_rgb(idx, rgb_color, false);
+	}
 	return true;
 }
 
@@ -13,6 +13,8 @@
 
     //returns true if the encoder display was updated for native mode
     bool native_mode_update_encoder_display_single(uint8_t idx);
+    //forces every encoder to be redrawn, for when something else has drawn over the display
+    void native_mode_invalidate_display(void);
 
     //returns true if encoder rotary input was processed by native mode
     bool native_mode_process_encoder_input_rotary(uint8_t idx, int16_t delta);
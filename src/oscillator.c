@@ -0,0 +1,89 @@
+/*
+ * oscillator.c
+ *
+ * Phase accumulator oscillators for the LED animations, see oscillator.h
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+#include <oscillator.h>
+
+// First quarter of a sine wave, 127 * sin(pi/2 * i/64), the other three 
+// quarters are mirrored from it
+static const int8_t sine_quarter_table[65] PROGMEM = {
+	  0,   3,   6,   9,  12,  16,  19,  22,  25,  28,  31,  34,  37,  40,  43,  46,
+	 49,  51,  54,  57,  60,  63,  65,  68,  71,  73,  76,  78,  81,  83,  85,  88,
+	 90,  92,  94,  96,  98, 100, 102, 104, 106, 107, 109, 111, 112, 113, 115, 116,
+	117, 118, 120, 121, 122, 122, 123, 124, 125, 125, 126, 126, 126, 127, 127, 127,
+	127
+};
+
+// Held values for the sample and hold shape
+static const int8_t sample_hold_table[16] PROGMEM = {
+	-45, 115, -89, -26,  39, -115, -109,  83,
+	 10, -103, -34,  22, -113, 105,   2, -73
+};
+
+/**
+ * Returns the value of a waveform at a point in its cycle.
+ *
+ * \param shape [in]	The waveform, one of osc_shape_t
+ *
+ * \param phase [in]	Position in the cycle, 0 - 65535 is one full cycle
+ *
+ * \return	-127 - 127, sine and triangle start at 0 rising
+ */
+int8_t osc_wave(uint8_t shape, uint16_t phase)
+{
+	uint8_t step = (uint8_t)(phase >> 8);
+	
+	switch (shape) {
+		case OSC_SINE: {
+			uint8_t idx = step & 0x3F;
+			if (step & 0x40) {
+				idx = 64 - idx;
+			}
+			int8_t value = (int8_t)pgm_read_byte(&sine_quarter_table[idx]);
+			return (step & 0x80) ? -value : value;
+		}
+		case OSC_TRIANGLE: {
+			step += 64;
+			uint8_t value = (step & 0x80) ? (uint8_t)(255 - step) : step;
+			return (int8_t)(value * 2 - 127);
+		}
+		case OSC_RAMP: {
+			return step ? (int8_t)(step - 128) : -127;
+		}
+		case OSC_SAMPLE_HOLD: {
+			return (int8_t)pgm_read_byte(&sample_hold_table[step >> 4]);
+		}
+		default:
+			return 0;
+	}
+}
+
+/**
+ * Advances an oscillator by one frame.
+ *
+ * \param osc [in]	The oscillator, its phase is moved on by its increment
+ *
+ * \return	The oscillator output at the new phase, -127 - 127
+ */
+int8_t osc_next(oscillator_t *osc)
+{
+	osc->phase += osc->increment;
+	return osc_wave(osc->shape, osc->phase);
+}
@@ -0,0 +1,59 @@
+/*
+ * oscillator.h
+ *
+ * Phase accumulator oscillators for the LED animations. A 16-bit phase
+ * covers one cycle, so an oscillator's speed is the amount added to its
+ * phase each frame and its shape is picked from a small wavetable.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+
+#ifndef OSCILLATOR_H_
+#define OSCILLATOR_H_
+
+/*	Includes: */
+	#include <stdint.h>
+	#include <avr/pgmspace.h>
+
+/*	Macros: */
+	// Phase of one full cycle, and phase offsets used for the RGB rainbows
+	#define OSC_PHASE_CYCLE		65536UL
+	#define OSC_PHASE_THIRD		21845
+	
+	// Converts a bipolar oscillator output (-127 - 127) into 1 - 255
+	#define OSC_UNIPOLAR(v)		((uint8_t)(128 + (v)))
+
+/*	Types: */
+	typedef enum {
+		OSC_SINE,
+		OSC_TRIANGLE,
+		OSC_RAMP,			// Rises through the cycle then drops back
+		OSC_SAMPLE_HOLD,	// 16 random steps per cycle
+		NUM_OSC_SHAPES		// this must always be the last entry
+	} osc_shape_t;
+	
+	typedef struct {
+		uint16_t phase;
+		uint16_t increment;	// Phase added by each call to osc_next
+		uint8_t  shape;
+	} oscillator_t;
+
+/* Function Prototypes: */
+	int8_t osc_wave(uint8_t shape, uint16_t phase);
+	int8_t osc_next(oscillator_t *osc);
+
+#endif /* OSCILLATOR_H_ */
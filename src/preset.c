@@ -0,0 +1,204 @@
+/*
+ * preset.c
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <util/crc16.h>
+
+#include "preset.h"
+#include "config.h"
+#include "display_driver.h"
+#include "midi.h"
+
+#if PRESET_SLOTS * PRESET_SLOT_SIZE > APPTABLE_SECTION_SIZE
+#error The presets do not fit in the application table section
+#endif
+#if PRESET_SLOTS > 7
+#error The SysEx reply has 7 bits for the stored slots
+#endif
+
+#define NO_PRESET			0xFF
+
+// The SPM instruction which writes the flash only works from the boot section,
+// which holds the USB bootloader, so the slots are programmed with the firmware
+// image rather than by the application. A recall reads the slot straight in to
+// the settings in use and leaves the EEPROM alone. Settings changed while the
+// preset is in use stay in RAM too, so the saved settings all come back at the
+// next power up rather than a mix of the two.
+
+uint16_t preset_recall_time;
+
+static uint8_t preset_current = NO_PRESET;	// Slot in use
+static flash_addr_t preset_read_address;	// Slot read by read_preset_page()
+
+static flash_addr_t preset_address(uint8_t slot)
+{
+	return PRESET_FLASH_START + ((flash_addr_t)slot * PRESET_SLOT_SIZE);
+}
+
+static uint16_t preset_crc(const uint8_t *data, uint16_t crc)
+{
+	for (uint8_t i = 0; i < EEPROM_PAGE_SIZE; ++i) {
+		crc = _crc_ccitt_update(crc, data[i]);
+	}
+	return crc;
+}
+
+// Reads one settings page from the slot at preset_read_address
+static void read_preset_page(uint8_t page, uint8_t *buffer)
+{
+	nvm_flash_read_buffer(preset_read_address + ((page - CONFIG_STORE_START_PAGE) * EEPROM_PAGE_SIZE),
+						  buffer, EEPROM_PAGE_SIZE);
+}
+
+/**
+ * Checks a slot holds a whole preset, saved with the current settings layout.
+ *
+ * \param slot [in]		Preset slot
+ *
+ * \return True if the preset can be recalled
+ */
+bool preset_is_stored(uint8_t slot)
+{
+	if (slot >= PRESET_SLOTS) {
+		return false;
+	}
+
+	uint8_t header[PRESET_HEADER_SIZE];
+	preset_read_address = preset_address(slot);
+	nvm_flash_read_buffer(preset_read_address + PRESET_IMAGE_SIZE, header, PRESET_HEADER_SIZE);
+	if (header[PRESET_HEADER_MAGIC] != PRESET_MAGIC || header[PRESET_HEADER_LAYOUT] != EEPROM_LAYOUT) {
+		return false;
+	}
+
+	uint8_t buffer[EEPROM_PAGE_SIZE];
+	uint16_t crc = 0xFFFF;
+	for (uint8_t page = 0; page < CONFIG_STORE_PAGES; ++page) {
+		read_preset_page(CONFIG_STORE_START_PAGE + page, buffer);
+		crc = preset_crc(buffer, crc);
+	}
+	return crc == (header[PRESET_HEADER_CRC] | ((uint16_t)header[PRESET_HEADER_CRC + 1] << 8));
+}
+
+/**
+ * Checks whether a recalled preset is in use, in place of the settings saved
+ * in the EEPROM. Settings changes are not saved while it is.
+ */
+bool preset_in_use(void)
+{
+	return preset_current != NO_PRESET;
+}
+
+/**
+ * Puts a stored preset in to use. The settings are decoded straight from the
+ * flash in to RAM and nothing is written to the EEPROM. The time taken is kept
+ * in preset_recall_time.
+ *
+ * \param slot [in]		Preset slot
+ *
+ * \return PRESET_OK if the preset is now in use
+ */
+preset_result_t preset_recall(uint8_t slot)
+{
+	uint16_t start = tc_read_count(&TCC0);
+
+	if (slot >= PRESET_SLOTS) {
+		return PRESET_BAD_SLOT;
+	}
+	if (!preset_is_stored(slot)) {
+		return PRESET_EMPTY;
+	}
+
+	uint8_t settings[EEPROM_PAGE_SIZE];
+	read_preset_page(DEV_SETTINGS_START_PAGE, settings);
+	apply_config(settings);
+	encoders_load_settings(read_preset_page);
+	refresh_display();
+
+	preset_current = slot;
+	preset_recall_time = tc_read_count(&TCC0) - start;
+	return PRESET_OK;
+}
+
+/**
+ * Recalls the next stored preset after the one in use, wrapping round to the
+ * first slot. Used by the CYCLE_PRESET side switch action.
+ *
+ * \return PRESET_EMPTY if no slot holds a preset
+ */
+preset_result_t preset_recall_next(void)
+{
+	uint8_t slot = preset_current;
+	for (uint8_t i = 0; i < PRESET_SLOTS; ++i) {
+		slot = (slot >= PRESET_SLOTS - 1) ? 0 : slot + 1;
+		preset_result_t result = preset_recall(slot);
+		if (result != PRESET_EMPTY) {
+			return result;
+		}
+	}
+	return PRESET_EMPTY;
+}
+
+/**
+ * Handles SYSEX_COMMAND_PRESET: recalls a slot, or just reports which slots
+ * hold a preset. Every action is answered with PRESET_SYSEX_REPLY, the action,
+ * the slot, the preset_result_t and a bit per slot holding a preset.
+ */
+void preset_handle_sysex_command(uint8_t length, uint8_t *buffer)
+{
+	if (length == 0) {
+		return;
+	}
+
+	uint8_t action = buffer[0];
+	uint8_t slot = (length > 1) ? buffer[1] : NO_PRESET;
+	preset_result_t result;
+
+	switch (action) {
+		case PRESET_SYSEX_RECALL:
+		result = preset_recall(slot);
+		break;
+		case PRESET_SYSEX_STATUS:
+		result = PRESET_OK;
+		break;
+		default:
+		return;
+	}
+
+	if (result == PRESET_OK && action != PRESET_SYSEX_STATUS) {
+		setting_confirmation_animation(PRESET_CONFIRM_COLOR);
+	}
+
+	uint8_t stored = 0;
+	for (uint8_t i = 0; i < PRESET_SLOTS; ++i) {
+		if (preset_is_stored(i)) {
+			stored |= 1 << i;
+		}
+	}
+
+	uint8_t payload[] = {
+		0xF0, 0x00, MANUFACTURER_ID >> 8, MANUFACTURER_ID & 0x7F,
+		SYSEX_COMMAND_PRESET,
+		PRESET_SYSEX_REPLY,
+		action,
+		slot & 0x7F,
+		result,
+		stored,
+		0xF7
+	};
+	midi_stream_sysex(sizeof(payload), payload);
+}
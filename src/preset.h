@@ -0,0 +1,78 @@
+/*
+ * preset.h
+ *
+ * Full device presets kept in the application table section of the flash.
+ * Each slot holds a copy of every settings page (global, encoder and gesture
+ * settings) as laid out in the EEPROM, so a whole setup can be swapped in
+ * without a SysEx transfer from the host and without writing the EEPROM.
+ * The slots are programmed along with the firmware, the application can't
+ * write the flash itself.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef PRESET_H_
+#define PRESET_H_
+
+/*	Includes: */
+	#include <asf.h>
+
+	#include "constants.h"
+	#include "config_store.h"
+
+/*	Macros: */
+	// A slot is the settings pages followed by a header, rounded up to whole
+	// flash pages. The slots fill the application table section from its start.
+	#define PRESET_SLOTS			5
+	#define PRESET_FLASH_START		APPTABLE_SECTION_START
+	#define PRESET_IMAGE_SIZE		(CONFIG_STORE_PAGES * EEPROM_PAGE_SIZE)
+	#define PRESET_HEADER_SIZE		4
+	#define PRESET_SLOT_PAGES		((PRESET_IMAGE_SIZE + PRESET_HEADER_SIZE + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE)
+	#define PRESET_SLOT_SIZE		(PRESET_SLOT_PAGES * FLASH_PAGE_SIZE)
+
+	// Header layout, it follows the settings pages
+	#define PRESET_HEADER_MAGIC		0
+	#define PRESET_HEADER_LAYOUT	1	// EEPROM_LAYOUT of the settings pages
+	#define PRESET_HEADER_CRC		2	// 2 bytes, LSB first, CRC-CCITT over the settings pages
+	#define PRESET_MAGIC			0xA7
+
+	// Side switch and SysEx recall confirmation color
+	#define PRESET_CONFIRM_COLOR	0xFF00FF
+
+	// SysEx actions, sent after SYSEX_COMMAND_PRESET
+	#define PRESET_SYSEX_RECALL		0x0		// Followed by the slot
+	#define PRESET_SYSEX_STATUS		0x1
+	#define PRESET_SYSEX_REPLY		0x2
+
+/* Types: */
+	typedef enum {
+		PRESET_OK,
+		PRESET_BAD_SLOT,
+		PRESET_EMPTY,			// Nothing stored, or stored with an older settings layout
+	} preset_result_t;
+
+/* Variables */
+	extern uint16_t preset_recall_time;		// TCC0 counts (8 uS) taken by the last recall
+
+/* Function Prototypes: */
+	bool preset_is_stored(uint8_t slot);
+	bool preset_in_use(void);
+	preset_result_t preset_recall(uint8_t slot);
+	preset_result_t preset_recall_next(void);
+	void preset_handle_sysex_command(uint8_t length, uint8_t *buffer);
+
+#endif /* PRESET_H_ */
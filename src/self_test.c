@@ -60,7 +60,7 @@ bool check_self_test(void)
 {
 #ifdef FACTORY_CODE
 
-		uint8_t flag = eeprom_read_byte(EE_SELF_TEST_FLAG);
+		uint8_t flag = eeprom_read(EE_SELF_TEST_FLAG);
 		
 #if defined(PCB_TEST)
 	
@@ -23,8 +23,89 @@
 
 	#include "sequencer_display.h"
 
+	// What was last drawn on each encoder, so the display states can redraw
+	// every pass and only the LEDs which changed are touched. The indicator
+	// key is either a pattern (SEQ_DRAWN_PATTERN set) or a position, and both
+	// include the brightness.
+	#define SEQ_DRAWN_PATTERN	0x01000000
+
+	static uint32_t seq_drawn_indicator[16];
+	static uint16_t seq_drawn_rgb[16];
+	static uint16_t seq_drawn_indicator_valid;
+	static uint16_t seq_drawn_rgb_valid;
+
+	/**
+	 * Forgets what the sequencer display last drew, so everything is drawn
+	 * again. Needed whenever something else has drawn on the display.
+	 */
+	void invalidate_seq_display(void)
+	{
+		seq_drawn_indicator_valid = 0x0000;
+		seq_drawn_rgb_valid = 0x0000;
+	}
+
+	// Returns true if the indicator doesn't already show key, and records it
+	static bool seq_indicator_changed(uint8_t encoder, uint32_t key)
+	{
+		uint16_t bit = 0x0001 << encoder;
+		if ((seq_drawn_indicator_valid & bit) && seq_drawn_indicator[encoder] == key) {
+			return false;
+		}
+		seq_drawn_indicator[encoder] = key;
+		seq_drawn_indicator_valid |= bit;
+		return true;
+	}
+
+	static void seq_set_indicator_pattern_level(uint8_t encoder, uint16_t pattern, uint8_t brightness)
+	{
+		if (seq_indicator_changed(encoder, SEQ_DRAWN_PATTERN | ((uint32_t)brightness << 16) | pattern)) {
+			set_indicator_pattern_level(encoder, pattern, brightness);
+		}
+	}
+
+	static void seq_set_indicator_pattern(uint8_t encoder, uint16_t pattern)
+	{
+		seq_set_indicator_pattern_level(encoder, pattern, pgm_read_byte(&brightnessMap[global_ind_brightness]));
+	}
+
+	static void seq_set_encoder_indicator_level(uint8_t encoder, uint8_t position, bool has_detent, uint16_t type,
+												uint8_t detent_color, uint8_t brightness)
+	{
+		uint32_t key = ((uint32_t)type << 25) | ((uint32_t)brightness << 16) | ((uint16_t)detent_color << 8) |
+					   (has_detent ? 0x80 : 0x00) | (position & 0x7F);
+		if (seq_indicator_changed(encoder, key)) {
+			set_encoder_indicator_level(encoder, position, has_detent, type, detent_color, brightness);
+		}
+	}
+
+	void seq_set_encoder_indicator(uint8_t encoder, uint8_t position, bool has_detent, uint16_t type, uint8_t detent_color)
+	{
+		seq_set_encoder_indicator_level(encoder, position, has_detent, type, detent_color,
+										pgm_read_byte(&brightnessMap[global_ind_brightness]));
+	}
+
+	static void seq_set_encoder_rgb_level(uint8_t encoder, uint8_t color, uint8_t brightness)
+	{
+		uint16_t bit = 0x0001 << encoder;
+		uint16_t key = ((uint16_t)color << 8) | brightness;
+		if ((seq_drawn_rgb_valid & bit) && seq_drawn_rgb[encoder] == key) {
+			return;
+		}
+		seq_drawn_rgb[encoder] = key;
+		seq_drawn_rgb_valid |= bit;
+		set_encoder_rgb_level(encoder, color, brightness);
+	}
+
+	static void seq_set_encoder_rgb(uint8_t encoder, uint8_t color)
+	{
+		seq_set_encoder_rgb_level(encoder, color, pgm_read_byte(&brightnessMap[global_rgb_brightness]));
+	}
+
 	void init_seq_display(void)
 	{
+		// The display was showing another state or mode
+		invalidate_seq_display();
+
 		switch (sequencerDisplayState) {
 			case OFF:{
 
@@ -66,39 +147,39 @@
 		
 			// If FX send is enabled for a slot we turn on the RGB of th clip selector encoder
 			if(slotSettings[i].fx_send){
-				set_encoder_rgb_level(i, FX_ON_COLOR, rgb_brightness);
+				seq_set_encoder_rgb_level(i, FX_ON_COLOR, rgb_brightness);
 			} else {
-				set_encoder_rgb(i, 0);
+				seq_set_encoder_rgb(i, 0);
 			}
 	
 			// Draw the clip selection indicators
-			set_indicator_pattern_level(i, 0x8000 >> get_slot_clip(i), ind_brightness);
+			seq_set_indicator_pattern_level(i, 0x8000 >> get_slot_clip(i), ind_brightness);
 			sequencerRawValue[i] = get_slot_clip(i)*1270;
 		
 			// Draw the pattern selection indicators
-			set_indicator_pattern_level(i+4, 0x8000 >> slotSelectedBuffer[i], ind_brightness);
+			seq_set_indicator_pattern_level(i+4, 0x8000 >> slotSelectedBuffer[i], ind_brightness);
 			sequencerRawValue[i+4] = slotSelectedBuffer[i] * 1270;
 
 			// Draw the mute on/off indicators
 			if(!slotSettings[i].mute_on){
-				set_encoder_rgb_level(8+i, MUTE_COLOR, rgb_brightness);
+				seq_set_encoder_rgb_level(8+i, MUTE_COLOR, rgb_brightness);
 			} else {
-				set_encoder_rgb(8+i, 0);
+				seq_set_encoder_rgb(8+i, 0);
 			}
 		
 			// Draw the volume indicators
-			set_encoder_indicator_level(8+i, slotSettings[i].volume, false, BAR, 0, ind_brightness);
+			seq_set_encoder_indicator_level(8+i, slotSettings[i].volume, false, BAR, 0, ind_brightness);
 			sequencerRawValue[8+i] = slotSettings[i].volume*100;
 		
 			// Draw the filter on/off indicators
 			if(slotSettings[i].filter_on){
-				set_encoder_rgb_level(12+i, FILTER_COLOR, rgb_brightness);
+				seq_set_encoder_rgb_level(12+i, FILTER_COLOR, rgb_brightness);
 				} else {
-				set_encoder_rgb(12+i, 0);
+				seq_set_encoder_rgb(12+i, 0);
 			}
 
 			// Draw the filter indicators
-			set_encoder_indicator_level(12+i, slotSettings[i].filter, true, BAR, FILTER_DETENT_COLOR, ind_brightness);
+			seq_set_encoder_indicator_level(12+i, slotSettings[i].filter, true, BAR, FILTER_DETENT_COLOR, ind_brightness);
 			sequencerRawValue[12+i] = slotSettings[i].filter*100;
 		}
 	}
@@ -112,11 +193,11 @@
 		// or empty by setting its RGB to a certain color
 		for(uint8_t i=0;i<16;++i){
 			if (bit & memory_slot_state){
-				set_encoder_rgb(i, MEMORY_SLOT_FULL_COLOR);
+				seq_set_encoder_rgb(i, MEMORY_SLOT_FULL_COLOR);
 			} else {
-				set_encoder_rgb(i, 0);
+				seq_set_encoder_rgb(i, 0);
 			}
-			set_encoder_indicator(i, 0, false, BAR, 0);
+			seq_set_encoder_indicator(i, 0, false, BAR, 0);
 			sequencerRawValue[i] = 12700;
 			bit <<=1;
 		}
@@ -128,12 +209,12 @@
 			uint8_t state = get_step_state(selectedSlot, i);
 			// Set the RGB to Red if step active, off if inactive
 			if(state){
-				set_encoder_rgb(i, ACTIVE_COLOR);
+				seq_set_encoder_rgb(i, ACTIVE_COLOR);
 				} else {
-				set_encoder_rgb(i, INACTIVE_COLOR);
+				seq_set_encoder_rgb(i, INACTIVE_COLOR);
 			}
 			// Set the encoder indicator to match the step level
-			set_encoder_indicator(i, state, false, BAR, 0);
+			seq_set_encoder_indicator(i, state, false, BAR, 0);
 			sequencerRawValue[i] = state*100;
 		}
 	}
@@ -152,8 +233,8 @@
 	
 		switch (sequencerDisplayState) {
 			case OFF:{
-				set_encoder_indicator(idx, 0,0,0,0);
-				set_encoder_rgb(idx, 0x50);
+				seq_set_encoder_indicator(idx, 0,0,0,0);
+				seq_set_encoder_rgb(idx, 0x50);
 			}
 			break;
 			case DEFAULT:{
@@ -196,7 +277,7 @@
 				brightness = !slotSettings[idx].mute_on ? ind_bright : 10;
 			
 				// If we are currently in playback of a recorded sequence draw the clip selection for this step
-				set_indicator_pattern_level(idx, 0x8000 >> get_slot_clip(idx), brightness);
+				seq_set_indicator_pattern_level(idx, 0x8000 >> get_slot_clip(idx), brightness);
 			}
 			break;
 		
@@ -208,10 +289,10 @@
 				// If beat roll is active draw the beat roll display
 				if (mod_level[idx-4]){
 					uint8_t rate = mod_level[idx-4]/10;
-					set_indicator_pattern_level(idx, indicator_pattern[rate], brightness);
+					seq_set_indicator_pattern_level(idx, indicator_pattern[rate], brightness);
 				// Otherwise draw the current pattern selection
 				} else {
-					set_indicator_pattern_level(idx, 0x8000 >> slotSelectedBuffer[idx-4], brightness);
+					seq_set_indicator_pattern_level(idx, 0x8000 >> slotSelectedBuffer[idx-4], brightness);
 				}
 			
 				// If the current step is enabled for this pattern set the RGB on
@@ -227,15 +308,15 @@
 					brightness = !slotSettings[idx-4].mute_on ? rgb_bright : 10;
 					if(clock_is_stable()){
 						if(current_step == 0){
-							set_encoder_rgb_level(idx, SEQ_DOWN_BEAT_COLOR, brightness);
+							seq_set_encoder_rgb_level(idx, SEQ_DOWN_BEAT_COLOR, brightness);
 						} else {
-							set_encoder_rgb_level(idx, seqBeatColor, brightness);
+							seq_set_encoder_rgb_level(idx, seqBeatColor, brightness);
 						}
 					} else {
-						set_encoder_rgb_level(idx, 0x50, brightness);
+						seq_set_encoder_rgb_level(idx, 0x50, brightness);
 					}
 				} else {
-					set_encoder_rgb(idx, 0);
+					seq_set_encoder_rgb(idx, 0);
 				}
 			}
 			break;
@@ -243,14 +324,14 @@
 			// Draw the slot volume indicator
 			case volumeAdjust: {
 				uint8_t brightness = !slotSettings[idx-8].mute_on ? 127 : 10;
-				set_encoder_indicator_level(idx, slotSettings[idx-8].volume, false, BLENDED_BAR, 0, brightness);
+				seq_set_encoder_indicator_level(idx, slotSettings[idx-8].volume, false, BLENDED_BAR, 0, brightness);
 			}
 			break;
 		
 			// Draw the slot filter indicator
 			case filterAdjust: {
 				uint8_t brightness = !slotSettings[idx-12].mute_on ? 127 : 10;
-				set_encoder_indicator_level(idx, slotSettings[idx-12].filter, true, BLENDED_BAR, FILTER_DETENT_COLOR, brightness);
+				seq_set_encoder_indicator_level(idx, slotSettings[idx-12].filter, true, BLENDED_BAR, FILTER_DETENT_COLOR, brightness);
 			}
 			break;
 		}
@@ -277,19 +358,19 @@
 
 		if(idx == current_step){
 			// Then draw the beat cursor
-			set_encoder_rgb(idx, seqBeatColor);
+			seq_set_encoder_rgb(idx, seqBeatColor);
 			// And refresh the last position to prevent ghosting on the display
 			uint8_t last = (idx == 0) ? 15 : (idx-1);
 			state = get_step_state(selectedSlot, last);
 			uint8_t color = state ? ACTIVE_COLOR : INACTIVE_COLOR;
-			set_encoder_rgb(last, color);
+			seq_set_encoder_rgb(last, color);
 		} else {
 			// Otherwise draw the state color
 			state = get_step_state(selectedSlot, idx);
 			if(state){
-				set_encoder_rgb(idx, ACTIVE_COLOR);
+				seq_set_encoder_rgb(idx, ACTIVE_COLOR);
 				} else {
-				set_encoder_rgb(idx, INACTIVE_COLOR);
+				seq_set_encoder_rgb(idx, INACTIVE_COLOR);
 			}
 		}
 	}
@@ -305,7 +386,7 @@
 			if (spinner_position <= 11){
 				uint16_t dot_pattern = 0x8000 >> (divider-1);
 				dot_pattern |= 0xFFFF8000 >> spinner_position;
-				set_indicator_pattern(active_memory_slot, dot_pattern);
+				seq_set_indicator_pattern(active_memory_slot, dot_pattern);
 			}
 			lastIndex = rythmIndex;	
 		}
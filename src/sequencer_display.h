@@ -52,6 +52,9 @@
 /* Function Prototypes: */
 
 	void init_seq_display(void);
+	void invalidate_seq_display(void);
+	
+	void seq_set_encoder_indicator(uint8_t encoder, uint8_t position, bool has_detent, uint16_t type, uint8_t detent_color);
 	
 	void build_default_display(void);
 	void build_pattern_edit_display(void);
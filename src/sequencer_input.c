@@ -138,7 +138,7 @@ void process_sequencer_input(void)
 					}				
 			} else if (sequencerDisplayState == PATTERN_EDIT) {
 				set_step_state(selectedSlot, i,  control_change_value);
-				set_encoder_indicator(i, control_change_value, false, BAR, 0);
+				seq_set_encoder_indicator(i, control_change_value, false, BAR, 0);
 			} else if (sequencerDisplayState == PATTERN_MEMORY){
 				if (i == active_memory_slot){
 					truncate_value = control_change_value;
@@ -259,11 +259,11 @@ void process_seq_enc_buttons(uint8_t switch_idx, bool downpress)
 			// In pattern edit mode the switch toggles the trigger state for that step	
 			if (downpress) {
 				if(!get_step_state(selectedSlot, switch_idx)){
-					set_encoder_indicator(switch_idx, 127, false, BAR, 0);
+					seq_set_encoder_indicator(switch_idx, 127, false, BAR, 0);
 					sequencerRawValue[switch_idx] = 12700;
 					set_step_state(selectedSlot, switch_idx, 127);
 				} else {
-					set_encoder_indicator(switch_idx, 0, false, BAR, 0);
+					seq_set_encoder_indicator(switch_idx, 0, false, BAR, 0);
 					sequencerRawValue[switch_idx] = 0;
 					set_step_state(selectedSlot, switch_idx, 0);
 				}
@@ -448,9 +448,8 @@ void save_pattern_memory(uint8_t memory_slot)
 		}
 	}
 	
-	// Now the page buffer is full so we can write this page to EEPROM
-	nvm_eeprom_load_page_to_buffer(page_buffer);
-	nvm_eeprom_atomic_write_page(page_index);
+	// Now the page buffer is full so we can queue this page for EEPROM
+	eeprom_queue_write_page(page_index, page_buffer);
 	
 	// Reset the buffer_ptr
 	buffer_ptr = page_buffer;
@@ -490,9 +489,8 @@ void save_pattern_memory(uint8_t memory_slot)
 	// Increment the page_index for the second page write
 	page_index++;
 	
-	// Now the page buffer is full so we can write this page to EEPROM
-	nvm_eeprom_load_page_to_buffer(page_buffer);
-	nvm_eeprom_atomic_write_page(page_index);
+	// Now the page buffer is full so we can queue this page for EEPROM
+	eeprom_queue_write_page(page_index, page_buffer);
 	
 	wdt_enable();
 }
@@ -27,6 +27,8 @@
 #include <side_switch.h>
 #include "native_mode.h"
 #include <display_driver.h>
+#include <gesture.h>
+#include "preset.h"
 
 
 // Holds all configurable side switch settings
@@ -71,6 +73,11 @@ op_mode_t get_op_mode(void){
  * Sets the op mode setting
  */
 void set_op_mode(op_mode_t new_mode){
+	if (new_mode != mode) {
+		// The shift pages only redraw what has changed, so they need to
+		// know the display was showing something else
+		invalidate_shift_mode_display();
+	}
 	mode = new_mode;
 }
 
@@ -405,5 +412,29 @@ void do_side_switch_function(uint8_t switch_num, switch_event_t state)
 			}
 		}
 		break;
+		case CC_LONG_PRESS_SS:{}
+		// cascade to the next case ... NO BREAK ON PURPOSE
+		case CC_DOUBLE_TAP_SS:{
+			// Side switches use the default gesture times
+			gesture_t gesture = gesture_process(GESTURE_SIDE_SWITCH_OFFSET + switch_num, state, 
+									DEF_GESTURE_LONG_PRESS_TIME, DEF_GESTURE_DOUBLE_TAP_TIME,
+									side_sw_cfg.sw_action[switch_num] == CC_DOUBLE_TAP_SS ? GESTURE_DOUBLE_TAP : GESTURE_NONE);
+			uint8_t bit = 0x01 << switch_num;
+			if ((side_sw_cfg.sw_action[switch_num] == CC_LONG_PRESS_SS && gesture == GESTURE_LONG_PRESS) ||
+				(side_sw_cfg.sw_action[switch_num] == CC_DOUBLE_TAP_SS && gesture == GESTURE_DOUBLE_TAP)) {
+				side_switch_toggle_state[bank] |= bit;
+				midi_stream_raw_cc(midi_system_channel, SIDE_SWITCH_OFFSET + switch_num + (bank*6) , 127);
+			} else if (gesture == GESTURE_RELEASE && (side_switch_toggle_state[bank] & bit)) {
+				side_switch_toggle_state[bank] &= ~bit;
+				midi_stream_raw_cc(midi_system_channel, SIDE_SWITCH_OFFSET + switch_num + (bank*6) , 0);
+			}
+		}
+		break;
+		case CYCLE_PRESET:{
+			if (state == SW_DOWN && preset_recall_next() == PRESET_OK) {
+				setting_confirmation_animation(PRESET_CONFIRM_COLOR);
+			}
+		}
+		break;
 	}
 }
@@ -57,6 +57,9 @@
 			GLOBAL_BANK_7,
 			GLOBAL_BANK_8,
 			CYCLE_BANK,
+			CC_LONG_PRESS_SS,	// CC 127 once held for the long-press time, 0 on release
+			CC_DOUBLE_TAP_SS,	// CC 127 on the second press of a double-tap, 0 on release
+			CYCLE_PRESET,		// Recalls the next stored preset
 
 		} side_sw_action_t;
 	
@@ -0,0 +1,244 @@
+/*
+ * clock_sim.c
+ *
+ * Host side test of the MIDI clock animation lock. Feeds src/animation_clock.c
+ * a clock with random timing jitter at a range of tempos, plus a tempo ramp
+ * and a song restart, samples the animation phase every main loop pass and
+ * reports its error against the true beat. The same clock is also counted the
+ * way the firmware used to, one animation step every third pulse, for
+ * comparison.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -O2 -Isrc -o clock_sim tools/clock_sim/clock_sim.c -lm
+ *   ./clock_sim [-s steady|ramp|restart|all] [-j jitter_ms] [-l loop_ms] [-r seed]
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Compile the firmware's clock lock straight into the test so the code under
+// test is exactly the one that ships.
+#include "../../src/animation_clock.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/*	Macros: */
+	#define SIM_STEPS_PER_BEAT	(ANIMATION_CLOCK_PULSES_PER_BEAT / ANIMATION_CLOCK_PULSES_PER_STEP)
+	#define SIM_MAX_PULSES		16384
+	#define SIM_SETTLE_BEATS	2		// Errors are not counted until the lock has settled
+	#define SIM_RUN_S			30.0
+
+/*	Types: */
+	typedef struct {
+		double sum;
+		double sum_sq;
+		double max;
+		uint32_t count;
+	} sim_error_t;
+
+/*	Variables */
+	static double jitter_ms = 2.0;		// Pulses arrive up to this early or late
+	static double loop_ms = 1.0;		// Main loop pass time, the phase is read once a pass
+	static uint32_t rng_state = 1;
+
+	static double pulse_true[SIM_MAX_PULSES];	// When each pulse was due
+	static double pulse_sent[SIM_MAX_PULSES];	// When it arrived
+	static uint8_t pulse_beat[SIM_MAX_PULSES];	// Its position in the beat, 0 - 23
+	static uint16_t pulse_count;
+
+static uint32_t sim_random(void)
+{
+	// xorshift32, reproducible for a given seed
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+// Uniform in -1 .. 1
+static double sim_uniform(void)
+{
+	return (double)(sim_random() & 0xFFFF) / 32767.5 - 1.0;
+}
+
+static uint16_t sim_timer(double t)
+{
+	return (uint16_t)(uint32_t)(t * ANIMATION_CLOCK_TIMER_HZ);
+}
+
+/**
+ * Queues the clock pulses for a run. The tempo moves linearly from start_bpm
+ * to end_bpm, and if restart_s is set the song restarts from its first beat
+ * at that time, wherever the last beat had got to.
+ */
+static void queue_clock(double start_bpm, double end_bpm, double restart_s)
+{
+	double t = 0.1;
+	uint8_t beat_pulse = 0;
+	bool restarted = false;
+
+	pulse_count = 0;
+	while (t < SIM_RUN_S && pulse_count < SIM_MAX_PULSES) {
+		if (restart_s > 0.0 && !restarted && t >= restart_s) {
+			beat_pulse = 0;
+			restarted = true;
+		}
+		pulse_true[pulse_count] = t;
+		pulse_sent[pulse_count] = t + sim_uniform() * jitter_ms / 1000.0;
+		pulse_beat[pulse_count] = beat_pulse;
+		++pulse_count;
+
+		double bpm = start_bpm + (end_bpm - start_bpm) * t / SIM_RUN_S;
+		t += 60.0 / (bpm * ANIMATION_CLOCK_PULSES_PER_BEAT);
+		beat_pulse = (beat_pulse + 1) % ANIMATION_CLOCK_PULSES_PER_BEAT;
+	}
+}
+
+// Difference between two positions in the beat, -half a beat .. half a beat
+static double beat_difference(double a, double b)
+{
+	double d = fmod(a - b, SIM_STEPS_PER_BEAT);
+	if (d >= SIM_STEPS_PER_BEAT / 2.0) {
+		d -= SIM_STEPS_PER_BEAT;
+	} else if (d < -SIM_STEPS_PER_BEAT / 2.0) {
+		d += SIM_STEPS_PER_BEAT;
+	}
+	return d;
+}
+
+static void add_error(sim_error_t *e, double ms)
+{
+	e->sum += ms;
+	e->sum_sq += ms * ms;
+	if (fabs(ms) > e->max) {
+		e->max = fabs(ms);
+	}
+	e->count++;
+}
+
+/**
+ * Runs the queued clock through the lock, reading the phase every main loop
+ * pass the way the display code does. The errors are measured in the beat,
+ * so a phase exactly one or more beats out counts as on the beat.
+ */
+static void run_clock(const char *name, double start_bpm, double end_bpm)
+{
+	sim_error_t locked = {0};
+	sim_error_t counted = {0};
+	uint32_t backwards = 0;
+	uint16_t last_phase = 0;
+	uint16_t next_pulse = 0;
+	uint16_t counted_pulses = 0;
+
+	animation_clock_reset();
+
+	for (double t = 0.0; t < SIM_RUN_S; t += loop_ms / 1000.0) {
+		// Clock messages that arrived since the last pass, in order
+		while (next_pulse < pulse_count && pulse_sent[next_pulse] <= t) {
+			animation_clock_pulse(sim_timer(pulse_sent[next_pulse]), pulse_beat[next_pulse]);
+			++counted_pulses;
+			++next_pulse;
+		}
+		if (t >= pulse_true[pulse_count - 1]) {
+			break;
+		}
+		if (next_pulse < 2) {
+			continue;
+		}
+
+		// True position from the due times of the pulses either side
+		uint16_t i = 0;
+		while (i + 1 < pulse_count && pulse_true[i + 1] <= t) {
+			++i;
+		}
+		double pulse_period = pulse_true[i + 1] - pulse_true[i];
+		double step_ms = pulse_period * ANIMATION_CLOCK_PULSES_PER_STEP * 1000.0;
+		double true_steps = (pulse_beat[i] + (t - pulse_true[i]) / pulse_period) / ANIMATION_CLOCK_PULSES_PER_STEP;
+
+		uint16_t phase = animation_clock_phase(sim_timer(t));
+		if ((int16_t)(phase - last_phase) < 0) {
+			++backwards;
+		}
+		last_phase = phase;
+
+		// Skip the settling time, and a restart until the unit has been told
+		// about it by the first pulse after it
+		bool restart_pending = (pulse_beat[i + 1] != (pulse_beat[i] + 1) % ANIMATION_CLOCK_PULSES_PER_BEAT) ||
+							   (next_pulse <= i && pulse_beat[i] != (pulse_beat[i - 1] + 1) % ANIMATION_CLOCK_PULSES_PER_BEAT);
+		if (pulse_true[i] < 0.1 + SIM_SETTLE_BEATS * 60.0 / start_bpm || restart_pending) {
+			continue;
+		}
+		add_error(&locked, beat_difference(phase / 256.0, true_steps) * step_ms);
+		add_error(&counted, beat_difference((counted_pulses - 1) / ANIMATION_CLOCK_PULSES_PER_STEP, true_steps) * step_ms);
+	}
+
+	printf("%-8s %4.0f %4.0f  %7.2f %7.2f %7.2f  %7.2f %7.2f %7.2f  %5lu\n", name, start_bpm, end_bpm,
+		   counted.sum / counted.count, sqrt(counted.sum_sq / counted.count), counted.max,
+		   locked.sum / locked.count, sqrt(locked.sum_sq / locked.count), locked.max,
+		   (unsigned long)backwards);
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "usage: %s [-s steady|ramp|restart|all] [-j jitter_ms] [-l loop_ms] [-r seed]\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *scenario = "all";
+
+	for (int i = 1; i < argc; ++i) {
+		if (i + 1 < argc && !strcmp(argv[i], "-s")) {
+			scenario = argv[++i];
+		} else if (i + 1 < argc && !strcmp(argv[i], "-j")) {
+			jitter_ms = atof(argv[++i]);
+		} else if (i + 1 < argc && !strcmp(argv[i], "-l")) {
+			loop_ms = atof(argv[++i]);
+		} else if (i + 1 < argc && !strcmp(argv[i], "-r")) {
+			rng_state = (uint32_t)strtoul(argv[++i], NULL, 0);
+			if (!rng_state) rng_state = 1;
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	printf("clock jitter +/-%.2fms, main loop %.2fms, phase error in ms (mean rms max)\n", jitter_ms, loop_ms);
+	printf("%-8s %4s %4s  %23s  %23s  %5s\n", "scenario", "bpm", "to", "every 3rd pulse", "locked", "back");
+
+	static const double steady_bpm[] = {60, 90, 120, 140, 174, 240, 300};
+
+	bool all = !strcmp(scenario, "all");
+	if (all || !strcmp(scenario, "steady")) {
+		for (uint8_t i = 0; i < sizeof(steady_bpm) / sizeof(steady_bpm[0]); ++i) {
+			queue_clock(steady_bpm[i], steady_bpm[i], 0.0);
+			run_clock("steady", steady_bpm[i], steady_bpm[i]);
+		}
+	}
+	if (all || !strcmp(scenario, "ramp")) {
+		queue_clock(120, 140, 0.0);
+		run_clock("ramp", 120, 140);
+		queue_clock(174, 87, 0.0);
+		run_clock("ramp", 174, 87);
+	}
+	if (all || !strcmp(scenario, "restart")) {
+		queue_clock(128, 128, 10.37);
+		run_clock("restart", 128, 128);
+	}
+	return 0;
+}
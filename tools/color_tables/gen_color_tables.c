@@ -0,0 +1,152 @@
+/*
+ * gen_color_tables.c
+ *
+ * Generates src/color_tables.c, the gamma curves, white balance and PWM
+ * level conversions used by build_rgb() and the indicator drawing functions.
+ * 
+ * Regenerate the tables from the repository root:
+ *   gcc -std=gnu99 -Isrc -o gen_color_tables tools/color_tables/gen_color_tables.c -lm
+ *   ./gen_color_tables > src/color_tables.c
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+#include <color_tables.h>
+
+// Per-channel white balance gains for the 2026 color map (255 = 1.0x)
+#define GAIN_R 140
+#define GAIN_G 245
+#define GAIN_B 235
+
+static const float gamma_exponents[GAMMA_TABLES] = {
+	2.2f,	// GAMMA_CURVE_2_2
+	2.8f,	// GAMMA_CURVE_2_8
+	5.0f,	// GAMMA_TABLE_LEGACY_RED
+	2.5f,	// GAMMA_TABLE_LEGACY_GREEN
+};
+
+static const char *gamma_names[GAMMA_TABLES] = {
+	"Gamma 2.2",
+	"Gamma 2.8",
+	"Legacy red, x^5.0",
+	"Legacy green, x^2.5",
+};
+
+static const char *color_level_names[COLOR_LEVEL_TABLES] = {
+	"Plain",
+	"Red, white balanced",
+	"Green, white balanced",
+	"Blue, white balanced",
+};
+
+static const uint8_t color_level_gains[COLOR_LEVEL_TABLES] = {255, GAIN_R, GAIN_G, GAIN_B};
+
+/**
+ * The selectable curves are rounded. The legacy curves truncate, the same as 
+ * the pow() calls in the animations they replace.
+ */
+static uint8_t gamma_value(uint8_t table, uint8_t value)
+{
+	float x = 255.0f * powf(value / 255.0f, gamma_exponents[table]);
+	if (table >= GAMMA_TABLE_LEGACY_RED) {
+		return (uint8_t)x;
+	}
+	return (uint8_t)(x + 0.5f);
+}
+
+// bcm_level() from display_driver.c
+static uint8_t step_level(uint8_t steps)
+{
+	if (steps >= COLOR_TABLE_PWM_STEPS) {
+		return COLOR_TABLE_LEVEL_MAX;
+	}
+	return (uint8_t)(((uint16_t)steps * COLOR_TABLE_LEVEL_MAX + COLOR_TABLE_PWM_STEPS/2) / COLOR_TABLE_PWM_STEPS);
+}
+
+// scale8() white balance followed by bcm_color_level() from display_driver.c
+static uint8_t color_level(uint8_t table, uint8_t value)
+{
+	uint8_t balanced = (uint8_t)(((uint16_t)value * color_level_gains[table]) / 255u);
+	return step_level((uint8_t)(((uint16_t)balanced + 1) >> 1));
+}
+
+static void print_table(const char *name, uint8_t table, uint8_t (*fn)(uint8_t, uint8_t))
+{
+	printf("\t{ // %s\n", name);
+	for (uint16_t value = 0; value < 256; value++) {
+		printf("%s%3u,", (value % 16) ? " " : "\t\t", fn(table, (uint8_t)value));
+		if (value % 16 == 15) {
+			printf("\n");
+		}
+	}
+	printf("\t},\n");
+}
+
+int main(void)
+{
+	printf("/*\n");
+	printf(" * color_tables.c\n");
+	printf(" *\n");
+	printf(" * Generated by tools/color_tables/gen_color_tables.c, do not edit.\n");
+	printf(" *\n");
+	printf(" * Gamma curves, 8-bit channel to bit-plane level conversions (with and\n");
+	printf(" * without white balance) and brightness step to bit-plane level.\n");
+	printf(" *\n");
+	printf(" * DJTT - Midi Fighter Twister - Embedded Software License\n");
+	printf(" * Copyright (c) 2026: DJ TechTools\n");
+	printf(" * Permission is hereby granted, free of charge, to any person owning or possessing \n");
+	printf(" * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source \n");
+	printf(" * code for personal use. Person may not publish, distribute, sublicense, or sell \n");
+	printf(" * the source code (modified or un-modified). Person may not use this source code \n");
+	printf(" * or any diminutive works for commercial purposes. The permission to use this source \n");
+	printf(" * code is also subject to the following conditions:\n");
+	printf(" * THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, \n");
+	printf(" * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A \n");
+	printf(" * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT \n");
+	printf(" * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION \n");
+	printf(" * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE \n");
+	printf(" * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.\n");
+	printf(" */\n\n");
+	printf("#include <avr/pgmspace.h>\n");
+	printf("#include <color_tables.h>\n\n");
+
+	printf("const uint8_t gamma_tables[GAMMA_TABLES][256] PROGMEM = {\n");
+	for (uint8_t table = 0; table < GAMMA_TABLES; table++) {
+		print_table(gamma_names[table], table, gamma_value);
+	}
+	printf("};\n\n");
+
+	printf("const uint8_t color_level_tables[COLOR_LEVEL_TABLES][256] PROGMEM = {\n");
+	for (uint8_t table = 0; table < COLOR_LEVEL_TABLES; table++) {
+		print_table(color_level_names[table], table, color_level);
+	}
+	printf("};\n\n");
+
+	printf("const uint8_t step_level_table[COLOR_TABLE_PWM_STEPS + 1] PROGMEM = {\n");
+	for (uint8_t steps = 0; steps <= COLOR_TABLE_PWM_STEPS; steps++) {
+		printf("%s%3u,", (steps % 16) ? " " : "\t", step_level(steps));
+		if (steps % 16 == 15 || steps == COLOR_TABLE_PWM_STEPS) {
+			printf("\n");
+		}
+	}
+	printf("};\n");
+	return 0;
+}
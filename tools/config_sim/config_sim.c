@@ -0,0 +1,680 @@
+/*
+ * config_sim.c
+ *
+ * Host side test of the settings store. Boots the firmware's settings check
+ * on synthetic EEPROM images of every layout this firmware has saved, checks
+ * each one is migrated in place without losing a setting, and that unknown
+ * layouts and damaged settings are caught. It then cuts the power after every
+ * page write of a migration and of a settings save, and checks each of those
+ * images still boots to the same settings. The power is also cut half way
+ * through every page write, and a torn settings page must be caught rather
+ * than sealed. Last it counts the EEPROM writes a saved edit costs.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -O2 -fcommon -Itools/display_sim -Isrc -o config_sim tools/config_sim/config_sim.c
+ *   ./config_sim [-s layouts|unknown|corrupt|migrate_cut|save_cut|writes|all] [-r seed]
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Compile the firmware's EEPROM queue and settings store straight into the
+// test, against the display emulator's ASF stand-ins, so the code under test
+// is exactly the one that ships.
+#include "../../src/eeprom.c"
+#include "../../src/config_store.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+	#define SIM_EEPROM_SIZE		EEPROM_SIZE
+	#define SIM_MAX_SNAPSHOTS	128
+	#define SIM_LOOP_PASSES		1000	// Main loop passes run after each boot
+	#define SIM_NOT_TORN		0xFF
+	#define SIM_EDITS			100		// Settings edits saved by the writes scenario
+	#define SIM_SEAL			0xFFFF	// Damages the seal record's value
+
+	// Settings region and the journal which follows it
+	#define SIM_CONFIG_END		((CONFIG_STORE_START_PAGE + CONFIG_STORE_PAGES) * EEPROM_PAGE_SIZE)
+	#define SIM_GESTURE_START	(GESTURE_SETTINGS_START_PAGE * EEPROM_PAGE_SIZE)
+	#define SIM_GUARD_START		(EEPROM_GUARD_FIRST_PAGE * EEPROM_PAGE_SIZE)
+
+	// Layout 8 as saved by each firmware generation which wrote it
+	typedef enum {
+		SIM_LAYOUT_8_RELEASE,		// Before the gesture times
+		SIM_LAYOUT_8_GESTURES,		// Before the gamma curve and brightness cap
+		SIM_LAYOUT_8_COLOR,			// Everything but the settings CRC
+		SIM_LAYOUT_8_GENERATIONS,
+	} sim_layout_8_t;
+
+	// One power up, shared with the child process which runs it
+	typedef struct {
+		uint8_t image[SIM_EEPROM_SIZE];		// In: EEPROM at power up, out: at power down
+		config_store_result_t result;
+		uint32_t page_writes;
+		uint32_t most_byte_writes;			// Most times any one byte was programmed
+		uint32_t bytes_read;				// By the boot check
+		bool record;						// Keep a copy of the EEPROM half way through and after each page write
+		uint8_t snapshot_count;
+		uint8_t snapshots[SIM_MAX_SNAPSHOTS][SIM_EEPROM_SIZE];
+		uint8_t torn_page[SIM_MAX_SNAPSHOTS];	// Page the snapshot has torn, or SIM_NOT_TORN
+	} sim_boot_t;
+
+	TC0_t TCC0, TCD0;
+	TC1_t TCC1, TCD1;
+	NVM_t NVM;
+
+	static uint8_t sim_eeprom[SIM_EEPROM_SIZE];
+	static uint8_t sim_eeprom_page[EEPROM_PAGE_SIZE];
+	static bool sim_eeprom_loaded[EEPROM_PAGE_SIZE];	// Page buffer locations loaded since the last write
+	static uint32_t sim_byte_writes[SIM_EEPROM_SIZE];
+	static uint32_t sim_bytes_read;
+	static sim_boot_t *sim_boot_state;		// Shared memory
+	static uint8_t sim_saved[SIM_EEPROM_SIZE];
+
+/* ASF stand-ins ------------------------------------------------------------ */
+
+irqflags_t cpu_irq_save(void) { return 0; }
+void cpu_irq_restore(irqflags_t flags) { (void)flags; }
+uint16_t tc_read_count(TC0_t *tc) { (void)tc; return 0; }
+
+void nvm_eeprom_read_buffer(uint16_t address, void *buffer, uint16_t length)
+{
+	memcpy(buffer, &sim_eeprom[address], length);
+	sim_bytes_read += length;
+}
+
+void nvm_eeprom_load_byte_to_buffer(uint8_t byte_addr, uint8_t value)
+{
+	sim_eeprom_page[byte_addr % EEPROM_PAGE_SIZE] = value;
+	sim_eeprom_loaded[byte_addr % EEPROM_PAGE_SIZE] = true;
+}
+
+// Keeps a copy of the EEPROM as it would be if the power went now
+static void sim_snapshot(uint8_t torn_page)
+{
+	sim_boot_t *boot = sim_boot_state;
+	if (boot->record && boot->snapshot_count < SIM_MAX_SNAPSHOTS) {
+		boot->torn_page[boot->snapshot_count] = torn_page;
+		memcpy(boot->snapshots[boot->snapshot_count++], sim_eeprom, SIM_EEPROM_SIZE);
+	}
+}
+
+// Page writes finish straight away and only touch the loaded locations. Half
+// way through, the first half of those holds the new data and the second half
+// is still erased.
+void nvm_eeprom_atomic_write_page(uint8_t page)
+{
+	uint8_t *data = &sim_eeprom[page * EEPROM_PAGE_SIZE];
+
+	if (sim_boot_state->record) {
+		uint8_t whole[EEPROM_PAGE_SIZE];
+		uint8_t loaded = 0;
+		memcpy(whole, data, EEPROM_PAGE_SIZE);
+		for (uint8_t i = 0; i < EEPROM_PAGE_SIZE; ++i) {
+			if (sim_eeprom_loaded[i]) {
+				loaded++;
+			}
+		}
+		for (uint8_t i = 0, done = 0; i < EEPROM_PAGE_SIZE; ++i) {
+			if (sim_eeprom_loaded[i]) {
+				data[i] = (done++ < loaded / 2) ? sim_eeprom_page[i] : 0xFF;
+			}
+		}
+		sim_snapshot(page);
+		memcpy(data, whole, EEPROM_PAGE_SIZE);
+	}
+
+	for (uint8_t i = 0; i < EEPROM_PAGE_SIZE; ++i) {
+		if (sim_eeprom_loaded[i]) {
+			data[i] = sim_eeprom_page[i];
+			sim_byte_writes[page * EEPROM_PAGE_SIZE + i]++;
+			sim_eeprom_loaded[i] = false;
+		}
+	}
+	sim_snapshot(SIM_NOT_TORN);
+}
+
+void nvm_wait_until_ready(void)
+{
+	if (NVM.INTCTRL & NVM_EELVL_gm) {
+		NVM_EE_vect();
+	}
+}
+
+/* Power ups ---------------------------------------------------------------- */
+
+static void sim_main_loop(void)
+{
+	for (uint16_t i = 0; i < SIM_LOOP_PASSES; ++i) {
+		nvm_wait_until_ready();
+		config_store_task();
+		eeprom_queue_task();
+	}
+	eeprom_queue_flush();
+}
+
+/**
+ * Powers the unit up on boot->image in a child process, so every boot starts
+ * from the firmware's power on state. The settings are checked, session runs
+ * (if there is one) and then the main loop, and the EEPROM is returned in
+ * boot->image.
+ */
+static void sim_power_up(sim_boot_t *boot, void (*session)(void))
+{
+	boot->snapshot_count = 0;
+	fflush(stdout);
+
+	pid_t pid = fork();
+	if (pid == 0) {
+		sim_boot_state = boot;
+		memcpy(sim_eeprom, boot->image, SIM_EEPROM_SIZE);
+
+		boot->result = config_store_check();
+		boot->bytes_read = sim_bytes_read;
+		if (session) {
+			session();
+		}
+		sim_main_loop();
+
+		boot->page_writes = eeprom_page_writes;
+		boot->most_byte_writes = 0;
+		for (uint16_t i = 0; i < SIM_EEPROM_SIZE; ++i) {
+			if (sim_byte_writes[i] > boot->most_byte_writes) {
+				boot->most_byte_writes = sim_byte_writes[i];
+			}
+		}
+		memcpy(boot->image, sim_eeprom, SIM_EEPROM_SIZE);
+		exit(0);
+	}
+
+	int status;
+	waitpid(pid, &status, 0);
+	if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+		fprintf(stderr, "Power up crashed\n");
+		exit(1);
+	}
+}
+
+static sim_boot_t *sim_new_boot(void)
+{
+	sim_boot_t *boot = mmap(NULL, sizeof(sim_boot_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (boot == MAP_FAILED) {
+		perror("mmap");
+		exit(1);
+	}
+	memset(boot, 0, sizeof(*boot));
+	return boot;
+}
+
+static const char *sim_result_name(config_store_result_t result)
+{
+	switch (result) {
+		case CONFIG_STORE_VALID:	return "valid";
+		case CONFIG_STORE_MIGRATED:	return "migrated";
+		case CONFIG_STORE_FINISHED:	return "finished";
+		default:					return "invalid";
+	}
+}
+
+/* Images ------------------------------------------------------------------- */
+
+static uint8_t sim_random_7bit(void)
+{
+	return (uint8_t)(rand() & 0x7F);
+}
+
+/**
+ * Builds the EEPROM of a unit which was last run by firmware of one of the
+ * layout 8 generations, with random settings. The journal pages hold random
+ * data, which must be left alone.
+ */
+static void sim_layout_8_image(uint8_t *image, sim_layout_8_t generation)
+{
+	memset(image, 0xFF, SIM_EEPROM_SIZE);
+
+	image[EE_EEPROM_VERSION] = 8;
+	image[EE_SELF_TEST_FLAG] = 0x42;
+	for (uint16_t address = EE_MIDI_CHANNEL + 2; address <= EE_BANK_ANIMATIONS_ENABLED; ++address) {
+		image[address] = sim_random_7bit();
+	}
+	image[EE_MIDI_CHANNEL] = sim_random_7bit() & 0x0F;
+
+	for (uint16_t address = ENC_SETTINGS_START_PAGE * EEPROM_PAGE_SIZE; address < SIM_GESTURE_START; ++address) {
+		image[address] = (uint8_t)rand();
+	}
+	if (generation >= SIM_LAYOUT_8_GESTURES) {
+		for (uint16_t address = SIM_GESTURE_START; address < SIM_CONFIG_END; ++address) {
+			image[address] = 1 + (rand() % 0x7F);
+		}
+	}
+	if (generation >= SIM_LAYOUT_8_COLOR) {
+		image[EE_GAMMA_CURVE] = 1 + (rand() % 2);
+		image[EE_BRIGHTNESS_CAP] = 1 + (rand() % 0x7E);
+	}
+
+	for (uint16_t address = SIM_CONFIG_END; address < SIM_CONFIG_END + (2 * EEPROM_PAGE_SIZE); ++address) {
+		image[address] = (uint8_t)rand();
+	}
+}
+
+// The current layout, made by migrating a layout 8 image with every setting
+static void sim_current_image(sim_boot_t *boot)
+{
+	sim_layout_8_image(boot->image, SIM_LAYOUT_8_COLOR);
+	sim_power_up(boot, NULL);
+}
+
+/**
+ * Checks a migrated image holds the same settings as the layout 8 image it came
+ * from, with defaults where the old firmware had left a setting erased.
+ */
+static bool sim_check_migrated(const uint8_t *before, const uint8_t *after)
+{
+	for (uint16_t address = 0; address < SIM_EEPROM_SIZE; ++address) {
+		uint8_t expected = before[address];
+
+		if (address == EE_EEPROM_VERSION) {
+			expected = EEPROM_LAYOUT;
+		} else if (address >= SIM_GUARD_START) {
+			continue;
+		} else if (before[address] == 0xFF) {
+			if (address == EE_GAMMA_CURVE) {
+				expected = DEF_GAMMA_CURVE;
+			} else if (address == EE_BRIGHTNESS_CAP) {
+				expected = DEF_BRIGHTNESS_CAP;
+			} else if (address >= SIM_GESTURE_START && address < SIM_CONFIG_END) {
+				expected = (address % GESTURE_EE_SIZE) ? DEF_GESTURE_DOUBLE_TAP_TIME : DEF_GESTURE_LONG_PRESS_TIME;
+			}
+		}
+
+		if (after[address] != expected) {
+			printf("    0x%03X is 0x%02X, expected 0x%02X\n", address, after[address], expected);
+			return false;
+		}
+	}
+	return true;
+}
+
+// Boots an image again, it must check out as valid without writing anything
+static bool sim_check_settled(sim_boot_t *boot)
+{
+	uint8_t before[SIM_EEPROM_SIZE];
+	memcpy(before, boot->image, SIM_EEPROM_SIZE);
+
+	sim_power_up(boot, NULL);
+	if (boot->result != CONFIG_STORE_VALID || boot->page_writes || memcmp(before, boot->image, SIM_EEPROM_SIZE)) {
+		printf("    reboot was %s with %u page writes\n", sim_result_name(boot->result), boot->page_writes);
+		return false;
+	}
+	return true;
+}
+
+// Address of the value held by the seal record an image was sealed with
+static uint16_t sim_seal_address(const uint8_t *image)
+{
+	for (uint8_t i = 0; i < EEPROM_GUARD_RECORDS; ++i) {
+		const uint8_t *record = &image[SIM_GUARD_START + i * EEPROM_GUARD_RECORD_SIZE];
+		uint16_t crc = record[GUARD_CRC] | ((uint16_t)record[GUARD_CRC + 1] << 8);
+		if (record[GUARD_PAGE] == GUARD_SEAL && crc == eeprom_crc(record, GUARD_CRC)) {
+			return SIM_GUARD_START + i * EEPROM_GUARD_RECORD_SIZE + GUARD_SEAL_VALUE;
+		}
+	}
+	printf("    no seal record\n");
+	exit(1);
+}
+
+/* Scenarios ---------------------------------------------------------------- */
+
+// Every layout 8 generation migrates in place, and the current layout is kept
+static bool sim_scenario_layouts(sim_boot_t *boot)
+{
+	static const char *names[SIM_LAYOUT_8_GENERATIONS] = {"8 release", "8 gestures", "8 color"};
+	uint8_t before[SIM_EEPROM_SIZE];
+	bool passed = true;
+
+	for (uint8_t generation = 0; generation < SIM_LAYOUT_8_GENERATIONS; ++generation) {
+		sim_layout_8_image(boot->image, generation);
+		memcpy(before, boot->image, SIM_EEPROM_SIZE);
+
+		sim_power_up(boot, NULL);
+		bool ok = boot->result == CONFIG_STORE_MIGRATED;
+		printf("  layout %-11s %-8s %u page writes\n", names[generation], sim_result_name(boot->result), boot->page_writes);
+		ok = ok && sim_check_migrated(before, boot->image);
+		ok = ok && sim_check_settled(boot);
+		passed &= ok;
+	}
+
+	sim_current_image(boot);
+	memcpy(before, boot->image, SIM_EEPROM_SIZE);
+	sim_power_up(boot, NULL);
+	bool ok = boot->result == CONFIG_STORE_VALID && !boot->page_writes && !memcmp(before, boot->image, SIM_EEPROM_SIZE);
+	printf("  layout %-11u %-8s %u page writes, %u bytes read by the check\n", EEPROM_LAYOUT,
+		   sim_result_name(boot->result), boot->page_writes, boot->bytes_read);
+	passed &= ok;
+
+	return passed;
+}
+
+// Blank EEPROM and layouts with no migration need a factory reset
+static bool sim_scenario_unknown(sim_boot_t *boot)
+{
+	static const uint8_t layouts[] = {0xFF, 0, 7, EEPROM_LAYOUT + 1};
+	bool passed = true;
+
+	for (uint8_t i = 0; i < sizeof(layouts); ++i) {
+		sim_layout_8_image(boot->image, SIM_LAYOUT_8_COLOR);
+		boot->image[EE_EEPROM_VERSION] = layouts[i];
+		sim_power_up(boot, NULL);
+		printf("  layout %-11u %s\n", layouts[i], sim_result_name(boot->result));
+		passed &= boot->result == CONFIG_STORE_INVALID;
+	}
+	return passed;
+}
+
+// Any damaged setting fails the CRC, the self test flag isn't a setting. A
+// damaged seal falls back to the record before it, the write of an intact page.
+static bool sim_scenario_corrupt(sim_boot_t *boot)
+{
+	static const struct {
+		const char *name;
+		uint16_t address;
+		config_store_result_t expected;
+	} damage[] = {
+		{"global setting",	EE_RGB_BRIGHTNESS,								CONFIG_STORE_INVALID},
+		{"encoder setting",	(ENC_SETTINGS_START_PAGE * EEPROM_PAGE_SIZE) + 77,	CONFIG_STORE_INVALID},
+		{"gesture time",	SIM_CONFIG_END - 1,								CONFIG_STORE_INVALID},
+		{"seal",			SIM_SEAL,										CONFIG_STORE_FINISHED},
+		{"self test flag",	EE_SELF_TEST_FLAG,								CONFIG_STORE_VALID},
+		{"journal",			SIM_CONFIG_END,									CONFIG_STORE_VALID},
+	};
+	bool passed = true;
+
+	for (uint8_t i = 0; i < sizeof(damage) / sizeof(damage[0]); ++i) {
+		sim_current_image(boot);
+		uint16_t address = damage[i].address;
+		if (address == SIM_SEAL) {
+			address = sim_seal_address(boot->image);
+		}
+		boot->image[address] ^= 0x10;
+		sim_power_up(boot, NULL);
+		printf("  %-16s %s\n", damage[i].name, sim_result_name(boot->result));
+		passed &= boot->result == damage[i].expected;
+	}
+	return passed;
+}
+
+/**
+ * Boots each image recorded during a power up as if the power had gone during
+ * or just after that page write. Every one must boot (possibly finishing the
+ * interrupted work) to an image with the settings of either end of the
+ * interrupted work, which is then settled. The only exception is a settings
+ * page torn part way through its write, which must be found and the settings
+ * reset.
+ */
+static bool sim_check_cuts(sim_boot_t *boot, const uint8_t *old_image, const uint8_t *new_image)
+{
+	static sim_boot_t *cut;
+	if (!cut) {
+		cut = sim_new_boot();
+	}
+
+	uint8_t count = boot->snapshot_count;
+	uint8_t results[CONFIG_STORE_INVALID + 1] = {0};
+	uint8_t torn = 0;
+	bool passed = true;
+
+	for (uint8_t i = 0; i < count; ++i) {
+		memcpy(cut->image, boot->snapshots[i], SIM_EEPROM_SIZE);
+		sim_power_up(cut, NULL);
+		results[cut->result]++;
+
+		uint8_t torn_page = boot->torn_page[i];
+		if (torn_page != SIM_NOT_TORN) {
+			torn++;
+		}
+		if (torn_page < CONFIG_STORE_START_PAGE + CONFIG_STORE_PAGES && cut->result == CONFIG_STORE_INVALID) {
+			// Found, the firmware resets the settings
+			continue;
+		}
+
+		bool ok = cut->result != CONFIG_STORE_INVALID;
+		// Each encoder and gesture page must be all old or all new
+		for (uint16_t page = 0; ok && page < CONFIG_STORE_PAGES; ++page) {
+			uint16_t address = page * EEPROM_PAGE_SIZE;
+			uint8_t copy[EEPROM_PAGE_SIZE];
+			memcpy(copy, &cut->image[address], EEPROM_PAGE_SIZE);
+			if (page == 0) {
+				// The layout version is checked by settling
+				copy[EE_EEPROM_VERSION] = new_image[EE_EEPROM_VERSION];
+			}
+			if (page == 0) {
+				// Global settings are saved a byte at a time
+				for (uint8_t i = 0; ok && i < EEPROM_PAGE_SIZE; ++i) {
+					ok = copy[i] == new_image[address + i] || copy[i] == old_image[address + i];
+				}
+			} else {
+				ok = !memcmp(copy, &new_image[address], EEPROM_PAGE_SIZE) ||
+					 !memcmp(copy, &old_image[address], EEPROM_PAGE_SIZE);
+			}
+			if (!ok) {
+				printf("    cut %u: page %u is neither old nor new\n", i + 1, page);
+			}
+		}
+		ok = ok && sim_check_settled(cut);
+		if (!ok) {
+			printf("    cut %u booted %s\n", i + 1, sim_result_name(cut->result));
+		}
+		passed &= ok;
+	}
+
+	printf("  %u cuts (%u torn): %u valid, %u migrated, %u finished, %u invalid\n", count, torn,
+		   results[CONFIG_STORE_VALID], results[CONFIG_STORE_MIGRATED], results[CONFIG_STORE_FINISHED],
+		   results[CONFIG_STORE_INVALID]);
+	return passed && count > 0;
+}
+
+// Power lost part way through migrating a layout 8 unit
+static bool sim_scenario_migrate_cut(sim_boot_t *boot)
+{
+	uint8_t before[SIM_EEPROM_SIZE];
+	sim_layout_8_image(boot->image, SIM_LAYOUT_8_RELEASE);
+	memcpy(before, boot->image, SIM_EEPROM_SIZE);
+
+	boot->record = true;
+	sim_power_up(boot, NULL);
+	boot->record = false;
+
+	bool passed = boot->result == CONFIG_STORE_MIGRATED && sim_check_migrated(before, boot->image);
+	return sim_check_cuts(boot, before, boot->image) && passed;
+}
+
+// Saves new global, encoder and gesture settings the way the firmware does
+static void sim_save_session(void)
+{
+	config_store_write_byte(EE_RGB_BRIGHTNESS, sim_saved[EE_RGB_BRIGHTNESS]);
+	config_store_write_byte(EE_SIDE_SW_2_FUNC, sim_saved[EE_SIDE_SW_2_FUNC]);
+
+	for (uint8_t page = ENC_SETTINGS_START_PAGE; page < ENC_SETTINGS_START_PAGE + 6; ++page) {
+		config_store_write_page(page, &sim_saved[page * EEPROM_PAGE_SIZE]);
+	}
+	config_store_write_page(GESTURE_SETTINGS_START_PAGE + 2, &sim_saved[(GESTURE_SETTINGS_START_PAGE + 2) * EEPROM_PAGE_SIZE]);
+
+	// The same again, a second save before the first has been written
+	for (uint16_t i = 0; i < 300; ++i) {
+		config_store_task();
+		eeprom_queue_task();
+		nvm_wait_until_ready();
+		if (i == 3) {
+			config_store_write_page(ENC_SETTINGS_START_PAGE + 20, &sim_saved[(ENC_SETTINGS_START_PAGE + 20) * EEPROM_PAGE_SIZE]);
+			config_store_write_byte(EE_SUPER_KNOB_END, sim_saved[EE_SUPER_KNOB_END]);
+		}
+	}
+}
+
+// Power lost part way through saving settings
+static bool sim_scenario_save_cut(sim_boot_t *boot)
+{
+	uint8_t before[SIM_EEPROM_SIZE];
+	sim_current_image(boot);
+	memcpy(before, boot->image, SIM_EEPROM_SIZE);
+
+	// The settings to save, each a change from those in the EEPROM
+	memcpy(sim_saved, before, SIM_EEPROM_SIZE);
+	sim_saved[EE_RGB_BRIGHTNESS] ^= 0x01;
+	sim_saved[EE_SIDE_SW_2_FUNC] ^= 0x02;
+	sim_saved[EE_SUPER_KNOB_END] ^= 0x04;
+	for (uint16_t address = ENC_SETTINGS_START_PAGE * EEPROM_PAGE_SIZE; address < SIM_CONFIG_END; ++address) {
+		sim_saved[address] = 1 + (rand() % 0x7F);
+	}
+
+	boot->record = true;
+	sim_power_up(boot, sim_save_session);
+	boot->record = false;
+
+	bool passed = boot->result == CONFIG_STORE_VALID;
+	// The guard log differs between old and new, the rest must match the save
+	uint8_t expected[SIM_EEPROM_SIZE];
+	memcpy(expected, before, SIM_EEPROM_SIZE);
+	expected[EE_RGB_BRIGHTNESS] = sim_saved[EE_RGB_BRIGHTNESS];
+	expected[EE_SIDE_SW_2_FUNC] = sim_saved[EE_SIDE_SW_2_FUNC];
+	expected[EE_SUPER_KNOB_END] = sim_saved[EE_SUPER_KNOB_END];
+	memcpy(&expected[SIM_GUARD_START], &boot->image[SIM_GUARD_START], SIM_EEPROM_SIZE - SIM_GUARD_START);
+	uint8_t pages[] = {1, 2, 3, 4, 5, 6, 21, GESTURE_SETTINGS_START_PAGE + 2};
+	for (uint8_t i = 0; i < sizeof(pages); ++i) {
+		memcpy(&expected[pages[i] * EEPROM_PAGE_SIZE], &sim_saved[pages[i] * EEPROM_PAGE_SIZE], EEPROM_PAGE_SIZE);
+	}
+	if (memcmp(expected, boot->image, SIM_EEPROM_SIZE)) {
+		printf("    the saved settings were not all written\n");
+		passed = false;
+	}
+
+	// Last, settling reuses the boot and its snapshots
+	passed = sim_check_cuts(boot, before, expected) && passed;
+	return sim_check_settled(boot) && passed;
+}
+
+// One encoder setting changed per edit, across a few encoder pages
+static void sim_encoder_edits_session(void)
+{
+	uint8_t page_buffer[EEPROM_PAGE_SIZE];
+
+	for (uint16_t edit = 0; edit < SIM_EDITS; ++edit) {
+		uint8_t page = ENC_SETTINGS_START_PAGE + (edit % 4);
+		eeprom_queue_read_buffer(page * EEPROM_PAGE_SIZE, page_buffer, EEPROM_PAGE_SIZE);
+		page_buffer[edit % EEPROM_PAGE_SIZE] ^= 0x01;
+		config_store_write_page(page, page_buffer);
+		for (uint16_t i = 0; i < SIM_LOOP_PASSES; ++i) {
+			nvm_wait_until_ready();
+			config_store_task();
+			eeprom_queue_task();
+		}
+	}
+}
+
+// One global setting changed per edit
+static void sim_global_edits_session(void)
+{
+	for (uint16_t edit = 0; edit < SIM_EDITS; ++edit) {
+		config_store_write_byte(EE_RGB_BRIGHTNESS, eeprom_queue_read_byte(EE_RGB_BRIGHTNESS) ^ 0x01);
+		for (uint16_t i = 0; i < SIM_LOOP_PASSES; ++i) {
+			nvm_wait_until_ready();
+			config_store_task();
+			eeprom_queue_task();
+		}
+	}
+}
+
+// EEPROM writes per saved edit, and how hard the most written byte is worn
+static bool sim_scenario_writes(sim_boot_t *boot)
+{
+	static const struct {
+		const char *name;
+		void (*session)(void);
+	} edits[] = {
+		{"encoder edit",	sim_encoder_edits_session},
+		{"global edit",		sim_global_edits_session},
+	};
+	bool passed = true;
+
+	for (uint8_t i = 0; i < sizeof(edits) / sizeof(edits[0]); ++i) {
+		sim_current_image(boot);
+		sim_power_up(boot, edits[i].session);
+		printf("  %-16s %u page writes per edit, most written byte %u times in %u edits\n", edits[i].name,
+			   boot->page_writes / SIM_EDITS, boot->most_byte_writes, SIM_EDITS);
+		passed &= boot->result == CONFIG_STORE_VALID && !(boot->page_writes % SIM_EDITS);
+		passed &= sim_check_settled(boot);
+	}
+	return passed;
+}
+
+/* Main --------------------------------------------------------------------- */
+
+typedef struct {
+	const char *name;
+	bool (*run)(sim_boot_t *boot);
+} sim_scenario_t;
+
+static const sim_scenario_t sim_scenarios[] = {
+	{"layouts",		sim_scenario_layouts},
+	{"unknown",		sim_scenario_unknown},
+	{"corrupt",		sim_scenario_corrupt},
+	{"migrate_cut",	sim_scenario_migrate_cut},
+	{"save_cut",	sim_scenario_save_cut},
+	{"writes",		sim_scenario_writes},
+};
+
+int main(int argc, char **argv)
+{
+	const char *scenario_name = "all";
+	unsigned seed = 1;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "s:r:")) != -1) {
+		switch (opt) {
+			case 's':
+			scenario_name = optarg;
+			break;
+			case 'r':
+			seed = (unsigned)atoi(optarg);
+			break;
+			default:
+			fprintf(stderr, "usage: %s [-s layouts|unknown|corrupt|migrate_cut|save_cut|writes|all] [-r seed]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	sim_boot_t *boot = sim_new_boot();
+	bool found = false;
+	bool passed = true;
+	for (uint8_t i = 0; i < sizeof(sim_scenarios) / sizeof(sim_scenarios[0]); ++i) {
+		if (!strcmp(scenario_name, "all") || !strcmp(scenario_name, sim_scenarios[i].name)) {
+			srand(seed);
+			printf("%s\n", sim_scenarios[i].name);
+			bool ok = sim_scenarios[i].run(boot);
+			printf("%s %s\n", ok ? "PASS" : "FAIL", sim_scenarios[i].name);
+			passed &= ok;
+			found = true;
+		}
+	}
+	if (!found) {
+		fprintf(stderr, "Unknown scenario %s\n", scenario_name);
+		return 2;
+	}
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+/*
+ * Common.h
+ *
+ * Host stand-in for LUFA, see USB.h.
+ */
+
+
+#ifndef DISPLAY_SIM_LUFA_COMMON_H_
+#define DISPLAY_SIM_LUFA_COMMON_H_
+
+	#include <LUFA/Drivers/USB/USB.h>
+
+#endif /* DISPLAY_SIM_LUFA_COMMON_H_ */
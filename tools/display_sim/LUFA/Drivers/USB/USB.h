@@ -0,0 +1,42 @@
+/*
+ * USB.h
+ *
+ * Host stand-in for LUFA, just the types and attributes the firmware headers
+ * use. No USB traffic is simulated, MIDI output is discarded by display_sim.c.
+ */
+
+
+#ifndef DISPLAY_SIM_LUFA_USB_H_
+#define DISPLAY_SIM_LUFA_USB_H_
+
+	#include <stdint.h>
+	#include <stdbool.h>
+
+	#define ATTR_WARN_UNUSED_RESULT
+	#define ATTR_NON_NULL_PTR_ARG(...)
+	#define ATTR_NO_INIT
+	#define ATTR_INIT_SECTION(section)
+
+	#define ENDPOINT_DIR_IN		0x80
+	#define ENDPOINT_DIR_OUT	0x00
+
+	#define DEVICE_STATE_Configured	4
+
+	typedef uint8_t USB_Descriptor_Configuration_Header_t;
+	typedef uint8_t USB_Descriptor_Interface_t;
+	typedef uint8_t USB_Audio_Descriptor_Interface_AC_t;
+	typedef uint8_t USB_MIDI_Descriptor_AudioInterface_AS_t;
+	typedef uint8_t USB_MIDI_Descriptor_InputJack_t;
+	typedef uint8_t USB_MIDI_Descriptor_OutputJack_t;
+	typedef uint8_t USB_Audio_Descriptor_StreamEndpoint_Std_t;
+	typedef uint8_t USB_MIDI_Descriptor_Jack_Endpoint_t;
+	typedef struct { uint8_t Size; uint8_t Type; } USB_Descriptor_Header_t;
+
+	typedef struct { uint8_t Event, Data1, Data2, Data3; } MIDI_EventPacket_t;
+	typedef struct { uint8_t unused; } USB_ClassInfo_MIDI_Device_t;
+
+	extern volatile uint8_t USB_DeviceState;
+
+	uint8_t MIDI_Device_Flush(USB_ClassInfo_MIDI_Device_t *interface_info);
+
+#endif /* DISPLAY_SIM_LUFA_USB_H_ */
@@ -0,0 +1,13 @@
+/*
+ * Platform.h
+ *
+ * Host stand-in for LUFA, see USB.h.
+ */
+
+
+#ifndef DISPLAY_SIM_LUFA_PLATFORM_H_
+#define DISPLAY_SIM_LUFA_PLATFORM_H_
+
+	#include <LUFA/Drivers/USB/USB.h>
+
+#endif /* DISPLAY_SIM_LUFA_PLATFORM_H_ */
@@ -0,0 +1,180 @@
+/*
+ * asf.h
+ *
+ * Host stand-in for the ASF header, just enough of it for the display driver,
+ * encoders and native mode code to compile on a PC. The timer, DMA, port and
+ * EEPROM functions are implemented in display_sim.c, which models the 74HC595
+ * LED driver chain the display is shifted into.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+
+#ifndef DISPLAY_SIM_ASF_H_
+#define DISPLAY_SIM_ASF_H_
+
+/*	Includes: */
+	#include <stdint.h>
+	#include <stdbool.h>
+	#include <stddef.h>
+	#include <string.h>
+	#include <avr/pgmspace.h>
+	#include <LUFA/Drivers/USB/USB.h>
+
+/*	Macros: */
+	#define PORTA 0
+	#define PORTB 1
+	#define PORTC 2
+	#define PORTD 3
+	#define PORTE 4
+	#define PORTR 5
+	#define IOPORT_CREATE_PIN(port, pin) ((port) * 8 + (pin))
+
+	#define IOPORT_DIR_INPUT	0
+	#define IOPORT_DIR_OUTPUT	1
+	#define IOPORT_MODE_PULLUP	0
+
+	#define TC_CLKSEL_DIV1_gc		1
+	#define TC_CLKSEL_DIV256_gc		6
+	#define TC_CLKSEL_DIV1024_gc	7
+	#define TC_CCAEN				0x10
+
+	#define DMA_CH_BURSTLEN_1BYTE_gc		0
+	#define DMA_CH_SRCRELOAD_NONE_gc		0
+	#define DMA_CH_SRCDIR_INC_gc			1
+	#define DMA_CH_DESTRELOAD_NONE_gc		0
+	#define DMA_CH_DESTDIR_FIXED_gc			0
+	#define DMA_CH_TRIGSRC_USARTD0_DRE_gc	0x6A
+	#define DMA_INT_LVL_MED					2
+	#define DMA_INT_LVL_HI					3
+
+	#define PMIC_LOLVLEN_bm		0x01
+	#define PMIC_MEDLVLEN_bm	0x02
+	#define PMIC_HILVLEN_bm		0x04
+
+	#define NVM_NVMBUSY_bm		0x80
+	#define NVM_EELVL_gm		0x0C
+	#define NVM_EELVL_LO_gc		0x04
+
+	#define EEPROM_PAGE_SIZE	32
+	#define EEPROM_SIZE			2048
+
+	// ATxmega128A4U flash, for the preset slots
+	#define FLASH_PAGE_SIZE				256
+	#define APPTABLE_SECTION_START		0x1E000
+	#define APPTABLE_SECTION_SIZE		0x2000
+
+	#define Assert(expr)	((void)0)
+	#define UNUSED(v)		((void)(v))
+	#define ISR(vect)		void vect(void)
+
+/*	Types: */
+	typedef uint8_t irqflags_t;
+	typedef uint8_t ioport_pin_t;
+	typedef void (*tc_callback_t)(void);
+
+	typedef enum { TC_CCA = 1, TC_CCB } tc_cc_channel_t;
+	typedef enum { TC_INT_LVL_OFF, TC_INT_LVL_LO, TC_INT_LVL_MED, TC_INT_LVL_HI } tc_int_level_t;
+	typedef enum { TC_WG_NORMAL, TC_WG_FRQ, TC_WG_SS } tc_wg_mode_t;
+
+	typedef struct { uint16_t CNT; } TC0_t;
+	typedef TC0_t TC1_t;
+	typedef struct { volatile uint8_t CTRL; } PMIC_t;
+	typedef struct { volatile uint8_t DATA; } USART_t;
+	typedef struct { volatile uint8_t STATUS; volatile uint8_t INTCTRL; } NVM_t;
+	typedef struct {
+		uint32_t	baudrate;
+		uint8_t		spimode;
+		uint8_t		data_order;
+	} usart_spi_options_t;
+
+	enum dma_channel_status {
+		DMA_CH_FREE,
+		DMA_CH_BUSY,
+		DMA_CH_PENDING,
+		DMA_CH_TRANSFER_COMPLETED,
+		DMA_CH_TRANSFER_ERROR,
+	};
+	typedef void (*dma_callback_t)(enum dma_channel_status status);
+	struct dma_channel_config {
+		uint16_t	srcaddr;
+	};
+
+/* Variables */
+	extern TC0_t TCC0, TCD0;
+	extern TC1_t TCC1, TCD1;
+	extern PMIC_t PMIC;
+	extern USART_t USARTD0;
+	extern NVM_t NVM;
+
+/* Function Prototypes: */
+	void ioport_init(void);
+	void ioport_set_pin_dir(ioport_pin_t pin, uint8_t dir);
+	void ioport_set_pin_mode(ioport_pin_t pin, uint8_t mode);
+	void ioport_set_pin_level(ioport_pin_t pin, bool level);
+	bool ioport_get_pin_level(ioport_pin_t pin);
+
+	void cpu_irq_enable(void);
+	void cpu_irq_disable(void);
+	irqflags_t cpu_irq_save(void);
+	void cpu_irq_restore(irqflags_t flags);
+
+	void tc_enable(TC0_t *tc);
+	void tc_set_cca_interrupt_callback(TC0_t *tc, tc_callback_t callback);
+	void tc_set_ccb_interrupt_callback(TC0_t *tc, tc_callback_t callback);
+	void tc_set_wgm(TC0_t *tc, tc_wg_mode_t mode);
+	void tc_write_period(TC0_t *tc, uint16_t period);
+	void tc_write_cc(TC0_t *tc, tc_cc_channel_t channel, uint16_t value);
+	void tc_write_cc_buffer(TC0_t *tc, tc_cc_channel_t channel, uint16_t value);
+	void tc_enable_cc_channels(TC0_t *tc, uint8_t channels);
+	void tc_disable_cc_channels(TC0_t *tc, uint8_t channels);
+	void tc_set_cca_interrupt_level(TC0_t *tc, tc_int_level_t level);
+	void tc_set_ccb_interrupt_level(TC0_t *tc, tc_int_level_t level);
+	void tc_write_clock_source(TC0_t *tc, uint8_t source);
+	uint16_t tc_read_count(TC0_t *tc);
+
+	void dma_enable(void);
+	void dma_set_callback(uint8_t channel, dma_callback_t callback);
+	void dma_set_double_buffer_mode(uint8_t mode);
+	void dma_channel_enable(uint8_t channel);
+	void dma_channel_write_config(uint8_t channel, struct dma_channel_config *config);
+	void dma_channel_write_source(uint8_t channel, uint16_t source);
+	void dma_channel_set_burst_length(struct dma_channel_config *config, uint8_t length);
+	void dma_channel_set_transfer_count(struct dma_channel_config *config, uint16_t count);
+	void dma_channel_set_single_shot(struct dma_channel_config *config);
+	void dma_channel_set_src_dir_mode(struct dma_channel_config *config, uint8_t mode);
+	void dma_channel_set_src_reload_mode(struct dma_channel_config *config, uint8_t mode);
+	void dma_channel_set_dest_dir_mode(struct dma_channel_config *config, uint8_t mode);
+	void dma_channel_set_dest_reload_mode(struct dma_channel_config *config, uint8_t mode);
+	void dma_channel_set_source_address(struct dma_channel_config *config, uint16_t address);
+	void dma_channel_set_destination_address(struct dma_channel_config *config, uint16_t address);
+	void dma_channel_set_trigger_source(struct dma_channel_config *config, uint8_t source);
+	void dma_channel_set_interrupt_level(struct dma_channel_config *config, uint8_t level);
+
+	void usart_init_spi(USART_t *usart, const usart_spi_options_t *options);
+
+	uint8_t eeprom_read_byte(const uint8_t *address);
+	uint8_t nvm_eeprom_read_byte(uint16_t address);
+	void nvm_eeprom_write_byte(uint16_t address, uint8_t value);
+	void nvm_eeprom_read_buffer(uint16_t address, void *buffer, uint16_t length);
+	void nvm_eeprom_load_byte_to_buffer(uint8_t byte_addr, uint8_t value);
+	void nvm_eeprom_atomic_write_page(uint8_t page);
+	void nvm_wait_until_ready(void);
+
+	void wdt_reset(void);
+	void Delay_MS(uint16_t ms);
+
+#endif /* DISPLAY_SIM_ASF_H_ */
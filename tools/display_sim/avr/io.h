@@ -0,0 +1,14 @@
+/*
+ * io.h
+ *
+ * Host stand-in for avr-libc's register definitions, the registers the
+ * firmware touches are declared in the simulator's asf.h.
+ */
+
+
+#ifndef DISPLAY_SIM_IO_H_
+#define DISPLAY_SIM_IO_H_
+
+	#include <stdint.h>
+
+#endif /* DISPLAY_SIM_IO_H_ */
@@ -0,0 +1,19 @@
+/*
+ * pgmspace.h
+ *
+ * Host stand-in for avr-libc's program memory access, flash is just memory on a PC.
+ */
+
+
+#ifndef DISPLAY_SIM_PGMSPACE_H_
+#define DISPLAY_SIM_PGMSPACE_H_
+
+	#include <stdint.h>
+
+	#define PROGMEM
+	#define PSTR(s)					(s)
+	#define pgm_read_byte(addr)		(*(const uint8_t *)(addr))
+	#define pgm_read_word(addr)		(*(const uint16_t *)(addr))
+	#define pgm_read_dword(addr)	(*(const uint32_t *)(addr))
+
+#endif /* DISPLAY_SIM_PGMSPACE_H_ */
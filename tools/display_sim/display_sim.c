@@ -0,0 +1,1098 @@
+/*
+ * display_sim.c
+ *
+ * Host side display emulator. Runs the unmodified display driver, encoder
+ * display code and color tables against a model of the frame timer, the DMA
+ * channel and the 74HC595 LED driver chain, and measures how long each LED is
+ * lit over a whole BCM refresh cycle. Each captured frame is printed as text,
+ * one line per encoder, and can be written out as a PPM image, so pattern types,
+ * animations and bank changes can be regression tested by diffing the output
+ * of two builds, and the main loop cost of drawing them timed. Every call the
+ * encoder code makes to draw an indicator or an RGB segment is counted.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -O2 -fcommon -Itools/display_sim -Isrc -o display_sim tools/display_sim/display_sim.c src/encoders.c src/native_mode.c src/colorMap.c src/indicator_pattern.c src/indicator_tables.c src/color_tables.c src/oscillator.c src/animation_clock.c src/eeprom.c src/config_store.c -lm
+ *   ./display_sim [-s types|animation|bank|overlay|native|all] [-o prefix] [-l loop_us] [-u usb_us] [-d]
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+// The frame buffer and the frame and DMA interrupts are static, compile the
+// driver straight into the emulator so they can be reached. The drawing
+// functions the encoder code calls are renamed, and wrapped further down so
+// the calls can be counted.
+#define set_encoder_indicator		sim_driver_set_encoder_indicator
+#define set_encoder_indicator_level	sim_driver_set_encoder_indicator_level
+#define set_encoder_rgb				sim_driver_set_encoder_rgb
+#define set_encoder_rgb_level		sim_driver_set_encoder_rgb_level
+#define build_rgb					sim_driver_build_rgb
+#include "../../src/display_driver.c"
+#undef set_encoder_indicator
+#undef set_encoder_indicator_level
+#undef set_encoder_rgb
+#undef set_encoder_rgb_level
+#undef build_rgb
+#include <gesture.h>
+#include <native_mode.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/*	Macros: */
+	#define SIM_COUNT_US		8		// TCC0 runs at 32 MHz / 256
+	#define SIM_DMA_COUNTS		8		// 32 bytes at 4 MBps = 64 uS
+	#define SIM_LOOP_US			250		// Default main loop pass time
+	#define SIM_SETTLE_MS		100		// Time given to redraw after a change
+	#define SIM_INDICATORS		11
+	#define SIM_CELL			64		// PPM pixels per encoder
+	#define SIM_EEPROM_SIZE		4096
+	#define SIM_FEEDBACK_HZ		1000	// Native mode host feedback rate
+
+	// LED driver outputs of one encoder, the bits of its two bytes in the
+	// frame buffer, active low
+	#define SIM_GREEN_bm		0x10
+	#define SIM_RED_bm			0x08
+	#define SIM_BLUE_bm			0x04
+	#define SIM_DETENT_RED_bm	0x02
+	#define SIM_DETENT_BLUE_bm	0x01
+
+/*	Types: */
+	// Light output of one encoder, 0 - DISPLAY_BCM_LEVEL_MAX per LED
+	typedef struct {
+		uint8_t indicator[SIM_INDICATORS];	// LED 1 (7 o'clock) to 11 (5 o'clock)
+		uint8_t red, green, blue;
+		uint8_t detent_red, detent_blue;
+	} sim_leds_t;
+
+	typedef struct {
+		sim_leds_t	encoder[PHYSICAL_ENCODERS];
+		uint32_t	time_us;
+	} sim_frame_t;
+
+	typedef struct {
+		const char	*name;
+		void		(*run)(void);
+	} sim_scenario_t;
+
+/* Variables */
+	TC0_t TCC0, TCD0;
+	TC1_t TCC1, TCD1;
+	PMIC_t PMIC;
+	USART_t USARTD0;
+	NVM_t NVM;
+	volatile uint8_t USB_DeviceState = DEVICE_STATE_Configured;
+	USB_ClassInfo_MIDI_Device_t* g_midi_interface_info;
+	bool midi_clock_enabled;
+	bool g_bank_select_active;
+
+	// Timer C0, compare A drives the frame interrupt and B the animation timer
+	static uint32_t sim_count;
+	static bool sim_tcc0_running;
+	static uint16_t sim_cca, sim_ccb;
+	static tc_callback_t sim_cca_callback, sim_ccb_callback;
+	static tc_int_level_t sim_cca_level, sim_ccb_level;
+	static bool sim_ccb_pending;
+
+	// /OE, either the display enable pin or timer D0's compare A output
+	static bool sim_oe_pwm_enabled;
+	static uint16_t sim_oe_compare = 0xFFFF;
+	static bool sim_display_en = true;
+
+	// The DMA channel and the shift register chain it feeds
+	static uint16_t sim_dma_source;
+	static dma_callback_t sim_dma_callback;
+	static bool sim_dma_busy;
+	static uint32_t sim_dma_done_at;
+	static uint8_t sim_dma_level;
+	static bool sim_dma_pending;		// Transfer complete, waiting for its interrupt level
+	static uint8_t sim_shift[DMA_FRAME_SIZE];
+	static uint8_t sim_latched[DMA_FRAME_SIZE];
+	static bool sim_latch_pin;
+	static bool sim_cycle_started;
+
+	// On-time of every driver output since the last capture, in counts x /OE duty
+	static uint32_t sim_lit[DMA_FRAME_SIZE * 8];
+	static uint32_t sim_lit_from;
+	static uint32_t sim_lit_to;
+
+	static uint8_t sim_eeprom[SIM_EEPROM_SIZE];
+	static uint8_t sim_eeprom_page[EEPROM_PAGE_SIZE];
+	static bool sim_eeprom_loaded[EEPROM_PAGE_SIZE];
+
+	// Statistics for the running scenario
+	static uint32_t sim_frame_isrs, sim_dma_isrs, sim_dma_retries;
+	static uint32_t sim_passes;
+	static uint32_t sim_indicator_draws, sim_rgb_draws;
+	static double sim_pass_ns_total, sim_pass_ns_max;
+
+	// Options
+	static uint32_t sim_loop_counts = SIM_LOOP_US / SIM_COUNT_US;
+	static uint32_t sim_usb_counts;		// Main loop pass time with LO and MED interrupts off
+	static const char *sim_ppm_prefix;
+	static bool sim_diff_only;
+	static const char *sim_scenario_name;
+	static uint16_t sim_frame_number;
+	static sim_frame_t sim_prev_frame;
+
+/* ASF, LUFA and avr-libc stand-ins ----------------------------------------- */
+
+void cpu_irq_enable(void) {}
+void cpu_irq_disable(void) {}
+irqflags_t cpu_irq_save(void) { return 0; }
+void cpu_irq_restore(irqflags_t flags) { (void)flags; }
+void wdt_reset(void) {}
+void Delay_MS(uint16_t ms) { (void)ms; }
+void _delay_ms(double ms) { (void)ms; }
+void _delay_us(double us) { (void)us; }
+uint8_t MIDI_Device_Flush(USB_ClassInfo_MIDI_Device_t *interface_info) { (void)interface_info; return 0; }
+void usart_init_spi(USART_t *usart, const usart_spi_options_t *options) { (void)usart; (void)options; }
+
+void ioport_init(void) {}
+void ioport_set_pin_dir(ioport_pin_t pin, uint8_t dir) { (void)pin; (void)dir; }
+void ioport_set_pin_mode(ioport_pin_t pin, uint8_t mode) { (void)pin; (void)mode; }
+bool ioport_get_pin_level(ioport_pin_t pin) { (void)pin; return true; }
+
+void ioport_set_pin_level(ioport_pin_t pin, bool level)
+{
+	if (pin == DISPLAY_EN) {
+		sim_display_en = level;
+	} else if (pin == DISPLAY_LATCH) {
+		// The 74HC595 storage registers load on the rising edge
+		if (level && !sim_latch_pin) {
+			memcpy(sim_latched, sim_shift, sizeof(sim_latched));
+			if (display_frame_index == 0) {
+				sim_cycle_started = true;
+			}
+		}
+		sim_latch_pin = level;
+	}
+}
+
+void tc_enable(TC0_t *tc) { (void)tc; }
+void tc_set_wgm(TC0_t *tc, tc_wg_mode_t mode) { (void)tc; (void)mode; }
+void tc_write_period(TC0_t *tc, uint16_t period) { (void)tc; (void)period; }
+void tc_set_cca_interrupt_level(TC0_t *tc, tc_int_level_t level)
+{
+	if (tc == &TCC0) {
+		sim_cca_level = level;
+	}
+}
+
+void tc_set_ccb_interrupt_level(TC0_t *tc, tc_int_level_t level)
+{
+	if (tc == &TCC0) {
+		sim_ccb_level = level;
+	}
+}
+
+void tc_set_cca_interrupt_callback(TC0_t *tc, tc_callback_t callback)
+{
+	if (tc == &TCC0) {
+		sim_cca_callback = callback;
+	}
+}
+
+void tc_set_ccb_interrupt_callback(TC0_t *tc, tc_callback_t callback)
+{
+	if (tc == &TCC0) {
+		sim_ccb_callback = callback;
+	}
+}
+
+void tc_write_cc(TC0_t *tc, tc_cc_channel_t channel, uint16_t value)
+{
+	if (tc == &TCC0) {
+		if (channel == TC_CCA) {
+			sim_cca = value;
+		} else {
+			sim_ccb = value;
+		}
+	}
+}
+
+void tc_write_cc_buffer(TC0_t *tc, tc_cc_channel_t channel, uint16_t value)
+{
+	// The buffer is copied at the end of the 8 uS PWM period, near enough now
+	if (tc == &TCD0 && channel == TC_CCA) {
+		sim_oe_compare = value;
+	}
+}
+
+void tc_enable_cc_channels(TC0_t *tc, uint8_t channels)
+{
+	if (tc == &TCD0 && (channels & TC_CCAEN)) {
+		sim_oe_pwm_enabled = true;
+	}
+}
+
+void tc_disable_cc_channels(TC0_t *tc, uint8_t channels)
+{
+	if (tc == &TCD0 && (channels & TC_CCAEN)) {
+		sim_oe_pwm_enabled = false;
+	}
+}
+
+void tc_write_clock_source(TC0_t *tc, uint8_t source)
+{
+	if (tc == &TCC0) {
+		sim_tcc0_running = (source != 0);
+	}
+}
+
+uint16_t tc_read_count(TC0_t *tc)
+{
+	return (tc == &TCC0) ? (uint16_t)sim_count : 0;
+}
+
+void dma_enable(void) {}
+void dma_set_double_buffer_mode(uint8_t mode) { (void)mode; }
+void dma_channel_set_burst_length(struct dma_channel_config *config, uint8_t length) { (void)config; (void)length; }
+void dma_channel_set_transfer_count(struct dma_channel_config *config, uint16_t count) { (void)config; (void)count; }
+void dma_channel_set_single_shot(struct dma_channel_config *config) { (void)config; }
+void dma_channel_set_src_dir_mode(struct dma_channel_config *config, uint8_t mode) { (void)config; (void)mode; }
+void dma_channel_set_src_reload_mode(struct dma_channel_config *config, uint8_t mode) { (void)config; (void)mode; }
+void dma_channel_set_dest_dir_mode(struct dma_channel_config *config, uint8_t mode) { (void)config; (void)mode; }
+void dma_channel_set_dest_reload_mode(struct dma_channel_config *config, uint8_t mode) { (void)config; (void)mode; }
+void dma_channel_set_destination_address(struct dma_channel_config *config, uint16_t address) { (void)config; (void)address; }
+void dma_channel_set_trigger_source(struct dma_channel_config *config, uint8_t source) { (void)config; (void)source; }
+void dma_channel_set_interrupt_level(struct dma_channel_config *config, uint8_t level)
+{
+	(void)config;
+	sim_dma_level = level;
+}
+
+void dma_channel_set_source_address(struct dma_channel_config *config, uint16_t address)
+{
+	config->srcaddr = address;
+}
+
+void dma_channel_write_config(uint8_t channel, struct dma_channel_config *config)
+{
+	(void)channel;
+	sim_dma_source = config->srcaddr;
+}
+
+void dma_channel_write_source(uint8_t channel, uint16_t source)
+{
+	(void)channel;
+	sim_dma_source = source;
+}
+
+void dma_set_callback(uint8_t channel, dma_callback_t callback)
+{
+	(void)channel;
+	sim_dma_callback = callback;
+}
+
+void dma_channel_enable(uint8_t channel)
+{
+	(void)channel;
+	if (sim_dma_busy) {
+		fprintf(stderr, "DMA restarted while busy at %u uS\n", sim_count * SIM_COUNT_US);
+		exit(1);
+	}
+	sim_dma_busy = true;
+	sim_dma_done_at = sim_count + SIM_DMA_COUNTS;
+}
+
+uint8_t nvm_eeprom_read_byte(uint16_t address)
+{
+	return sim_eeprom[address % SIM_EEPROM_SIZE];
+}
+
+void nvm_eeprom_write_byte(uint16_t address, uint8_t value)
+{
+	sim_eeprom[address % SIM_EEPROM_SIZE] = value;
+}
+
+uint8_t eeprom_read_byte(const uint8_t *address)
+{
+	return nvm_eeprom_read_byte((uint16_t)(uintptr_t)address);
+}
+
+void nvm_eeprom_read_buffer(uint16_t address, void *buffer, uint16_t length)
+{
+	for (uint16_t i = 0; i < length; ++i) {
+		((uint8_t *)buffer)[i] = nvm_eeprom_read_byte(address + i);
+	}
+}
+
+void nvm_eeprom_load_byte_to_buffer(uint8_t byte_addr, uint8_t value)
+{
+	sim_eeprom_page[byte_addr % EEPROM_PAGE_SIZE] = value;
+	sim_eeprom_loaded[byte_addr % EEPROM_PAGE_SIZE] = true;
+}
+
+// Only the loaded page buffer locations are written, as on the XMEGA
+void nvm_eeprom_atomic_write_page(uint8_t page)
+{
+	for (uint8_t i = 0; i < EEPROM_PAGE_SIZE; ++i) {
+		if (sim_eeprom_loaded[i]) {
+			nvm_eeprom_write_byte(page * EEPROM_PAGE_SIZE + i, sim_eeprom_page[i]);
+			sim_eeprom_loaded[i] = false;
+		}
+	}
+}
+
+// Page writes finish straight away, raise the EEPROM-ready interrupt if the
+// firmware is waiting for it
+void NVM_EE_vect(void);
+
+void nvm_wait_until_ready(void)
+{
+	if (NVM.INTCTRL & NVM_EELVL_gm) {
+		NVM_EE_vect();
+	}
+}
+
+/* The rest of the firmware ------------------------------------------------- */
+
+// Nothing is connected to the inputs, and MIDI output goes nowhere
+int8_t get_encoder_value(uint8_t encoder) { (void)encoder; return 0; }
+uint16_t get_encoder_cycle_count(uint8_t encoder) { (void)encoder; return 0; }
+bool encoder_is_active(uint8_t enc_idx) { (void)enc_idx; return false; }
+uint16_t update_encoder_switch_state(void) { return 0; }
+uint16_t get_enc_switch_state(void) { return 0; }
+uint16_t get_enc_switch_down(void) { return 0; }
+uint16_t get_enc_switch_up(void) { return 0; }
+uint32_t get_ms_timer(void) { return sim_count / 125; }	// TCC0 counts are 8 uS
+bool get_bank_select_active(void) { return g_bank_select_active; }
+void draw_bank_select_overlay(void) {}
+void gesture_init(void) {}
+void gesture_encoder_turned(uint8_t sw) { (void)sw; }
+uint8_t gesture_time_or_default(uint8_t time, uint8_t default_time) { return time ? time : default_time; }
+bool preset_in_use(void) { return false; }
+
+gesture_t gesture_process(uint8_t sw, switch_event_t event, uint8_t long_press_time, uint8_t double_tap_time,
+						  gesture_t wanted)
+{
+	(void)sw; (void)event; (void)long_press_time; (void)double_tap_time; (void)wanted;
+	return GESTURE_NONE;
+}
+
+void midi_stream_raw_note(const uint8_t channel, const uint8_t pitch, const bool onoff, const uint8_t velocity)
+{
+	(void)channel; (void)pitch; (void)onoff; (void)velocity;
+}
+
+void midi_stream_raw_cc(const uint8_t channel, const uint8_t cc, const uint8_t value)
+{
+	(void)channel; (void)cc; (void)value;
+}
+
+void midi_stream_raw_pitchbend(const uint8_t channel, const uint16_t value)
+{
+	(void)channel; (void)value;
+}
+
+/* Display driver, counted ------------------------------------------------- */
+
+void set_encoder_indicator(uint8_t encoder, uint8_t position, bool has_detent, uint16_t type,
+						   uint8_t detent_color)
+{
+	sim_indicator_draws++;
+	sim_driver_set_encoder_indicator(encoder, position, has_detent, type, detent_color);
+}
+
+void set_encoder_indicator_level(uint8_t encoder, uint8_t position, bool has_detent, uint16_t type,
+								 uint8_t detent_color, uint8_t brightness)
+{
+	sim_indicator_draws++;
+	sim_driver_set_encoder_indicator_level(encoder, position, has_detent, type, detent_color, brightness);
+}
+
+void set_encoder_rgb(uint8_t encoder, uint8_t color)
+{
+	sim_rgb_draws++;
+	sim_driver_set_encoder_rgb(encoder, color);
+}
+
+void set_encoder_rgb_level(uint8_t encoder, uint8_t color, uint8_t brightness)
+{
+	sim_rgb_draws++;
+	sim_driver_set_encoder_rgb_level(encoder, color, brightness);
+}
+
+void build_rgb(uint8_t encoder, uint32_t color, uint8_t level)
+{
+	sim_rgb_draws++;
+	sim_driver_build_rgb(encoder, color, level);
+}
+
+/* Hardware model ------------------------------------------------------------ */
+
+/**
+ * Returns the frame buffer plane a DMA source address points at. The driver
+ * only hands the DMA the low 16 bits of the address, which is all it has on
+ * the XMEGA, so match it against every plane.
+ */
+static const uint8_t *sim_dma_plane(uint16_t source)
+{
+	for (uint8_t buffer = 0; buffer < DISPLAY_FRAME_BUFFERS; ++buffer) {
+		for (uint8_t plane = 0; plane < DISPLAY_BIT_PLANES; ++plane) {
+			const uint8_t *ptr = display_frame_buffer[buffer][plane];
+			if ((uint16_t)(uintptr_t)ptr == source) {
+				return ptr;
+			}
+		}
+	}
+	fprintf(stderr, "DMA source 0x%04x is not a bit-plane\n", source);
+	exit(1);
+}
+
+/**
+ * Returns the /OE duty, 0 (LEDs off) to 255 (on for the whole PWM period).
+ */
+static uint16_t sim_oe_duty(void)
+{
+	#if DISPLAY_OE_PWM > 0
+	if (!sim_oe_pwm_enabled || sim_oe_compare >= DISPLAY_OE_LEVEL_MAX) {
+		return 0;
+	}
+	return DISPLAY_OE_LEVEL_MAX - sim_oe_compare;
+	#else
+	return sim_display_en ? 0 : 255;
+	#endif
+}
+
+/**
+ * Adds the time since the last event to every lit output, then moves on to
+ * the given count.
+ */
+static void sim_advance_to(uint32_t count)
+{
+	uint32_t weight = (count - sim_count) * sim_oe_duty();
+	if (weight) {
+		for (uint8_t i = 0; i < DMA_FRAME_SIZE; ++i) {
+			uint8_t lit = (uint8_t)~sim_latched[i];
+			for (uint8_t bit = 0; lit; ++bit, lit >>= 1) {
+				if (lit & 0x01) {
+					sim_lit[i * 8 + bit] += weight;
+				}
+			}
+		}
+	}
+	sim_count = count;
+}
+
+/**
+ * Returns the counts until a timer C0 compare value next matches.
+ */
+static uint32_t sim_counts_to_match(uint16_t compare)
+{
+	uint16_t delta = compare - (uint16_t)sim_count;
+	return delta ? delta : 0x10000;
+}
+
+/**
+ * Returns true if PMIC.CTRL has interrupts of a level enabled.
+ */
+static bool sim_level_enabled(uint8_t level)
+{
+	return level && (PMIC.CTRL & (0x01 << (level - 1)));
+}
+
+/**
+ * Runs the interrupts due in the next counts timer counts, in order. The main
+ * loop is not interrupted part way through, interrupts only run between passes.
+ * An interrupt whose level is off in PMIC.CTRL waits until it is turned back on.
+ *
+ * \param stop_at_cycle [in]	Return early when the first plane of a BCM cycle is latched
+ *
+ * \return True if it returned early
+ */
+static bool sim_run_counts(uint32_t counts, bool stop_at_cycle)
+{
+	uint32_t end = sim_count + counts;
+	sim_cycle_started = false;
+
+	while (sim_tcc0_running) {
+		uint32_t frame_at = sim_count + sim_counts_to_match(sim_cca);
+		uint32_t animation_at = sim_count + sim_counts_to_match(sim_ccb);
+		uint32_t next = (frame_at < animation_at) ? frame_at : animation_at;
+		if (sim_dma_busy && sim_dma_done_at < next) {
+			next = sim_dma_done_at;
+		}
+		if (next > end) {
+			break;
+		}
+		sim_advance_to(next);
+
+		// Highest interrupt level first: frame, DMA, then animation
+		if (next == frame_at && sim_level_enabled(sim_cca_level)) {
+			bool loaded = display_plane_loaded;
+			sim_frame_isrs++;
+			sim_cca_callback();
+			if (!loaded) {
+				sim_dma_retries++;
+			}
+		}
+		if (sim_dma_busy && next == sim_dma_done_at) {
+			memcpy(sim_shift, sim_dma_plane(sim_dma_source), DMA_FRAME_SIZE);
+			sim_dma_busy = false;
+			sim_dma_pending = true;
+		}
+		if (sim_dma_pending && sim_level_enabled(sim_dma_level)) {
+			sim_dma_pending = false;
+			sim_dma_isrs++;
+			sim_dma_callback(DMA_CH_TRANSFER_COMPLETED);
+		}
+		if (next == animation_at) {
+			sim_ccb_pending = true;
+		}
+		if (sim_ccb_pending && sim_level_enabled(sim_ccb_level)) {
+			sim_ccb_pending = false;
+			sim_ccb_callback();
+		}
+
+		if (stop_at_cycle && sim_cycle_started) {
+			return true;
+		}
+	}
+	sim_advance_to(end);
+	return false;
+}
+
+/* Firmware driving ---------------------------------------------------------- */
+
+/**
+ * One pass of the main loop's display work, timed.
+ */
+static void sim_main_pass(void)
+{
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	nvm_wait_until_ready();
+	animation_phase_update();
+	if (display_overlay_tick()) {
+		// An overlay animation has the display
+	} else if (sleep_mode_active) {
+		sleep_frame();
+	} else if (!get_bank_select_active()) {
+		update_encoder_display();
+	}
+	encoder_config_task();
+	config_store_task();
+	eeprom_queue_task();
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+	sim_pass_ns_total += ns;
+	if (ns > sim_pass_ns_max) {
+		sim_pass_ns_max = ns;
+	}
+	sim_passes++;
+}
+
+/**
+ * Runs the interrupts for the rest of a main loop pass. The first
+ * sim_usb_counts of it are spent reading USB MIDI, which main.c does with the
+ * low and medium level interrupts off.
+ *
+ * \param stop_at_cycle [in]	Return early when the first plane of a BCM cycle is latched
+ *
+ * \return True if it returned early
+ */
+static bool sim_run_pass_counts(uint32_t counts, bool stop_at_cycle)
+{
+	uint32_t usb_counts = (counts < sim_usb_counts) ? counts : sim_usb_counts;
+	if (usb_counts) {
+		PMIC.CTRL &= ~(PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm);
+		bool stopped = sim_run_counts(usb_counts, stop_at_cycle);
+		PMIC.CTRL = PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
+		if (stopped) {
+			return true;
+		}
+	}
+	return sim_run_counts(counts - usb_counts, stop_at_cycle);
+}
+
+/**
+ * Runs the main loop for a time.
+ */
+static void sim_run_ms(uint32_t ms)
+{
+	uint32_t end = sim_count + ms * 1000 / SIM_COUNT_US;
+	while ((int32_t)(end - sim_count) > 0) {
+		sim_main_pass();
+		uint32_t counts = end - sim_count;
+		sim_run_pass_counts((counts < sim_loop_counts) ? counts : sim_loop_counts, false);
+	}
+}
+
+/**
+ * Runs the main loop until the first plane of a BCM cycle is latched.
+ */
+static void sim_run_to_cycle_start(void)
+{
+	do {
+		sim_main_pass();
+	} while (!sim_run_pass_counts(sim_loop_counts, true));
+}
+
+/**
+ * Starts measuring the LEDs' on-time from now.
+ */
+static void sim_lit_reset(void)
+{
+	memset(sim_lit, 0, sizeof(sim_lit));
+	sim_lit_from = sim_count;
+}
+
+/**
+ * Returns the light output of a driver output as a level, the on-time over
+ * the capture as a fraction of DISPLAY_BCM_LEVEL_MAX.
+ */
+static uint8_t sim_level(uint8_t byte, uint8_t bit_mask)
+{
+	uint8_t bit = 0;
+	while (!(bit_mask & (0x01 << bit))) {
+		bit++;
+	}
+	double full = (double)(sim_lit_to - sim_lit_from) * DISPLAY_OE_LEVEL_MAX;
+	return (uint8_t)lround(sim_lit[byte * 8 + bit] * DISPLAY_BCM_LEVEL_MAX / full);
+}
+
+/**
+ * Captures what the LEDs show over one whole BCM cycle, while the main loop
+ * keeps running. Lining up with the cycle means this takes 9 - 18 mS.
+ */
+static void sim_capture(sim_frame_t *frame)
+{
+	sim_run_to_cycle_start();
+	sim_lit_reset();
+	sim_run_to_cycle_start();
+	sim_lit_to = sim_count;
+
+	frame->time_us = sim_lit_from * SIM_COUNT_US;
+	for (uint8_t e = 0; e < PHYSICAL_ENCODERS; ++e) {
+		sim_leds_t *leds = &frame->encoder[e];
+		uint8_t offset = (15 - e) * 2;
+
+		// LEDs 1-8 are the second byte, MSB first, and 9-11 the top of the first
+		for (uint8_t led = 0; led < 8; ++led) {
+			leds->indicator[led] = sim_level(offset + 1, 0x80 >> led);
+		}
+		for (uint8_t led = 8; led < SIM_INDICATORS; ++led) {
+			leds->indicator[led] = sim_level(offset, 0x80 >> (led - 8));
+		}
+		leds->red = sim_level(offset, SIM_RED_bm);
+		leds->green = sim_level(offset, SIM_GREEN_bm);
+		leds->blue = sim_level(offset, SIM_BLUE_bm);
+		leds->detent_red = sim_level(offset, SIM_DETENT_RED_bm);
+		leds->detent_blue = sim_level(offset, SIM_DETENT_BLUE_bm);
+	}
+}
+
+/* Output -------------------------------------------------------------------- */
+
+static void sim_put_pixel(uint8_t *image, int width, int x, int y, uint8_t r, uint8_t g, uint8_t b)
+{
+	uint8_t *pixel = &image[(y * width + x) * 3];
+	pixel[0] = r;
+	pixel[1] = g;
+	pixel[2] = b;
+}
+
+static void sim_fill(uint8_t *image, int width, int cx, int cy, int radius, uint8_t r, uint8_t g, uint8_t b)
+{
+	for (int y = cy - radius; y <= cy + radius; ++y) {
+		for (int x = cx - radius; x <= cx + radius; ++x) {
+			if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= radius * radius) {
+				sim_put_pixel(image, width, x, y, r, g, b);
+			}
+		}
+	}
+}
+
+static uint8_t sim_pixel_level(uint8_t level)
+{
+	return (uint8_t)((level * 255 + DISPLAY_BCM_LEVEL_MAX / 2) / DISPLAY_BCM_LEVEL_MAX);
+}
+
+/**
+ * Draws a frame as the 4 x 4 grid of encoders: the indicator ring, the RGB
+ * segment in the middle and the detent LED at the top.
+ */
+static void sim_write_ppm(const sim_frame_t *frame, const char *path)
+{
+	const int width = SIM_CELL * 4;
+	uint8_t *image = calloc(width * width, 3);
+	if (!image) {
+		return;
+	}
+
+	for (uint8_t e = 0; e < PHYSICAL_ENCODERS; ++e) {
+		const sim_leds_t *leds = &frame->encoder[e];
+		int cx = (e % 4) * SIM_CELL + SIM_CELL / 2;
+		int cy = (e / 4) * SIM_CELL + SIM_CELL / 2;
+
+		// The ring runs clockwise from 7 o'clock to 5 o'clock
+		for (uint8_t led = 0; led < SIM_INDICATORS; ++led) {
+			double angle = (-135.0 + led * 27.0) * M_PI / 180.0;
+			int x = cx + (int)lround(sin(angle) * (SIM_CELL * 3 / 8));
+			int y = cy - (int)lround(cos(angle) * (SIM_CELL * 3 / 8));
+			uint8_t level = sim_pixel_level(leds->indicator[led]);
+			sim_fill(image, width, x, y, 2, level, level, level);
+		}
+		sim_fill(image, width, cx, cy, SIM_CELL / 6, sim_pixel_level(leds->red),
+				 sim_pixel_level(leds->green), sim_pixel_level(leds->blue));
+		sim_fill(image, width, cx, cy - SIM_CELL / 4, 1, sim_pixel_level(leds->detent_red),
+				 0, sim_pixel_level(leds->detent_blue));
+	}
+
+	FILE *file = fopen(path, "wb");
+	if (file) {
+		fprintf(file, "P6\n%d %d\n255\n", width, width);
+		fwrite(image, 3, width * width, file);
+		fclose(file);
+	} else {
+		fprintf(stderr, "Can't write %s\n", path);
+	}
+	free(image);
+}
+
+static void sim_print_leds(uint8_t encoder, const sim_leds_t *leds)
+{
+	printf("  enc %2u  ind", encoder);
+	for (uint8_t led = 0; led < SIM_INDICATORS; ++led) {
+		printf(" %3u", leds->indicator[led]);
+	}
+	printf("  rgb %3u %3u %3u  detent %3u %3u\n", leds->red, leds->green, leds->blue,
+		   leds->detent_red, leds->detent_blue);
+}
+
+/**
+ * Captures a frame and prints it, with -d only the encoders that changed
+ * since the last frame.
+ */
+static void sim_frame(const char *label)
+{
+	sim_frame_t frame;
+	sim_capture(&frame);
+
+	printf("%s %u %s at %u mS\n", sim_scenario_name, sim_frame_number, label,
+		   (unsigned)(frame.time_us / 1000));
+	for (uint8_t e = 0; e < PHYSICAL_ENCODERS; ++e) {
+		if (!sim_diff_only || sim_frame_number == 0 ||
+			memcmp(&frame.encoder[e], &sim_prev_frame.encoder[e], sizeof(sim_leds_t))) {
+			sim_print_leds(e, &frame.encoder[e]);
+		}
+	}
+
+	if (sim_ppm_prefix) {
+		char path[256];
+		snprintf(path, sizeof(path), "%s%s_%03u.ppm", sim_ppm_prefix, sim_scenario_name, sim_frame_number);
+		sim_write_ppm(&frame, path);
+	}
+
+	sim_prev_frame = frame;
+	sim_frame_number++;
+}
+
+/* Scenarios ----------------------------------------------------------------- */
+
+/**
+ * Powers the simulated unit up from a factory reset, as far as the display
+ * is concerned.
+ */
+static void sim_power_up(void)
+{
+	memset(sim_eeprom, 0xFF, sizeof(sim_eeprom));
+	memset(sim_shift, 0xFF, sizeof(sim_shift));
+	memset(sim_latched, 0xFF, sizeof(sim_latched));
+
+	nvm_eeprom_write_byte(EE_COLOR_MAP, DEF_COLOR_MAP);
+	midi_system_channel = DEF_MIDI_CHANNEL;
+	global_rgb_brightness = DEF_RGB_BRIGHTNESS;
+	global_ind_brightness = DEF_IND_BRIGHTNESS;
+	global_animation_channels = (DEF_ENCODER_ANIMATION_CH << 4) | DEF_SWITCH_ANIMATION_CH;
+	global_bank_animations_enabled = DEF_BANK_ANIMATIONS_ENABLED;
+
+	PMIC.CTRL = PMIC_LOLVLEN_bm | PMIC_MEDLVLEN_bm | PMIC_HILVLEN_bm;
+	colorMap_init();
+	factory_reset_encoder_config();
+	encoders_init();
+	display_init();
+	clear_display_buffer();
+	display_enable();
+	refresh_display();
+	sim_run_ms(SIM_SETTLE_MS);
+}
+
+/**
+ * Sends a CC to the unit as MIDI feedback.
+ */
+static void sim_feedback(uint8_t channel, uint8_t number, uint8_t value)
+{
+	process_element_midi(channel, SEND_CC, number, value, 0);
+}
+
+/**
+ * Each row is one indicator type, with the values across the row 0, 32, 64
+ * and 127 and a different color per encoder. Drawn without and then with
+ * detents.
+ */
+static void sim_scenario_types(void)
+{
+	static const uint8_t values[4] = {0, 32, 64, 127};
+
+	for (uint8_t detent = 0; detent < 2; ++detent) {
+		for (uint8_t e = 0; e < PHYSICAL_ENCODERS; ++e) {
+			encoder_settings[e].indicator_display_type = e / 4;
+			encoder_settings[e].has_detent = detent;
+		}
+		refresh_display();
+		for (uint8_t e = 0; e < PHYSICAL_ENCODERS; ++e) {
+			sim_feedback(DEF_ENC_CH, e, values[e % 4]);
+			sim_feedback(DEF_SW_CH, e, 1 + e * 8);
+		}
+		sim_run_ms(SIM_SETTLE_MS);
+		sim_frame(detent ? "dot, bar, blended bar, spread with detent" :
+						   "dot, bar, blended bar, spread");
+	}
+}
+
+/**
+ * Rows of RGB strobe, RGB pulse, indicator pulse and mixed indicator strobe,
+ * dimming and rainbow animations, captured 25 mS apart.
+ */
+static void sim_scenario_animation(void)
+{
+	static const uint8_t animations[PHYSICAL_ENCODERS] = {
+		2, 4, 6, 8,			// RGB strobe
+		10, 12, 14, 16,		// RGB pulse
+		58, 60, 62, 64,		// Indicator pulse
+		50, 54, 80, 127,	// Indicator strobe, indicator dimming, rainbow
+	};
+
+	for (uint8_t e = 0; e < PHYSICAL_ENCODERS; ++e) {
+		sim_feedback(DEF_ENC_CH, e, 64);
+		sim_feedback(DEF_SW_CH, e, 1 + e * 8);
+		// Indicator animations (49-96) have their own channel
+		uint8_t channel = (animations[e] > 48 && animations[e] < 97) ?
+						  GET_ENC_ANIM_CHANNEL(global_animation_channels) :
+						  GET_SW_ANIM_CHANNEL(global_animation_channels);
+		sim_feedback(channel, e, animations[e]);
+	}
+	for (uint8_t i = 0; i < 12; ++i) {
+		sim_run_ms(25);
+		sim_frame("animations");
+	}
+}
+
+/**
+ * Changes from bank 1 to bank 2 the way the side switches do, and captures
+ * the flash and fade as often as it can.
+ */
+static void sim_scenario_bank(void)
+{
+	for (uint8_t e = 0; e < PHYSICAL_ENCODERS; ++e) {
+		sim_feedback(DEF_ENC_CH, e, e * 8);
+		sim_feedback(DEF_ENC_CH, PHYSICAL_ENCODERS + e, 127 - e * 8);
+	}
+	sim_run_ms(SIM_SETTLE_MS);
+	sim_frame("bank 1");
+
+	if (global_bank_animations_enabled) {
+		bank_change_animation(1);
+	}
+	change_encoder_bank(1);
+	for (uint8_t i = 0; i < 8; ++i) {
+		sim_frame("changing to bank 2");
+	}
+	sim_run_ms(SIM_SETTLE_MS);
+	sim_frame("bank 2");
+	fprintf(stderr, "%-10s bank change redrawn in %u uS\n", sim_scenario_name, bank_change_time * SIM_COUNT_US);
+}
+
+/**
+ * The settings received confirmation and then the start up sparkle, captured
+ * 25 mS apart.
+ */
+static void sim_scenario_overlay(void)
+{
+	setting_confirmation_animation(0x00FF00);
+	for (uint8_t i = 0; i < 8; ++i) {
+		sim_frame("confirmation");
+		sim_run_ms(25);
+	}
+	run_sparkle(8);
+	for (uint8_t i = 0; i < 8; ++i) {
+		sim_frame("sparkle");
+		sim_run_ms(25);
+	}
+}
+
+/**
+ * Sends native mode SysEx to the unit, the bytes after the manufacturer ID and
+ * command.
+ */
+static void sim_native_sysex(uint8_t length, const uint8_t *data)
+{
+	uint8_t buffer[256];
+	memcpy(buffer, data, length);
+	native_mode_handle_sysex_command(length, buffer);
+}
+
+/**
+ * A host driving the unit in native mode: every encoder is given a type and a
+ * color, then the host sends every encoder's position round robin at
+ * SIM_FEEDBACK_HZ for a second. Only the top row is turning, the rest of the
+ * positions are resent unchanged. Reports the redraws per second, the main
+ * loop time is in the statistics.
+ */
+static void sim_scenario_native(void)
+{
+	static const uint8_t enter[] = {0x00, 0x01};
+	sim_native_sysex(sizeof(enter), enter);
+
+	uint8_t config[1 + PHYSICAL_ENCODERS * 10];
+	uint8_t *cfg = config;
+	*cfg++ = 0x01;
+	for (uint8_t e = 0; e < PHYSICAL_ENCODERS; ++e) {
+		// Indicator: type, detent, detent color
+		*cfg++ = 0x00; *cfg++ = e; *cfg++ = e / 4; *cfg++ = e & 0x01; *cfg++ = 0x7F;
+		// Switch: red, green, blue
+		*cfg++ = 0x01; *cfg++ = e; *cfg++ = e * 8; *cfg++ = 0x7F - e * 8; *cfg++ = 0x40;
+	}
+	sim_native_sysex((uint8_t)(cfg - config), config);
+	for (uint8_t e = 0; e < PHYSICAL_ENCODERS; ++e) {
+		sim_feedback(0, e, 64);
+	}
+	sim_run_ms(SIM_SETTLE_MS);
+	sim_frame("native mode");
+
+	sim_indicator_draws = sim_rgb_draws = 0;
+	uint32_t messages = 0;
+	for (uint16_t ms = 0; ms < 1000; ++ms) {
+		for (uint8_t i = 0; i < SIM_FEEDBACK_HZ / 1000; ++i, ++messages) {
+			uint8_t e = messages % PHYSICAL_ENCODERS;
+			uint8_t value = 64;
+			if (e < 4) {
+				// A full turn every 2 seconds
+				value = (uint8_t)((messages / PHYSICAL_ENCODERS * PHYSICAL_ENCODERS * 127 / 2000 + e * 32) & 0x7F);
+			}
+			sim_feedback(0, e, value);
+		}
+		sim_run_ms(1);
+	}
+	printf("%s %u feedback messages, %u indicator and %u RGB redraws per second\n",
+		   sim_scenario_name, messages, sim_indicator_draws, sim_rgb_draws);
+	sim_frame("after a second of feedback");
+}
+
+static const sim_scenario_t sim_scenarios[] = {
+	{"types",		sim_scenario_types},
+	{"animation",	sim_scenario_animation},
+	{"bank",		sim_scenario_bank},
+	{"overlay",		sim_scenario_overlay},
+	{"native",		sim_scenario_native},
+};
+
+/**
+ * Runs a scenario in a child process, so every scenario starts from the
+ * firmware's power on state.
+ */
+static bool sim_run_scenario(const sim_scenario_t *scenario)
+{
+	fflush(stdout);
+	fflush(stderr);
+	pid_t child = fork();
+	if (child < 0) {
+		perror("fork");
+		exit(1);
+	} else if (child > 0) {
+		int status;
+		waitpid(child, &status, 0);
+		return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	}
+
+	sim_scenario_name = scenario->name;
+	sim_power_up();
+	sim_frame_isrs = sim_dma_isrs = sim_dma_retries = sim_passes = 0;
+	sim_indicator_draws = sim_rgb_draws = 0;
+	#if DISPLAY_RGB_CACHE > 0
+	display_rgb_cache_hits = display_rgb_cache_misses = 0;
+	#endif
+	sim_pass_ns_total = sim_pass_ns_max = 0;
+
+	scenario->run();
+
+	// Host timings vary from run to run, keep them out of the frames so the
+	// output can be diffed
+	fprintf(stderr, "%-10s %6u main loop passes, %7.2f uS mean, %7.2f uS max host time, "
+			"%u frame and %u DMA interrupts, %u late planes\n",
+			scenario->name, sim_passes, sim_pass_ns_total / 1000.0 / (sim_passes ? sim_passes : 1),
+			sim_pass_ns_max / 1000.0, sim_frame_isrs, sim_dma_isrs, sim_dma_retries);
+	#if DISPLAY_RGB_CACHE > 0
+	fprintf(stderr, "%-10s RGB color cache %u hits, %u misses\n", scenario->name,
+			display_rgb_cache_hits, display_rgb_cache_misses);
+	#endif
+	fflush(stdout);
+	exit(0);
+}
+
+int main(int argc, char **argv)
+{
+	const char *scenario_name = "all";
+	int opt;
+
+	while ((opt = getopt(argc, argv, "s:o:l:u:d")) != -1) {
+		switch (opt) {
+			case 's':
+			scenario_name = optarg;
+			break;
+			case 'o':
+			sim_ppm_prefix = optarg;
+			break;
+			case 'l':
+			sim_loop_counts = (uint32_t)atoi(optarg) / SIM_COUNT_US;
+			if (!sim_loop_counts) {
+				sim_loop_counts = 1;
+			}
+			break;
+			case 'u':
+			sim_usb_counts = (uint32_t)atoi(optarg) / SIM_COUNT_US;
+			break;
+			case 'd':
+			sim_diff_only = true;
+			break;
+			default:
+			fprintf(stderr, "usage: %s [-s types|animation|bank|overlay|native|all] [-o prefix] [-l loop_us] [-u usb_us] [-d]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool found = false;
+	bool passed = true;
+	for (uint8_t i = 0; i < sizeof(sim_scenarios) / sizeof(sim_scenarios[0]); ++i) {
+		if (!strcmp(scenario_name, "all") || !strcmp(scenario_name, sim_scenarios[i].name)) {
+			passed &= sim_run_scenario(&sim_scenarios[i]);
+			found = true;
+		}
+	}
+	if (!found) {
+		fprintf(stderr, "Unknown scenario %s\n", scenario_name);
+		return 2;
+	}
+	return passed ? 0 : 1;
+}
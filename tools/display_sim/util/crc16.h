@@ -0,0 +1,21 @@
+/*
+ * crc16.h
+ *
+ * Host stand-in for avr-libc's CRC functions, the same algorithm as the
+ * reference C code in the avr-libc documentation.
+ */
+
+
+#ifndef DISPLAY_SIM_CRC16_H_
+#define DISPLAY_SIM_CRC16_H_
+
+	#include <stdint.h>
+
+	static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t data)
+	{
+		data ^= (uint8_t)crc;
+		data ^= data << 4;
+		return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+	}
+
+#endif /* DISPLAY_SIM_CRC16_H_ */
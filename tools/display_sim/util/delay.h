@@ -0,0 +1,14 @@
+/*
+ * delay.h
+ *
+ * Host stand-in for avr-libc's busy wait delays, implemented in display_sim.c.
+ */
+
+
+#ifndef DISPLAY_SIM_DELAY_H_
+#define DISPLAY_SIM_DELAY_H_
+
+	void _delay_ms(double ms);
+	void _delay_us(double us);
+
+#endif /* DISPLAY_SIM_DELAY_H_ */
@@ -0,0 +1,78 @@
+/*
+ * asf.h
+ *
+ * Host stand-in for the ASF header, just enough of it for input.c to compile
+ * on a PC. The timer and port functions are implemented in encoder_sim.c,
+ * which models the 74HC165 shift register chain the encoders are read from.
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef ENCODER_SIM_ASF_H_
+#define ENCODER_SIM_ASF_H_
+
+/*	Includes: */
+	#include <stdint.h>
+	#include <stdbool.h>
+
+/*	Macros: */
+	#define PORTA 0
+	#define PORTC 2
+	#define IOPORT_CREATE_PIN(port, pin) ((port) * 8 + (pin))
+
+	#define IOPORT_DIR_INPUT	0
+	#define IOPORT_DIR_OUTPUT	1
+	#define IOPORT_MODE_PULLUP	0
+
+	#define TC_CLKSEL_DIV1024_gc 7
+
+/*	Types: */
+	typedef uint8_t irqflags_t;
+	typedef uint8_t ioport_pin_t;
+	typedef void (*tc_callback_t)(void);
+
+	typedef enum { TC_CCA, TC_CCB } tc_cc_channel_t;
+	typedef enum { TC_INT_LVL_OFF, TC_INT_LVL_LO, TC_INT_LVL_MED, TC_INT_LVL_HI } tc_int_level_t;
+	typedef enum { TC_WG_NORMAL } tc_wg_mode_t;
+
+	typedef struct { uint16_t CNT; } TC1_t;
+
+/* Variables */
+	extern TC1_t TCC1;
+
+/* Function Prototypes: */
+	void ioport_set_pin_dir(ioport_pin_t pin, uint8_t dir);
+	void ioport_set_pin_mode(ioport_pin_t pin, uint8_t mode);
+	void ioport_set_pin_level(ioport_pin_t pin, bool level);
+	bool ioport_get_pin_level(ioport_pin_t pin);
+
+	void cpu_irq_enable(void);
+	void cpu_irq_disable(void);
+	irqflags_t cpu_irq_save(void);
+	void cpu_irq_restore(irqflags_t flags);
+
+	void tc_enable(TC1_t *tc);
+	void tc_set_cca_interrupt_callback(TC1_t *tc, tc_callback_t callback);
+	void tc_set_ccb_interrupt_callback(TC1_t *tc, tc_callback_t callback);
+	void tc_set_wgm(TC1_t *tc, tc_wg_mode_t mode);
+	void tc_write_cc(TC1_t *tc, tc_cc_channel_t channel, uint16_t value);
+	void tc_set_cca_interrupt_level(TC1_t *tc, tc_int_level_t level);
+	void tc_set_ccb_interrupt_level(TC1_t *tc, tc_int_level_t level);
+	void tc_write_clock_source(TC1_t *tc, uint8_t source);
+	uint16_t tc_read_count(TC1_t *tc);
+
+#endif /* ENCODER_SIM_ASF_H_ */
@@ -0,0 +1,390 @@
+/*
+ * capture_matrix.c
+ *
+ * Host side test of the encoder detents and end stops. Runs the firmware's
+ * process_encoder_input_rotary() for every encoder MIDI type (absolute and
+ * relative), movement mode, detent on and off, and every detent capture,
+ * detent width and end stop setting, and checks each combination against
+ * the geometry the settings promise:
+ * - Absolute encoders hold at an end stop until turned away by one tick more
+ *   than the end stop size, and hold in the detent window until turned one
+ *   tick more than the capture strength, then leave from the window's edge.
+ * - Leftover travel on one virtual encoder never releases another.
+ * - Relative encoders are never captured, every tick sends a CC.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -O2 -fcommon -Itools/display_sim -Isrc -o capture_matrix tools/encoder_sim/capture_matrix.c -lm
+ *   ./capture_matrix [-v]
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Compile the firmware's encoder code straight into the test, against the
+// display emulator's ASF stand-ins, so the code under test is exactly the
+// one that ships. Everything it calls outside encoders.c is stubbed below.
+#include "../../src/encoders.c"
+
+#include <stdio.h>
+
+/*	Macros: */
+	#define SIM_ENCODER			0		// Physical encoder turned, bank 0
+	#define SIM_SHIFTED			(SIM_ENCODER + BANKED_ENCODERS)	// Its shifted virtual encoder
+	#define SIM_CYCLES			20		// Scan cycles per tick seen by the velocity calculation
+	#define SIM_MAX_TICKS		64		// Give up waiting for a release after this many ticks
+
+	// The geometry each setting promises, kept apart from the tables in
+	// encoders.c so a change to those shows up here
+	#define SIM_RAW_MIN			0
+	#define SIM_RAW_MAX			12700
+	#define SIM_RAW_CENTER		6300
+	#define SIM_RAW_FREE		3000	// Well clear of the detent and end stops
+
+/*	Types: */
+	typedef struct {
+		uint8_t		midi_type;
+		bool		relative;
+		const char	*name;
+	} sim_midi_type_t;
+
+/* Variables */
+	USB_ClassInfo_MIDI_Device_t* g_midi_interface_info;
+	TC0_t TCC0;
+	uint16_t animation_phase;
+
+	static const sim_midi_type_t sim_midi_types[] = {
+		{SEND_NOTE,						false,	"note"},
+		{SEND_CC,						false,	"cc"},
+		{SEND_SWITCH_VEL_CONTROL,		false,	"cc+vel"},
+		{SEND_REL_ENC,					true,	"relative"},
+		{SEND_REL_ENC_MOUSE_EMU_DRAG,	true,	"drag"},
+		{SEND_REL_ENC_MOUSE_EMU_SCROLL,	true,	"scroll"},
+	};
+	static const char *sim_movement_names[] = {"direct", "emulation", "velocity"};
+
+	static const uint8_t sim_capture_ticks[ENC_DETENT_CAPTURE_MASK + 1] = {8, 4, 12, 16};
+	static const int16_t sim_window_low[ENC_DETENT_WIDTH_MASK + 1] = {6240, 6040};
+	static const int16_t sim_window_high[ENC_DETENT_WIDTH_MASK + 1] = {6450, 6650};
+	static const uint8_t sim_end_stop_ticks[ENC_END_STOP_MASK + 1] = {2, 6};
+
+	static int8_t sim_encoder_ticks;	// Returned by the next get_encoder_value()
+	static uint16_t sim_messages;		// MIDI messages sent
+	static bool sim_verbose;
+	static const char *sim_case;		// Name of the combination being run
+	static uint16_t sim_failures;
+
+/* ASF stand-ins ------------------------------------------------------------ */
+
+void cpu_irq_enable(void) {}
+void cpu_irq_disable(void) {}
+void wdt_reset(void) {}
+uint16_t tc_read_count(TC0_t *tc) { (void)tc; return 0; }
+uint8_t MIDI_Device_Flush(USB_ClassInfo_MIDI_Device_t *interface_info) { (void)interface_info; return 0; }
+
+/* The rest of the firmware ------------------------------------------------- */
+
+int8_t get_encoder_value(uint8_t encoder)
+{
+	int8_t ticks = (encoder == SIM_ENCODER) ? sim_encoder_ticks : 0;
+	sim_encoder_ticks = 0;
+	return ticks;
+}
+
+uint16_t get_encoder_cycle_count(uint8_t encoder) { (void)encoder; return SIM_CYCLES; }
+bool encoder_is_active(uint8_t enc_idx) { (void)enc_idx; return false; }
+uint16_t update_encoder_switch_state(void) { return 0; }
+uint16_t get_enc_switch_state(void) { return 0; }
+uint16_t get_enc_switch_down(void) { return 0; }
+uint16_t get_enc_switch_up(void) { return 0; }
+uint32_t get_ms_timer(void) { return 0; }
+bool get_bank_select_active(void) { return false; }
+void draw_bank_select_overlay(void) {}
+void reset_idle_timer(void) {}
+bool preset_in_use(void) { return false; }
+
+void gesture_init(void) {}
+void gesture_encoder_turned(uint8_t sw) { (void)sw; }
+uint8_t gesture_time_or_default(uint8_t time, uint8_t default_time) { return time ? time : default_time; }
+
+gesture_t gesture_process(uint8_t sw, switch_event_t event, uint8_t long_press_time, uint8_t double_tap_time,
+						  gesture_t wanted)
+{
+	(void)sw; (void)event; (void)long_press_time; (void)double_tap_time; (void)wanted;
+	return GESTURE_NONE;
+}
+
+bool native_mode_consume_midi_event(uint8_t type, uint8_t channel, uint8_t number, uint8_t value)
+{
+	(void)type; (void)channel; (void)number; (void)value;
+	return false;
+}
+
+bool native_mode_process_encoder_input_rotary(uint8_t idx, int16_t delta) { (void)idx; (void)delta; return false; }
+bool native_mode_process_encoder_input_switch_pressed(uint8_t idx, bool pressed) { (void)idx; (void)pressed; return false; }
+bool native_mode_update_encoder_display_single(uint8_t idx) { (void)idx; return false; }
+void native_mode_invalidate_display(void) {}
+
+void midi_stream_raw_note(const uint8_t channel, const uint8_t pitch, const bool onoff, const uint8_t velocity)
+{
+	(void)channel; (void)pitch; (void)onoff; (void)velocity;
+	sim_messages++;
+}
+
+void midi_stream_raw_cc(const uint8_t channel, const uint8_t cc, const uint8_t value)
+{
+	(void)channel; (void)cc; (void)value;
+	sim_messages++;
+}
+
+void midi_stream_raw_pitchbend(const uint8_t channel, const uint16_t value)
+{
+	(void)channel; (void)value;
+	sim_messages++;
+}
+
+void config_store_write_page(uint8_t page, const uint8_t *data) { (void)page; (void)data; }
+void config_store_flush(void) {}
+uint8_t eeprom_queue_read_byte(uint16_t address) { (void)address; return 0xFF; }
+
+void eeprom_queue_read_buffer(uint16_t address, uint8_t *buffer, uint8_t length)
+{
+	(void)address;
+	memset(buffer, 0xFF, length);
+}
+
+void bank_change_animation(uint8_t new_bank) { (void)new_bank; }
+void run_encoder_animation(uint8_t encoder, uint8_t bank, uint8_t animation, uint8_t color)
+{
+	(void)encoder; (void)bank; (void)animation; (void)color;
+}
+
+void set_encoder_indicator(uint8_t encoder, uint8_t position, bool has_detent, uint16_t type,
+						   uint8_t detent_color)
+{
+	(void)encoder; (void)position; (void)has_detent; (void)type; (void)detent_color;
+}
+
+void set_encoder_rgb(uint8_t encoder, uint8_t color) { (void)encoder; (void)color; }
+
+/* Checks ------------------------------------------------------------------- */
+
+static void sim_check(bool ok, const char *what, long got, long expected)
+{
+	if (!ok) {
+		sim_failures++;
+		printf("  %s: %s was %ld, expected %ld\n", sim_case, what, got, expected);
+	}
+}
+
+/**
+ * Puts the encoder at a raw value with a fresh capture state, as if it had
+ * just been turned there from the free zone.
+ */
+static void sim_place(uint8_t virtual_encoder_id, int16_t raw_value)
+{
+	raw_encoder_value[virtual_encoder_id] = raw_value;
+	encoder_capture_zone[SIM_ENCODER] = CAPTURE_FREE;
+	encoder_capture_owner[SIM_ENCODER] = virtual_encoder_id;
+	encoder_detent_counter[SIM_ENCODER] = 0;
+}
+
+// Turns the encoder by one or more ticks in a single main loop pass
+static void sim_turn(uint8_t virtual_encoder_id, int8_t ticks)
+{
+	sim_encoder_ticks = ticks;
+	process_encoder_input_rotary(SIM_ENCODER, virtual_encoder_id, SIM_ENCODER, 0x0001);
+}
+
+/**
+ * Turns one tick at a time until the raw value changes.
+ *
+ * \return the number of ticks it took, or SIM_MAX_TICKS
+ */
+static uint8_t sim_ticks_to_release(uint8_t virtual_encoder_id, int8_t direction)
+{
+	int16_t start = raw_encoder_value[virtual_encoder_id];
+	for (uint8_t ticks = 1; ticks < SIM_MAX_TICKS; ++ticks) {
+		sim_turn(virtual_encoder_id, direction);
+		if (raw_encoder_value[virtual_encoder_id] != start) {
+			return ticks;
+		}
+	}
+	return SIM_MAX_TICKS;
+}
+
+// An absolute encoder leaving an end stop
+static void sim_check_end_stop(int16_t end, int8_t away, int16_t release_value, uint8_t end_stop)
+{
+	sim_place(SIM_ENCODER, end);
+	sim_messages = 0;
+	sim_turn(SIM_ENCODER, -away);
+	sim_turn(SIM_ENCODER, -away);
+	sim_check(raw_encoder_value[SIM_ENCODER] == end, "value after pushing in to the end stop",
+			  raw_encoder_value[SIM_ENCODER], end);
+
+	uint8_t ticks = sim_ticks_to_release(SIM_ENCODER, away);
+	sim_check(ticks == sim_end_stop_ticks[end_stop] + 1, "ticks to leave the end stop",
+			  ticks, sim_end_stop_ticks[end_stop] + 1);
+	sim_check(raw_encoder_value[SIM_ENCODER] == release_value, "value on leaving the end stop",
+			  raw_encoder_value[SIM_ENCODER], release_value);
+	sim_check(sim_messages == 0, "MIDI messages while held at the end stop", sim_messages, 0);
+}
+
+// An absolute encoder with a detent leaving it, and the edges of its window
+static void sim_check_detent(uint8_t capture, uint8_t width)
+{
+	for (int8_t direction = -1; direction <= 1; direction += 2) {
+		int16_t edge = (direction > 0) ? sim_window_high[width] : sim_window_low[width];
+		sim_place(SIM_ENCODER, SIM_RAW_CENTER);
+		sim_messages = 0;
+		uint8_t ticks = sim_ticks_to_release(SIM_ENCODER, direction);
+		sim_check(ticks == sim_capture_ticks[capture] + 1, "ticks to leave the detent",
+				  ticks, sim_capture_ticks[capture] + 1);
+		sim_check(raw_encoder_value[SIM_ENCODER] == edge, "value on leaving the detent",
+				  raw_encoder_value[SIM_ENCODER], edge);
+		sim_check(sim_messages == 0, "MIDI messages while held in the detent", sim_messages, 0);
+	}
+
+	// Just inside the window is captured, the window's edge itself is not
+	sim_place(SIM_ENCODER, sim_window_low[width] + 1);
+	sim_turn(SIM_ENCODER, 1);
+	sim_check(raw_encoder_value[SIM_ENCODER] == sim_window_low[width] + 1, "value just inside the window",
+			  raw_encoder_value[SIM_ENCODER], sim_window_low[width] + 1);
+	sim_place(SIM_ENCODER, sim_window_high[width] - 1);
+	sim_turn(SIM_ENCODER, -1);
+	sim_check(raw_encoder_value[SIM_ENCODER] == sim_window_high[width] - 1, "value just inside the window",
+			  raw_encoder_value[SIM_ENCODER], sim_window_high[width] - 1);
+	sim_place(SIM_ENCODER, sim_window_low[width]);
+	sim_turn(SIM_ENCODER, -1);
+	sim_check(raw_encoder_value[SIM_ENCODER] < sim_window_low[width], "value leaving the window's low edge",
+			  raw_encoder_value[SIM_ENCODER], sim_window_low[width] - 1);
+	sim_place(SIM_ENCODER, sim_window_high[width]);
+	sim_turn(SIM_ENCODER, 1);
+	sim_check(raw_encoder_value[SIM_ENCODER] > sim_window_high[width], "value leaving the window's high edge",
+			  raw_encoder_value[SIM_ENCODER], sim_window_high[width] + 1);
+
+	// Travel on the unshifted encoder must not count towards the shifted one
+	sim_place(SIM_ENCODER, SIM_RAW_CENTER);
+	raw_encoder_value[SIM_SHIFTED] = SIM_RAW_CENTER;
+	for (uint8_t i = 0; i < sim_capture_ticks[capture]; ++i) {
+		sim_turn(SIM_ENCODER, 1);
+	}
+	uint8_t ticks = sim_ticks_to_release(SIM_SHIFTED, 1);
+	sim_check(ticks == sim_capture_ticks[capture] + 1, "ticks to leave the shifted encoder's detent",
+			  ticks, sim_capture_ticks[capture] + 1);
+}
+
+// An absolute encoder turning freely, by the step its movement mode sets
+static void sim_check_free(bool has_detent, uint8_t movement)
+{
+	static const int16_t steps[] = {ENCODER_VALUE_SCALAR_DIRECT, ENCODER_VALUE_SCALAR_EMULATION, 0};
+	int16_t start = has_detent ? SIM_RAW_FREE : SIM_RAW_CENTER;
+
+	for (int8_t direction = -1; direction <= 1; direction += 2) {
+		sim_place(SIM_ENCODER, start);
+		sim_messages = 0;
+		sim_turn(SIM_ENCODER, direction);
+		int16_t moved = raw_encoder_value[SIM_ENCODER] - start;
+		if (steps[movement]) {
+			sim_check(moved == direction * steps[movement], "free step", moved, direction * steps[movement]);
+		} else {
+			sim_check(moved * direction > 0, "free step direction", moved, direction);
+		}
+		sim_check(sim_messages == 1, "MIDI messages for a free step", sim_messages, 1);
+	}
+}
+
+// A relative encoder, from every place that would capture an absolute one
+static void sim_check_relative(void)
+{
+	static const int16_t places[] = {SIM_RAW_MIN, SIM_RAW_CENTER, SIM_RAW_MAX, SIM_RAW_FREE};
+
+	for (uint8_t i = 0; i < sizeof(places) / sizeof(places[0]); ++i) {
+		for (int8_t direction = -1; direction <= 1; direction += 2) {
+			sim_place(SIM_ENCODER, places[i]);
+			sim_messages = 0;
+			for (uint8_t tick = 0; tick < SIM_MAX_TICKS; ++tick) {
+				sim_turn(SIM_ENCODER, direction);
+			}
+			sim_check(sim_messages == SIM_MAX_TICKS, "relative MIDI messages", sim_messages, SIM_MAX_TICKS);
+			sim_check(raw_encoder_value[SIM_ENCODER] == places[i], "relative raw value",
+					  raw_encoder_value[SIM_ENCODER], places[i]);
+			sim_check(encoder_detent_counter[SIM_ENCODER] == 0, "relative capture counter",
+					  encoder_detent_counter[SIM_ENCODER], 0);
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if (argc > 1 && !strcmp(argv[1], "-v")) {
+		sim_verbose = true;
+	} else if (argc > 1) {
+		fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+		return 2;
+	}
+
+	char name[80];
+	uint16_t cases = 0;
+	encoder_config_t *cfg = &encoder_settings[SIM_ENCODER];
+	encoder_extra_config_t *extra = &encoder_extra_settings[SIM_ENCODER];
+
+	for (uint8_t t = 0; t < sizeof(sim_midi_types) / sizeof(sim_midi_types[0]); ++t) {
+		uint16_t type_failures = sim_failures;
+		for (uint8_t movement = DIRECT; movement <= VELOCITY_SENSITIVE_ENC; ++movement) {
+			for (uint8_t has_detent = 0; has_detent <= 1; ++has_detent) {
+				for (uint8_t capture = 0; capture <= ENC_DETENT_CAPTURE_MASK; ++capture) {
+					for (uint8_t width = 0; width <= ENC_DETENT_WIDTH_MASK; ++width) {
+						for (uint8_t end_stop = 0; end_stop <= ENC_END_STOP_MASK; ++end_stop) {
+							snprintf(name, sizeof(name), "%s %s detent %u capture %u width %u end stop %u",
+									 sim_midi_types[t].name, sim_movement_names[movement], has_detent,
+									 capture, width, end_stop);
+							sim_case = name;
+							cases++;
+
+							memset(cfg, 0, sizeof(*cfg));
+							cfg->encoder_midi_type = sim_midi_types[t].midi_type;
+							cfg->movement = movement;
+							cfg->has_detent = has_detent;
+							cfg->switch_action_type = CC_HOLD;
+							extra->detent_capture = capture;
+							extra->detent_width = width;
+							extra->end_stop_size = end_stop;
+
+							uint16_t failures = sim_failures;
+							if (sim_midi_types[t].relative) {
+								sim_check_relative();
+							} else {
+								sim_check_end_stop(SIM_RAW_MIN, 1, 100, end_stop);
+								sim_check_end_stop(SIM_RAW_MAX, -1, 12600, end_stop);
+								if (has_detent) {
+									sim_check_detent(capture, width);
+								}
+								sim_check_free(has_detent, movement);
+							}
+							if (sim_verbose) {
+								printf("  %s %s\n", sim_failures == failures ? "ok  " : "FAIL", name);
+							}
+						}
+					}
+				}
+			}
+		}
+		printf("%s %s\n", sim_failures == type_failures ? "PASS" : "FAIL", sim_midi_types[t].name);
+	}
+
+	printf("%u combinations, %u failed checks\n", cases, sim_failures);
+	return sim_failures ? 1 : 0;
+}
@@ -0,0 +1,414 @@
+/*
+ * encoder_sim.c
+ *
+ * Host side encoder waveform simulator. Runs the unmodified encoder_scan()
+ * from src/input.c against synthetic quadrature waveforms (constant speed
+ * sweeps, contact bounce and direction reversals) and reports the detected
+ * versus true ticks and the resulting velocity multipliers, so the scan rate
+ * and ENCODER_DEBOUNCE_CYCLE_TIMEOUT can be tuned from data.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -O2 -Itools/encoder_sim -Isrc -o encoder_sim tools/encoder_sim/encoder_sim.c -lm
+ *   ./encoder_sim [-s sweep|bounce|reverse|all] [-b bounce_us] [-l loop_us] [-r seed] [-c]
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// input.h pulls in the display driver and, through it, the rest of the
+// firmware. The scan code needs none of it, so keep it out.
+#define DISPLAY_DRIVER_H_
+
+// Compile the firmware's input driver straight into the simulator so the
+// decoder under test is exactly the one that ships.
+#include "../../src/input.c"
+
+#include <stdio.h>
+#include <math.h>
+
+/*	Macros: */
+	#define SIM_TICK_US			32.0	// TCC1 runs at 32MHz / 1024
+	#define SIM_EDGES_PER_REV	96		// 24 detents x 4 quadrature edges
+	#define SIM_ENCODER			0		// Simulated encoder, the rest stay still
+	#define SIM_STREAM_BITS		48		// 16 switches + 16 x (ch B, ch A)
+	#define SIM_MAX_EDGES		4096
+	#define SIM_LEAD_IN_US		200000.0 // Let the scan rate settle to idle first
+	#define SIM_TAIL_US			300000.0
+
+/*	Types: */
+	typedef struct {
+		double	time_us;
+		int8_t	dir;
+	} sim_edge_t;
+
+	typedef struct {
+		const char *name;
+		uint16_t	rpm;
+		uint16_t	bounce_us;
+		uint32_t	true_ticks;
+		int32_t		true_net;
+		uint32_t	detected_ticks;
+		int32_t		detected_net;
+		uint16_t	mult_min;
+		uint16_t	mult_max;
+		uint32_t	mult_sum;
+		uint32_t	mult_count;
+	} sim_result_t;
+
+/* Variables */
+	TC1_t TCC1;
+
+	static tc_callback_t cca_callback;
+	static uint64_t sim_ticks;
+	static uint64_t next_cca_ticks;
+	static uint16_t last_cca_value;
+
+	static bool sr_bits[SIM_STREAM_BITS];
+	static uint8_t sr_pos;
+	static bool sr_clk;
+	static bool sr_latch;
+
+	static sim_edge_t edges[SIM_MAX_EDGES];
+	static uint16_t edge_count;
+	static uint16_t edge_pos;			// edges[] before this index have happened
+	static int32_t position;			// net quadrature position (edges)
+	static double last_edge_us = -1e9;
+	static uint16_t bounce_us;
+	static uint32_t rng_state = 1;
+
+	static double loop_us = 1000.0;
+	static bool csv_output = false;
+
+// ===== ASF stand-ins ============================================
+
+void ioport_set_pin_dir(ioport_pin_t pin, uint8_t dir) { (void)pin; (void)dir; }
+void ioport_set_pin_mode(ioport_pin_t pin, uint8_t mode) { (void)pin; (void)mode; }
+
+void cpu_irq_enable(void) {}
+void cpu_irq_disable(void) {}
+irqflags_t cpu_irq_save(void) { return 0; }
+void cpu_irq_restore(irqflags_t flags) { (void)flags; }
+
+void tc_enable(TC1_t *tc) { (void)tc; }
+void tc_set_cca_interrupt_callback(TC1_t *tc, tc_callback_t callback) { (void)tc; cca_callback = callback; }
+void tc_set_ccb_interrupt_callback(TC1_t *tc, tc_callback_t callback) { (void)tc; (void)callback; }
+void tc_set_wgm(TC1_t *tc, tc_wg_mode_t mode) { (void)tc; (void)mode; }
+void tc_set_cca_interrupt_level(TC1_t *tc, tc_int_level_t level) { (void)tc; (void)level; }
+void tc_set_ccb_interrupt_level(TC1_t *tc, tc_int_level_t level) { (void)tc; (void)level; }
+void tc_write_clock_source(TC1_t *tc, uint8_t source) { (void)tc; (void)source; }
+uint16_t tc_read_count(TC1_t *tc) { (void)tc; return (uint16_t)sim_ticks; }
+
+/**
+ * The compare value is 16 bits and wraps, so track the next match as an
+ * offset from the previous one.
+ */
+void tc_write_cc(TC1_t *tc, tc_cc_channel_t channel, uint16_t value)
+{
+	(void)tc;
+	if (channel == TC_CCA) {
+		next_cca_ticks += (uint16_t)(value - last_cca_value);
+		last_cca_value = value;
+	}
+}
+
+// ===== Waveform =================================================
+
+static uint32_t sim_random(void)
+{
+	// xorshift32, reproducible for a given seed
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 17;
+	rng_state ^= rng_state << 5;
+	return rng_state;
+}
+
+/**
+ * Samples the quadrature channels of the simulated encoder. Clockwise
+ * movement steps A/B through 00 -> 10 -> 11 -> 01. While the last edge is
+ * younger than the bounce time, the channel which changed reads randomly.
+ */
+static void sample_encoder(double now_us, bool *cha, bool *chb)
+{
+	while (edge_pos < edge_count && edges[edge_pos].time_us <= now_us) {
+		position += edges[edge_pos].dir;
+		last_edge_us = edges[edge_pos].time_us;
+		edge_pos++;
+	}
+	static const uint8_t gray[4] = {0x00, 0x01, 0x03, 0x02}; // bit 0 = A, bit 1 = B
+	uint8_t state = gray[position & 0x03];
+
+	if (now_us - last_edge_us < bounce_us) {
+		// A and B never change together, the odd position sets tell which one just moved
+		uint8_t changed = (position & 0x01) ? 0x01 : 0x02;
+		if (sim_random() & 0x01) {
+			state ^= changed;
+		}
+	}
+	*cha = state & 0x01;
+	*chb = state & 0x02;
+}
+
+/**
+ * Models the 74HC165 chain. Latching loads the parallel inputs and presents
+ * the first bit, each rising clock edge presents the next one.
+ */
+void ioport_set_pin_level(ioport_pin_t pin, bool level)
+{
+	if (pin == ENC_LATCH) {
+		if (level && !sr_latch) {
+			double now_us = sim_ticks * SIM_TICK_US;
+			uint8_t n = 0;
+			for (uint8_t i = 0; i < 16; ++i) {
+				sr_bits[n++] = true; // switches are active low, all released
+			}
+			for (int8_t i = 15; i >= 0; --i) {
+				bool cha = false, chb = false;
+				if (i == SIM_ENCODER) {
+					sample_encoder(now_us, &cha, &chb);
+				}
+				sr_bits[n++] = chb;
+				sr_bits[n++] = cha;
+			}
+			sr_pos = 0;
+		}
+		sr_latch = level;
+	} else if (pin == ENC_CLK) {
+		if (level && !sr_clk && sr_pos < SIM_STREAM_BITS) {
+			sr_pos++;
+		}
+		sr_clk = level;
+	}
+}
+
+bool ioport_get_pin_level(ioport_pin_t pin)
+{
+	if (pin == ENC_DATA) {
+		return sr_pos < SIM_STREAM_BITS ? sr_bits[sr_pos] : false;
+	}
+	return true; // side switches released
+}
+
+/**
+ * Queues `count` edges at a constant speed starting at `start_us`.
+ *
+ * \return time of the last queued edge
+ */
+static double queue_edges(double start_us, uint16_t rpm, uint16_t count, int8_t dir)
+{
+	double period_us = 60.0e6 / ((double)rpm * SIM_EDGES_PER_REV);
+	double t = start_us;
+	for (uint16_t k = 0; k < count && edge_count < SIM_MAX_EDGES; ++k) {
+		t += period_us;
+		edges[edge_count].time_us = t;
+		edges[edge_count].dir = dir;
+		edge_count++;
+	}
+	return t;
+}
+
+// ===== Simulation ===============================================
+
+/**
+ * Copy of convert_ticks_per_scan_to_value_multiplier() from encoders.c,
+ * which cannot be built on the host.
+ */
+static uint16_t velocity_multiplier(uint8_t tick_count, uint16_t cycles_count)
+{
+	float multiplier = velocity_calc_slope*(float)(tick_count)/(float)(cycles_count) + velocity_calc_offset;
+	if (multiplier > VELOCITY_CALC_MAX_MULTIPLIER) {
+		multiplier = VELOCITY_CALC_MAX_MULTIPLIER;
+	} else if (multiplier < VELOCITY_CALC_MIN_MULTIPLIER) {
+		multiplier = VELOCITY_CALC_MIN_MULTIPLIER;
+	}
+	return (uint16_t)(multiplier);
+}
+
+/**
+ * Puts the input driver back into its power-on state, with every encoder
+ * already idle.
+ */
+static void sim_reset(void)
+{
+	sim_ticks = 0;
+	next_cca_ticks = 0;
+	last_cca_value = 0;
+	edge_count = 0;
+	edge_pos = 0;
+	position = 0;
+	last_edge_us = -1e9;
+
+	encoder_cha_state_prev = 0;
+	encoder_chb_state_prev = 0;
+	memset(encoder_inactive_counter, ENCODER_INACTIVE_THRESHOLD, sizeof(encoder_inactive_counter));
+	input_init();
+}
+
+/**
+ * Runs the queued edges through encoder_scan(). The main loop is modelled by
+ * polling the encoder every loop_us, the same way process_encoder_input_rotary()
+ * does.
+ */
+static void sim_run(sim_result_t *result)
+{
+	double end_us = (edge_count ? edges[edge_count - 1].time_us : 0) + SIM_TAIL_US;
+	double next_poll_us = loop_us;
+
+	result->true_ticks = edge_count;
+	result->true_net = 0;
+	for (uint16_t k = 0; k < edge_count; ++k) {
+		result->true_net += edges[k].dir;
+	}
+	result->detected_ticks = 0;
+	result->detected_net = 0;
+	result->mult_min = 0xFFFF;
+	result->mult_max = 0;
+	result->mult_sum = 0;
+	result->mult_count = 0;
+
+	while (sim_ticks * SIM_TICK_US < end_us) {
+		if (next_cca_ticks * SIM_TICK_US <= next_poll_us) {
+			sim_ticks = next_cca_ticks;
+			cca_callback();
+		} else {
+			int8_t ticks = get_encoder_value(SIM_ENCODER);
+			uint16_t cycles = get_encoder_cycle_count(SIM_ENCODER);
+			if (ticks) {
+				uint8_t tick_count = ticks < 0 ? -ticks : ticks;
+				uint16_t multiplier = velocity_multiplier(tick_count, cycles);
+				result->detected_ticks += tick_count;
+				result->detected_net += ticks;
+				if (multiplier < result->mult_min) result->mult_min = multiplier;
+				if (multiplier > result->mult_max) result->mult_max = multiplier;
+				result->mult_sum += multiplier;
+				result->mult_count++;
+			}
+			next_poll_us += loop_us;
+		}
+	}
+}
+
+static void print_header(void)
+{
+	if (csv_output) {
+		printf("scenario,rpm,bounce_us,true_ticks,detected_ticks,true_net,detected_net,missed_pct,mult_min,mult_avg,mult_max\n");
+	} else {
+		printf("%-8s %5s %6s %6s %6s %6s %6s %7s %5s %7s %5s\n", "scenario", "rpm", "bounce",
+			   "true", "det", "net", "detnet", "missed", "mmin", "mavg", "mmax");
+	}
+}
+
+static void print_result(const sim_result_t *r)
+{
+	double missed = r->true_ticks ? 100.0 * ((double)r->true_ticks - r->detected_ticks) / r->true_ticks : 0.0;
+	double avg = r->mult_count ? (double)r->mult_sum / r->mult_count : 0.0;
+	uint16_t mult_min = r->mult_count ? r->mult_min : 0;
+
+	if (csv_output) {
+		printf("%s,%u,%u,%lu,%lu,%ld,%ld,%.1f,%u,%.1f,%u\n", r->name, r->rpm, r->bounce_us,
+			   (unsigned long)r->true_ticks, (unsigned long)r->detected_ticks, (long)r->true_net,
+			   (long)r->detected_net, missed, mult_min, avg, r->mult_max);
+	} else {
+		printf("%-8s %5u %6u %6lu %6lu %6ld %6ld %6.1f%% %5u %7.1f %5u\n", r->name, r->rpm, r->bounce_us,
+			   (unsigned long)r->true_ticks, (unsigned long)r->detected_ticks, (long)r->true_net,
+			   (long)r->detected_net, missed, mult_min, avg, r->mult_max);
+	}
+}
+
+static const uint16_t sweep_rpm[] = {5, 15, 30, 60, 120, 240, 480, 720, 960, 1200, 1600};
+
+/**
+ * Two full turns clockwise at each speed.
+ */
+static void scenario_sweep(const char *name, uint16_t bounce)
+{
+	for (uint8_t i = 0; i < sizeof(sweep_rpm) / sizeof(sweep_rpm[0]); ++i) {
+		sim_result_t result = {.name = name, .rpm = sweep_rpm[i], .bounce_us = bounce};
+		sim_reset();
+		bounce_us = bounce;
+		queue_edges(SIM_LEAD_IN_US, sweep_rpm[i], 2 * SIM_EDGES_PER_REV, 1);
+		sim_run(&result);
+		print_result(&result);
+	}
+}
+
+/**
+ * Rocks back and forth one detent (4 edges) at a time, 24 times, with no
+ * pause at the turning point.
+ */
+static void scenario_reverse(uint16_t bounce)
+{
+	static const uint16_t reverse_rpm[] = {30, 60, 120, 240, 480, 960};
+
+	for (uint8_t i = 0; i < sizeof(reverse_rpm) / sizeof(reverse_rpm[0]); ++i) {
+		sim_result_t result = {.name = "reverse", .rpm = reverse_rpm[i], .bounce_us = bounce};
+		sim_reset();
+		bounce_us = bounce;
+		double t = SIM_LEAD_IN_US;
+		for (uint8_t leg = 0; leg < 24; ++leg) {
+			t = queue_edges(t, reverse_rpm[i], 4, (leg & 0x01) ? -1 : 1);
+		}
+		sim_run(&result);
+		print_result(&result);
+	}
+}
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "usage: %s [-s sweep|bounce|reverse|all] [-b bounce_us] [-l loop_us] [-r seed] [-c]\n", prog);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *scenario = "all";
+	uint16_t bounce = 300;
+
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "-c")) {
+			csv_output = true;
+		} else if (i + 1 < argc && !strcmp(argv[i], "-s")) {
+			scenario = argv[++i];
+		} else if (i + 1 < argc && !strcmp(argv[i], "-b")) {
+			bounce = (uint16_t)atoi(argv[++i]);
+		} else if (i + 1 < argc && !strcmp(argv[i], "-l")) {
+			loop_us = atof(argv[++i]);
+		} else if (i + 1 < argc && !strcmp(argv[i], "-r")) {
+			rng_state = (uint32_t)strtoul(argv[++i], NULL, 0);
+			if (!rng_state) rng_state = 1;
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (!csv_output) {
+		printf("scan %.3fms moving / %.3fms idle, direction lock %u scan units, main loop %.3fms\n",
+			   INPUT_SCAN_RATE_FAST * SIM_TICK_US / 1000.0, INPUT_SCAN_RATE_IDLE * SIM_TICK_US / 1000.0,
+			   ENCODER_DEBOUNCE_CYCLE_TIMEOUT, loop_us / 1000.0);
+	}
+	print_header();
+
+	bool all = !strcmp(scenario, "all");
+	if (all || !strcmp(scenario, "sweep")) {
+		scenario_sweep("sweep", 0);
+	}
+	if (all || !strcmp(scenario, "bounce")) {
+		scenario_sweep("bounce", bounce);
+	}
+	if (all || !strcmp(scenario, "reverse")) {
+		scenario_reverse(0);
+		scenario_reverse(bounce);
+	}
+	return 0;
+}
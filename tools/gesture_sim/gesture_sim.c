@@ -0,0 +1,181 @@
+/*
+ * gesture_sim.c
+ *
+ * Host side test of the switch gesture recognizer. Plays scripted presses,
+ * releases and turns through src/gesture.c one main loop pass (1ms) at a
+ * time, the way the encoder and side switch code calls it, and checks the
+ * gestures reported against the ones expected for the switch action.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -O2 -fcommon -Itools/display_sim -Isrc -o gesture_sim tools/gesture_sim/gesture_sim.c
+ *   ./gesture_sim [-v]
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Compile the firmware's gesture recognizer straight into the test so the
+// code under test is exactly the one that ships.
+#include "../../src/gesture.c"
+
+#include <stdio.h>
+
+/*	Macros: */
+	#define SIM_SWITCH			3		// Gesture slot under test
+	#define SIM_MAX_GESTURES	8
+	#define SIM_TAIL_MS			2000	// Passes run after the last step
+
+/*	Types: */
+	typedef enum {
+		STEP_DOWN,
+		STEP_UP,
+		STEP_TURN,
+		STEP_END,
+	} sim_step_type_t;
+
+	typedef struct {
+		uint32_t		time_ms;
+		sim_step_type_t	type;
+	} sim_step_t;
+
+	typedef struct {
+		const char		*name;
+		gesture_t		wanted;		// Gesture the switch action uses
+		sim_step_t		steps[8];
+		gesture_t		expected[SIM_MAX_GESTURES];	// Ends with GESTURE_NONE
+	} sim_case_t;
+
+/*	Variables */
+	static uint32_t sim_ms;
+	static bool verbose;
+
+	static const char *gesture_names[] = {
+		"none", "tap", "long-press", "double-tap", "press-turn", "release"
+	};
+
+	// The default gesture times are 500ms for a long-press and 300ms between
+	// a tap and a double-tap
+	static const sim_case_t sim_cases[] = {
+		{"tap", GESTURE_LONG_PRESS,
+			{{100, STEP_DOWN}, {200, STEP_UP}, {0, STEP_END}},
+			{GESTURE_TAP}},
+		{"long press", GESTURE_LONG_PRESS,
+			{{100, STEP_DOWN}, {800, STEP_UP}, {0, STEP_END}},
+			{GESTURE_LONG_PRESS, GESTURE_RELEASE}},
+		{"tap then hold", GESTURE_LONG_PRESS,
+			{{100, STEP_DOWN}, {200, STEP_UP}, {350, STEP_DOWN}, {1100, STEP_UP}, {0, STEP_END}},
+			{GESTURE_TAP, GESTURE_LONG_PRESS, GESTURE_RELEASE}},
+		{"two taps", GESTURE_LONG_PRESS,
+			{{100, STEP_DOWN}, {200, STEP_UP}, {350, STEP_DOWN}, {450, STEP_UP}, {0, STEP_END}},
+			{GESTURE_TAP, GESTURE_TAP}},
+		{"double tap", GESTURE_DOUBLE_TAP,
+			{{100, STEP_DOWN}, {200, STEP_UP}, {350, STEP_DOWN}, {450, STEP_UP}, {0, STEP_END}},
+			{GESTURE_TAP, GESTURE_DOUBLE_TAP, GESTURE_RELEASE}},
+		{"double tap held", GESTURE_DOUBLE_TAP,
+			{{100, STEP_DOWN}, {200, STEP_UP}, {350, STEP_DOWN}, {1100, STEP_UP}, {0, STEP_END}},
+			{GESTURE_TAP, GESTURE_DOUBLE_TAP, GESTURE_RELEASE}},
+		{"taps too far apart", GESTURE_DOUBLE_TAP,
+			{{100, STEP_DOWN}, {200, STEP_UP}, {600, STEP_DOWN}, {700, STEP_UP}, {0, STEP_END}},
+			{GESTURE_TAP, GESTURE_TAP}},
+		{"press and turn", GESTURE_NONE,
+			{{100, STEP_DOWN}, {150, STEP_TURN}, {900, STEP_UP}, {0, STEP_END}},
+			{GESTURE_PRESS_TURN, GESTURE_RELEASE}},
+		{"tap then press and turn", GESTURE_NONE,
+			{{100, STEP_DOWN}, {200, STEP_UP}, {300, STEP_DOWN}, {350, STEP_TURN}, {600, STEP_UP}, {0, STEP_END}},
+			{GESTURE_TAP, GESTURE_PRESS_TURN, GESTURE_RELEASE}},
+	};
+
+uint32_t get_ms_timer(void)
+{
+	return sim_ms;
+}
+
+/**
+ * Runs one case a millisecond at a time. Each pass reports a press or a
+ * release on the pass it happens and a held switch on every other pass, as
+ * the debounced switch state does.
+ *
+ * \return true if the gestures matched the expected ones
+ */
+static bool run_case(const sim_case_t *c)
+{
+	gesture_t got[SIM_MAX_GESTURES];
+	uint8_t count = 0;
+	const sim_step_t *step = c->steps;
+	bool pressed = false;
+
+	gesture_init();
+	for (sim_ms = 1; step->type != STEP_END || sim_ms < c->steps[0].time_ms + SIM_TAIL_MS; ++sim_ms) {
+		bool event_due = false;
+		switch_event_t event = SW_HELD;
+
+		while (step->type != STEP_END && step->time_ms == sim_ms) {
+			if (step->type == STEP_TURN) {
+				gesture_encoder_turned(SIM_SWITCH);
+			} else {
+				pressed = step->type == STEP_DOWN;
+				event = pressed ? SW_DOWN : SW_UP;
+				event_due = true;
+			}
+			++step;
+		}
+		if (pressed || event_due) {
+			gesture_t gesture = gesture_process(SIM_SWITCH, event, DEF_GESTURE_LONG_PRESS_TIME,
+												DEF_GESTURE_DOUBLE_TAP_TIME, c->wanted);
+			if (gesture != GESTURE_NONE) {
+				if (verbose) {
+					printf("  %5u ms  %s\n", sim_ms, gesture_names[gesture]);
+				}
+				if (count < SIM_MAX_GESTURES) {
+					got[count] = gesture;
+				}
+				++count;
+			}
+		}
+		gesture_task();
+	}
+
+	bool pass = count < SIM_MAX_GESTURES;
+	for (uint8_t i = 0; pass && i <= count; ++i) {
+		gesture_t expected = c->expected[i];
+		pass = (i == count) ? expected == GESTURE_NONE : got[i] == expected;
+	}
+	printf("%s %-24s wanted %-10s got", pass ? "PASS" : "FAIL", c->name, gesture_names[c->wanted]);
+	for (uint8_t i = 0; i < count && i < SIM_MAX_GESTURES; ++i) {
+		printf(" %s", gesture_names[got[i]]);
+	}
+	printf("\n");
+	return pass;
+}
+
+int main(int argc, char *argv[])
+{
+	for (int i = 1; i < argc; ++i) {
+		if (!strcmp(argv[i], "-v")) {
+			verbose = true;
+		} else {
+			fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	uint8_t failed = 0;
+	for (uint8_t i = 0; i < sizeof(sim_cases) / sizeof(sim_cases[0]); ++i) {
+		if (!run_case(&sim_cases[i])) {
+			++failed;
+		}
+	}
+	return failed != 0;
+}
@@ -0,0 +1,17 @@
+/*
+ * pgmspace.h
+ *
+ * Host stand-in for avr-libc's program memory access, flash is just memory on a PC.
+ */
+
+
+#ifndef ENCODER_TOOLS_PGMSPACE_H_
+#define ENCODER_TOOLS_PGMSPACE_H_
+
+	#include <stdint.h>
+
+	#define PROGMEM
+	#define pgm_read_byte(addr)		(*(const uint8_t *)(addr))
+	#define pgm_read_word(addr)		(*(const uint16_t *)(addr))
+
+#endif /* ENCODER_TOOLS_PGMSPACE_H_ */
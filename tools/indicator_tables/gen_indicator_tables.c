@@ -0,0 +1,302 @@
+/*
+ * gen_indicator_tables.c
+ *
+ * Generates src/indicator_tables.c from the original floating point indicator
+ * pattern code, and verifies that the table driven build_indicator_pattern()
+ * gives identical results for every display type, detent setting and position.
+ *
+ * Regenerate the tables from the repository root:
+ *   gcc -std=gnu99 -Itools/indicator_tables -Isrc -o gen_indicator_tables tools/indicator_tables/gen_indicator_tables.c -lm
+ *   ./gen_indicator_tables > src/indicator_tables.c
+ *
+ * Verify the firmware against the original code:
+ *   gcc -std=gnu99 -DINDICATOR_VERIFY -Itools/indicator_tables -Isrc -o verify_indicator_tables tools/indicator_tables/gen_indicator_tables.c src/indicator_pattern.c src/indicator_tables.c -lm
+ *   ./verify_indicator_tables
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing 
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source 
+ * code for personal use. Person may not publish, distribute, sublicense, or sell 
+ * the source code (modified or un-modified). Person may not use this source code 
+ * or any diminutive works for commercial purposes. The permission to use this source 
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A 
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT 
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION 
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */ 
+
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <indicator_pattern.h>
+
+// Display types as used by the original code
+#define DOT			INDICATOR_TYPE_DOT
+#define BAR			INDICATOR_TYPE_BAR
+#define BLENDED_BAR	INDICATOR_TYPE_BLENDED_BAR
+#define SPREAD_BAR	INDICATOR_TYPE_SPREAD_BAR
+
+/**
+ * The original build_indicator_pattern() from display_driver.c, kept as the
+ * reference the tables are generated from. Host floats are IEEE single 
+ * precision, the same as avr-gcc's.
+ */
+static int reference_build_indicator_pattern(indicator_bit_mask_t *result, 
+							uint8_t position, 
+							uint16_t type, 
+							bool has_detent, 
+							uint8_t detent_color)
+	{
+	int8_t		dot_count;
+	uint32_t	bit_mask;
+	int8_t		frac;
+	bool		is_blended = false;
+	bool        is_bar_display     = false;
+	bool		is_spread = false;
+
+	float       remainder = 0;
+	
+	if (type == BLENDED_BAR){// || type == BLENDED_DOT) {
+		is_blended = true;
+	}
+	if (type ==  BAR || type == BLENDED_BAR) {
+		is_bar_display = true;
+	}
+	
+	if (type == SPREAD_BAR) {
+		is_blended = true;
+		is_spread = true;
+	}
+	
+	if (is_spread) {
+		if (position <= 0) {
+			result->pattern_A = 0;
+			result->pattern_A_brightness = 0;
+			result->pattern_B = 0;
+			result->pattern_B_brightness = 0;
+			return 1;
+		}
+		bit_mask = 0x0400;
+		float spread_f = ((position - 1) * 5.0f) / 126.0f;
+		uint8_t spread = (uint8_t)spread_f;
+		float frac_f = spread_f - spread;
+		uint8_t blend = (uint8_t)(frac_f * 127);
+
+		for (int8_t i = 0; i < spread; i++) {
+			bit_mask |= (bit_mask >> 1) | (bit_mask << 1);
+		}
+
+		if (blend > 0 && spread < 5) {
+			uint32_t edge_mask = (bit_mask | (bit_mask >> 1) | (bit_mask << 1)) & ~bit_mask;
+			result->pattern_A = (uint16_t)(bit_mask | edge_mask);
+			result->pattern_A_brightness = blend;
+			result->pattern_B = (uint16_t)(bit_mask);
+			result->pattern_B_brightness = 127 - blend;
+			} else {
+			result->pattern_A = 0;
+			result->pattern_A_brightness = 0;
+			result->pattern_B = (uint16_t)(bit_mask);
+			result->pattern_B_brightness = 127;
+		}
+		return 1;
+	}
+	if (has_detent) {	
+		// 
+		if (position == 63 || position == 64 ) {
+			// The encoder is in its detent position, set the detent indicator
+			// to its color and return.
+			result->pattern_A = 0x0001;  // detent color 1 flag 
+			result->pattern_B = 0x0002;  // detent color 2 flag
+			result->pattern_A_brightness = (uint8_t)(detent_color);
+			result->pattern_B_brightness = (uint8_t)(0x7F - (detent_color));
+			return 1;
+		} else {
+			bit_mask = 0x0400;
+			if(is_blended) {
+				dot_count = (int8_t)((position - 63) / 12.7f);
+				remainder = fmodf(position - 63, 12.7f);        
+				frac =  (uint8_t)fabs((remainder * 10));
+			} else {
+				uint8_t center_point = (position > 63) ? 63 : 64;
+				dot_count = (int8_t)((position - center_point) / 15.9f);
+				remainder = fmodf(position - center_point, 15.9f);        
+				frac =  (uint8_t)fabs((remainder * 8));
+				//Not blended detent display does not use 12 o clock white LED
+				if (remainder < 0){
+					dot_count -= 1;
+				} else {
+					dot_count +=1;
+				}
+			}	
+		} 
+	} else {
+		if (is_blended) {
+			dot_count = (int8_t)(position / 11.5f);	
+			remainder = fmodf(position, 11.5f);         
+			frac =  (uint8_t)(remainder * 11);
+			bit_mask = 0x10000;
+		}
+		else {
+			dot_count = (int8_t)(position / 11.65f);
+			bit_mask = 0x8000;
+			frac = 0;
+		}
+		
+		if (position == 0) {
+			bit_mask = 0;
+		}
+		
+	}
+	
+	if (is_bar_display) {
+	// Build a bar bit mask	
+		int8_t count = dot_count;
+		if (dot_count >= 0) {
+			while (count) {
+				bit_mask |= bit_mask >> 1;
+				count--;
+			}
+		} else if (dot_count < 0) {
+			while (count) {
+				bit_mask |= bit_mask << 1;
+				count++;
+			}
+		}
+	} else {
+	// Build a dot bit mask	
+		if (dot_count >= 0) {
+			bit_mask = bit_mask >> dot_count;
+		} else if (dot_count < 0) {
+			bit_mask = bit_mask << dot_count*-1;
+		}
+	}
+	
+	// Store the bit masks and set their respective brightness levels
+	result->pattern_B = (uint16_t)(bit_mask);
+	
+	if ((remainder > 0) && is_blended) {
+		result->pattern_A = (uint16_t)(bit_mask | (bit_mask >> 1));
+		result->pattern_A_brightness = frac;
+		result->pattern_B_brightness = 127 - frac;
+			
+	} else if ((remainder < 0) && is_blended) {
+		result->pattern_A = (uint16_t)(bit_mask | (bit_mask << 1));
+		result->pattern_A_brightness = frac;
+		result->pattern_B_brightness = 127 - frac;
+	}
+	else
+	{
+		result->pattern_A = 0;
+		result->pattern_A_brightness = 0;
+	}
+	result->pattern_B_brightness = 127;
+	return 1;	
+}
+
+#ifndef INDICATOR_VERIFY
+
+static const char *table_names[INDICATOR_TABLES] = {
+	"Dot", "Bar", "Blended Bar", "Spread Bar",
+	"Dot with detent", "Bar with detent", "Blended Bar with detent",
+};
+
+int main(void)
+{
+	printf("/*\n");
+	printf(" * indicator_tables.c\n");
+	printf(" *\n");
+	printf(" * Generated by tools/indicator_tables/gen_indicator_tables.c, do not edit.\n");
+	printf(" *\n");
+	printf(" * Indicator patterns for each display type and position, {pattern A,\n");
+	printf(" * pattern B, pattern A brightness}. The detent position itself and the\n");
+	printf(" * empty spread bar are handled in build_indicator_pattern().\n");
+	printf(" *\n");
+	printf(" * DJTT - Midi Fighter Twister - Embedded Software License\n");
+	printf(" * Copyright (c) 2026: DJ TechTools\n");
+	printf(" * Permission is hereby granted, free of charge, to any person owning or possessing \n");
+	printf(" * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source \n");
+	printf(" * code for personal use. Person may not publish, distribute, sublicense, or sell \n");
+	printf(" * the source code (modified or un-modified). Person may not use this source code \n");
+	printf(" * or any diminutive works for commercial purposes. The permission to use this source \n");
+	printf(" * code is also subject to the following conditions:\n");
+	printf(" * THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, \n");
+	printf(" * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A \n");
+	printf(" * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT \n");
+	printf(" * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION \n");
+	printf(" * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE \n");
+	printf(" * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.\n");
+	printf(" */\n\n");
+	printf("#include <indicator_pattern.h>\n\n");
+	printf("const indicator_table_entry_t indicator_table[INDICATOR_TABLES][INDICATOR_POSITIONS] PROGMEM = {\n");
+	
+	for (uint8_t table = 0; table < INDICATOR_TABLES; ++table) {
+		uint8_t type = table % INDICATOR_TYPES;
+		bool has_detent = table >= INDICATOR_TYPES;
+		
+		printf("\t{ // %s\n", table_names[table]);
+		for (uint8_t position = 0; position < INDICATOR_POSITIONS; ++position) {
+			indicator_bit_mask_t result;
+			memset(&result, 0, sizeof(result));
+			
+			if (!(has_detent && (position == 63 || position == 64))) {
+				reference_build_indicator_pattern(&result, position, type, has_detent, 0);
+			}
+			printf("%s{0x%04X, 0x%04X, %3u},", (position % 4) ? " " : "\t\t",
+				   result.pattern_A, result.pattern_B, result.pattern_A_brightness);
+			if (position % 4 == 3) {
+				printf("\n");
+			}
+		}
+		printf("\t},\n");
+	}
+	printf("};\n");
+	return 0;
+}
+
+#else
+
+int main(void)
+{
+	static const uint8_t detent_colors[] = {0, 1, 63, 64, 126, 127};
+	uint32_t checked = 0;
+	uint32_t failed = 0;
+	
+	for (uint8_t type = 0; type < INDICATOR_TYPES; ++type) {
+		for (uint8_t has_detent = 0; has_detent < 2; ++has_detent) {
+			for (uint8_t c = 0; c < sizeof(detent_colors); ++c) {
+				for (uint8_t position = 0; position < INDICATOR_POSITIONS; ++position) {
+					indicator_bit_mask_t expected, actual;
+					memset(&expected, 0, sizeof(expected));
+					memset(&actual, 0, sizeof(actual));
+					
+					reference_build_indicator_pattern(&expected, position, type, has_detent, detent_colors[c]);
+					build_indicator_pattern(&actual, position, type, has_detent, detent_colors[c]);
+					
+					checked++;
+					if (expected.pattern_A != actual.pattern_A || expected.pattern_B != actual.pattern_B ||
+						expected.pattern_A_brightness != actual.pattern_A_brightness ||
+						expected.pattern_B_brightness != actual.pattern_B_brightness) {
+						failed++;
+						printf("MISMATCH type %u detent %u color %u position %u: "
+							   "expected {0x%04X %3u 0x%04X %3u} got {0x%04X %3u 0x%04X %3u}\n",
+							   type, has_detent, detent_colors[c], position,
+							   expected.pattern_A, expected.pattern_A_brightness, 
+							   expected.pattern_B, expected.pattern_B_brightness,
+							   actual.pattern_A, actual.pattern_A_brightness, 
+							   actual.pattern_B, actual.pattern_B_brightness);
+					}
+				}
+			}
+		}
+	}
+	printf("%lu patterns checked, %lu mismatches\n", (unsigned long)checked, (unsigned long)failed);
+	return failed ? 1 : 0;
+}
+
+#endif
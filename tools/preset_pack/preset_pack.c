@@ -0,0 +1,290 @@
+/*
+ * preset_pack.c
+ *
+ * Packs saved settings into the preset slots src/preset.c recalls. Each input
+ * is an EEPROM image read back from a unit, raw binary or Intel HEX (such as
+ * an avrdude .eep file), and is given with the slot it goes in. The settings
+ * pages are copied out of it, the preset header is added and the slots are
+ * written as an Intel HEX file at their flash addresses, to be programmed
+ * along with the firmware.
+ *
+ * Build and run from the repository root:
+ *   gcc -std=gnu99 -Itools/display_sim -Isrc -o preset_pack tools/preset_pack/preset_pack.c
+ *   ./preset_pack [-o presets.hex] slot:image [slot:image ...]
+ *
+ * DJTT - Midi Fighter Twister - Embedded Software License
+ * Copyright (c) 2026: DJ TechTools
+ * Permission is hereby granted, free of charge, to any person owning or possessing
+ * a DJ TechTools Midi Fighter Twister Hardware Device to view and modify this source
+ * code for personal use. Person may not publish, distribute, sublicense, or sell
+ * the source code (modified or un-modified). Person may not use this source code
+ * or any diminutive works for commercial purposes. The permission to use this source
+ * code is also subject to the following conditions:
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,  FITNESS FOR A
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <util/crc16.h>
+
+#include "preset.h"
+
+	#define PACK_RECORD_BYTES	16			// Data bytes per Intel HEX record
+	#define PACK_EEPROM_VMA		0x810000	// Where avr-gcc places the .eeprom section
+
+	// Intel HEX record types
+	#define HEX_DATA			0x00
+	#define HEX_END				0x01
+	#define HEX_SEGMENT			0x02
+	#define HEX_LINEAR			0x04
+
+/* Input -------------------------------------------------------------------- */
+
+static int pack_hex_byte(const char *text)
+{
+	unsigned value;
+	if (sscanf(text, "%2x", &value) != 1) {
+		return -1;
+	}
+	return (int)value;
+}
+
+/**
+ * Reads an Intel HEX EEPROM image. Addresses are taken from 0, or from the
+ * .eeprom section address avr-gcc gives them.
+ */
+static bool pack_read_hex(FILE *file, const char *path, uint8_t *image)
+{
+	char line[600];
+	uint32_t base = 0;
+	unsigned line_number = 0;
+
+	while (fgets(line, sizeof(line), file)) {
+		line_number++;
+		if (line[0] != ':') {
+			continue;
+		}
+
+		int fields[4];
+		for (uint8_t i = 0; i < 4; ++i) {
+			fields[i] = pack_hex_byte(&line[1 + (i * 2)]);
+		}
+		int count = fields[0];
+		uint16_t address = (uint16_t)((fields[1] << 8) | fields[2]);
+		int type = fields[3];
+
+		uint8_t data[256];
+		uint8_t sum = count + fields[1] + fields[2] + type;
+		bool ok = count >= 0 && fields[1] >= 0 && fields[2] >= 0 && type >= 0;
+		for (int i = 0; ok && i <= count; ++i) {
+			int value = pack_hex_byte(&line[9 + (i * 2)]);
+			ok = value >= 0;
+			if (i < count) {
+				data[i] = (uint8_t)value;
+			}
+			sum += (uint8_t)value;
+		}
+		if (!ok || sum) {
+			fprintf(stderr, "%s:%u: bad record\n", path, line_number);
+			return false;
+		}
+
+		switch (type) {
+			case HEX_DATA:
+			for (int i = 0; i < count; ++i) {
+				uint32_t location = base + address + i;
+				if (location >= PACK_EEPROM_VMA) {
+					location -= PACK_EEPROM_VMA;
+				}
+				if (location >= EEPROM_SIZE) {
+					fprintf(stderr, "%s:%u: 0x%X is outside the EEPROM\n", path, line_number, (unsigned)location);
+					return false;
+				}
+				image[location] = data[i];
+			}
+			break;
+			case HEX_END:
+			return true;
+			case HEX_SEGMENT:
+			base = (uint32_t)((data[0] << 8) | data[1]) << 4;
+			break;
+			case HEX_LINEAR:
+			base = (uint32_t)((data[0] << 8) | data[1]) << 16;
+			break;
+		}
+	}
+	return true;
+}
+
+/**
+ * Reads an EEPROM image, Intel HEX if it starts with a record and otherwise
+ * raw binary from address 0. Bytes the image doesn't cover read as erased.
+ */
+static bool pack_read_image(const char *path, uint8_t *image)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file) {
+		perror(path);
+		return false;
+	}
+
+	memset(image, 0xFF, EEPROM_SIZE);
+	int first = fgetc(file);
+	rewind(file);
+
+	bool ok;
+	if (first == ':') {
+		ok = pack_read_hex(file, path, image);
+	} else {
+		size_t length = fread(image, 1, EEPROM_SIZE, file);
+		ok = length >= (CONFIG_STORE_START_PAGE * EEPROM_PAGE_SIZE) + PRESET_IMAGE_SIZE;
+		if (!ok) {
+			fprintf(stderr, "%s: %zu bytes is too short to hold the settings\n", path, length);
+		}
+	}
+	fclose(file);
+	return ok;
+}
+
+/* Output ------------------------------------------------------------------- */
+
+static void pack_hex_record(FILE *out, uint8_t type, uint16_t address, const uint8_t *data, uint8_t length)
+{
+	uint8_t sum = length + (address >> 8) + (address & 0xFF) + type;
+
+	fprintf(out, ":%02X%04X%02X", length, address, type);
+	for (uint8_t i = 0; i < length; ++i) {
+		fprintf(out, "%02X", data[i]);
+		sum += data[i];
+	}
+	fprintf(out, "%02X\n", (uint8_t)-sum);
+}
+
+// Writes a block of flash, starting a new linear address record when needed
+static void pack_hex_block(FILE *out, uint32_t address, const uint8_t *data, uint16_t length, uint32_t *base)
+{
+	for (uint16_t offset = 0; offset < length; offset += PACK_RECORD_BYTES) {
+		uint32_t location = address + offset;
+		if ((location >> 16) != *base) {
+			*base = location >> 16;
+			uint8_t upper[2] = {(uint8_t)(*base >> 8), (uint8_t)*base};
+			pack_hex_record(out, HEX_LINEAR, 0, upper, 2);
+		}
+
+		uint8_t chunk = (length - offset < PACK_RECORD_BYTES) ? length - offset : PACK_RECORD_BYTES;
+		pack_hex_record(out, HEX_DATA, location & 0xFFFF, &data[offset], chunk);
+	}
+}
+
+/**
+ * Builds a slot from an EEPROM image: the settings pages as they are in the
+ * EEPROM, followed by the header preset_is_stored() checks.
+ */
+static uint16_t pack_slot(const uint8_t *image, uint8_t *slot)
+{
+	uint16_t crc = 0xFFFF;
+
+	memcpy(slot, &image[CONFIG_STORE_START_PAGE * EEPROM_PAGE_SIZE], PRESET_IMAGE_SIZE);
+	for (uint16_t i = 0; i < PRESET_IMAGE_SIZE; ++i) {
+		crc = _crc_ccitt_update(crc, slot[i]);
+	}
+
+	uint8_t *header = &slot[PRESET_IMAGE_SIZE];
+	header[PRESET_HEADER_MAGIC] = PRESET_MAGIC;
+	header[PRESET_HEADER_LAYOUT] = EEPROM_LAYOUT;
+	header[PRESET_HEADER_CRC] = crc & 0xFF;
+	header[PRESET_HEADER_CRC + 1] = crc >> 8;
+	return crc;
+}
+
+/* Main --------------------------------------------------------------------- */
+
+static void pack_usage(const char *name)
+{
+	fprintf(stderr, "usage: %s [-o presets.hex] slot:image [slot:image ...]\n", name);
+	fprintf(stderr, "  slot is 0-%u, image is an EEPROM image in raw binary or Intel HEX\n", PRESET_SLOTS - 1);
+}
+
+int main(int argc, char **argv)
+{
+	const char *out_path = NULL;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "o:")) != -1) {
+		switch (opt) {
+			case 'o':
+			out_path = optarg;
+			break;
+			default:
+			pack_usage(argv[0]);
+			return 2;
+		}
+	}
+	if (optind >= argc) {
+		pack_usage(argv[0]);
+		return 2;
+	}
+
+	FILE *out = out_path ? fopen(out_path, "w") : stdout;
+	if (!out) {
+		perror(out_path);
+		return 1;
+	}
+
+	static uint8_t image[EEPROM_SIZE];
+	uint8_t slot_data[PRESET_IMAGE_SIZE + PRESET_HEADER_SIZE];
+	uint8_t packed = 0;
+	uint32_t base = 0;
+	int status = 0;
+
+	for (int i = optind; i < argc; ++i) {
+		char *end;
+		unsigned long slot = strtoul(argv[i], &end, 10);
+		if (end == argv[i] || *end != ':' || slot >= PRESET_SLOTS) {
+			fprintf(stderr, "%s: expected slot:image with a slot of 0-%u\n", argv[i], PRESET_SLOTS - 1);
+			status = 2;
+			break;
+		}
+		if (packed & (1 << slot)) {
+			fprintf(stderr, "%s: slot %lu is given twice\n", argv[i], slot);
+			status = 2;
+			break;
+		}
+
+		const char *path = end + 1;
+		if (!pack_read_image(path, image)) {
+			status = 1;
+			break;
+		}
+		// The firmware only recalls settings in the layout it reads
+		if (image[EE_EEPROM_VERSION] != EEPROM_LAYOUT) {
+			fprintf(stderr, "%s: settings layout %u, the firmware reads layout %u\n", path,
+					image[EE_EEPROM_VERSION], EEPROM_LAYOUT);
+			status = 1;
+			break;
+		}
+
+		uint32_t address = PRESET_FLASH_START + (slot * PRESET_SLOT_SIZE);
+		uint16_t crc = pack_slot(image, slot_data);
+		pack_hex_block(out, address, slot_data, sizeof(slot_data), &base);
+		packed |= 1 << slot;
+		fprintf(stderr, "slot %lu: %s at 0x%05X, %u bytes, CRC 0x%04X\n", slot, path, (unsigned)address,
+				(unsigned)sizeof(slot_data), crc);
+	}
+
+	pack_hex_record(out, HEX_END, 0, NULL, 0);
+	if (out != stdout) {
+		fclose(out);
+		if (status) {
+			remove(out_path);
+		}
+	}
+	return status;
+}